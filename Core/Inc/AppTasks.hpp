@@ -6,7 +6,8 @@
 #include "drivers/Display.hpp"
 #include "drivers/Uart.hpp"
 #include "drivers/Buzzer.hpp"
-#include "drivers/Synthesizer.hpp"
+#include "synthesizer/SynthesizerBridge.hpp"
+#include "PianoController.hpp"
 #include "UartControl.hpp"
 
 // Forward declarations
@@ -72,7 +73,7 @@ public:
     void update() override;
     
 private:
-    Synthesizer& synthesizer;
+    SynthesizerBridge& synthesizer;
     void updateSynthesizer();
 };
 
@@ -0,0 +1,54 @@
+#ifndef PIANOCONTROLLER_HPP
+#define PIANOCONTROLLER_HPP
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Класс для управления клавиатурой как пианино. Ноты уходят в движок,
+// выбранный SYNTH_ENGINE (SynthesizerBridge)
+class PianoController {
+public:
+    static PianoController& getInstance();
+    
+    // Инициализация
+    bool init();
+    
+    // Обработка нажатий клавиш
+    void onKeyPress(uint8_t keyCode);
+    void onKeyRelease(uint8_t keyCode);
+    
+    // Настройки
+    void setOctave(int8_t octave);  // -2 до +2
+    void setChannel(uint8_t channel);
+    void setInstrument(uint8_t instrument);  // 0-127
+    
+    // Состояние
+    int8_t getOctave() const { return currentOctave; }
+    uint8_t getChannel() const { return currentChannel; }
+    uint8_t getInstrument() const { return currentInstrument; }
+
+private:
+    PianoController() = default;
+    ~PianoController() = default;
+    PianoController(const PianoController&) = delete;
+    PianoController& operator=(const PianoController&) = delete;
+    
+    // Маппинг клавиш на ноты
+    static constexpr uint8_t KEYBOARD_KEYS = 16;
+    static constexpr uint8_t INVALID_NOTE = 255;
+    
+    // Маппинг клавиш клавиатуры на ноты (0-15 -> C, C#, D, D#, E, F, F#, G, G#, A, A#, B, C, C#, D, D#)
+    uint8_t keyToNote[KEYBOARD_KEYS];
+    
+    // Состояние
+    int8_t currentOctave;      // -2 до +2
+    uint8_t currentChannel;   // 0-15
+    uint8_t currentInstrument; // 0-127
+    bool keyStates[KEYBOARD_KEYS];  // Состояние каждой клавиши
+    
+    // Внутренние методы
+    uint8_t getMidiNote(uint8_t keyCode) const;
+    void updateKeyMapping();
+};
+
+#endif // PIANOCONTROLLER_HPP
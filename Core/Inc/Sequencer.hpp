@@ -4,7 +4,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <vector>
-#include "drivers/Synthesizer.hpp"
+#include "synthesizer/SynthEngine.hpp"
 
 // Типы дорожек
 enum class TrackType {
@@ -113,6 +113,15 @@ struct Project {
     }
 };
 
+// Куда секвенсор отправляет ноты. По умолчанию - движок SYNTH_ENGINE, офлайн-рендер
+// на ПК подставляет свои функции (ноты -> события по виртуальным часам)
+struct SequencerOutput {
+    void (*noteOn)(uint8_t channel, uint8_t note, uint8_t velocity);
+    void (*noteOff)(uint8_t channel, uint8_t note);
+    void (*playDrum)(DrumPreset preset, uint8_t velocity);
+    void (*allNotesOff)();
+};
+
 // Основной класс секвенсора
 class Sequencer {
 public:
@@ -134,6 +143,7 @@ public:
     // Настройки
     void setBPM(uint16_t bpm);
     void setVolume(uint8_t volume);
+    void setOutput(const SequencerOutput& value) { output = value; }
     uint16_t getBPM() const { return project.bpm; }
     uint8_t getVolume() const { return project.volume; }
     
@@ -152,13 +162,15 @@ public:
     static constexpr uint8_t MAX_VOLUME = 10;
     
 private:
-    Sequencer() = default;
+    Sequencer();
     ~Sequencer() = default;
     Sequencer(const Sequencer&) = delete;
     Sequencer& operator=(const Sequencer&) = delete;
     
     Project project;
     uint32_t lastUpdateTime;
+    uint32_t lastNoteOffTime;  // Последнее автоматическое отпускание ноты пианино
+    SequencerOutput output;
     
     // Внутренние методы
     void playBeat();
@@ -14,6 +14,9 @@ extern "C" {
 void uart_on_receive_isr(void);
 void uart_process_tx_buffer(void);
 
+// Buzzer wrapper functions
+void buzzer_on_timer_tick(void);
+
 #ifdef __cplusplus
 }
 #endif
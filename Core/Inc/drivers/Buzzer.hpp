@@ -53,6 +53,14 @@ private:
     uint32_t getNoteDuration(uint32_t duration) const;
 };
 
+// Зуммер на TIM1_CH1. Таймер запускается один раз в init(), высота и громкость
+// меняются записью PSC/ARR/CCR1 через теневые регистры: новые значения
+// вступают в силу вместе по событию обновления, без остановки таймера и щелчков.
+// Повторная установка тех же значений не трогает регистры.
+//
+// Полифония - арпеджио (как в чиптюне): тик TIM6 по кругу переключает вывод
+// между активными каналами, каждый звучит setArpeggioRate() раз в секунду со
+// своей скважностью (громкостью). При частоте 0 звучит канал с наибольшей частотой.
 class Buzzer {
 public:
     static Buzzer& getInstance();
@@ -62,6 +70,8 @@ public:
     
     // Управление каналами
     void playNote(uint8_t channel, uint16_t frequency, uint8_t volume = 10);
+    // MIDI нота: PSC/ARR из таблицы NoteTable, без деления
+    void playMidiNote(uint8_t channel, uint8_t note, uint8_t volume = 10);
     void stopNote(uint8_t channel);
     void stopAll();
     
@@ -69,6 +79,18 @@ public:
     void setVolume(uint8_t channel, uint8_t volume);
     void setGlobalVolume(uint8_t volume);
     
+    // Арпеджио: шагов (смен канала) в секунду, 0 - выключено
+    void setArpeggioRate(uint16_t stepsPerSecond);
+    uint16_t getArpeggioRate() const { return arpeggioRate; }
+    // Тик ARPEGGIO_TICK_HZ из прерывания TIM6
+    void onTimerTick();
+    
+    // TIM1 отдан другому выводу (OneBitMixer, SigmaDeltaPWM через DMA): каналы и
+    // мелодии ведутся как обычно, но PSC/ARR/CCR1 не пишутся ни задачей, ни тиком.
+    // init() забирает таймер обратно
+    void releaseTimer();
+    bool ownsTimer() const { return timerOwned; }
+    
     // Воспроизведение мелодий
     void playMelody(const Melody& melody);
     void stopMelody();
@@ -81,6 +103,8 @@ public:
     static constexpr uint8_t MAX_CHANNELS = 4;
     static constexpr uint8_t MAX_VOLUME = 10;
     static constexpr uint8_t MIN_VOLUME = 0;
+    static constexpr uint16_t ARPEGGIO_TICK_HZ = 1000;      // Частота прерываний TIM6
+    static constexpr uint16_t DEFAULT_ARPEGGIO_RATE = 50;   // 20 мс на ноту
     
     // Частоты нот (из buzzer.h)
     static constexpr uint16_t NOTE_C4 = 262;
@@ -137,29 +161,67 @@ public:
     static constexpr uint16_t NOTE_DS8 = 4978;
     
 private:
-    Buzzer() = default;
+    Buzzer() : globalVolume(MAX_VOLUME), applied(), appliedValid(false), arpeggioRate(0),
+               ticksPerStep(1), tickCount(0), currentSlot(0), pending(false),
+               timerOwned(false) {}
     ~Buzzer() = default;
     Buzzer(const Buzzer&) = delete;
     Buzzer& operator=(const Buzzer&) = delete;
     
-    // Структура канала
+    // Значения регистров TIM1
+    struct TimerSetting {
+        uint16_t prescaler;
+        uint16_t reload;
+        uint16_t compare;
+        
+        TimerSetting() : prescaler(0), reload(0), compare(0) {}
+        bool operator==(const TimerSetting& other) const {
+            return prescaler == other.prescaler && reload == other.reload && compare == other.compare;
+        }
+    };
+    
+    // Структура канала. Прерывание TIM6 читает только sounding и volume:
+    // PSC/ARR публикуются одним 32-битным словом, поэтому тик не увидит
+    // PSC новой ноты с ARR старой, пока задача меняет канал
     struct Channel {
-        uint16_t frequency;
-        uint8_t volume;
-        bool active;
+        uint16_t frequency;          // Только задача
+        uint32_t timing;             // Только задача: PSC/ARR для frequency, считается при ее смене
+        volatile uint32_t sounding;  // timing звучащего канала, 0 - канал молчит
+        volatile uint8_t volume;
         
-        Channel() : frequency(0), volume(0), active(false) {}
+        Channel() : frequency(0), timing(0), sounding(0), volume(0) {}
+        bool active() const { return sounding != 0; }
     };
     
+    // Слово PSC/ARR: PSC в старших 16 битах. ARR нот не бывает 0, поэтому
+    // слово звучащего канала не равно 0
+    static uint32_t packTiming(uint16_t prescaler, uint16_t reload) {
+        return ((uint32_t)prescaler << 16) | reload;
+    }
+    
     // Состояние каналов
     Channel channels[MAX_CHANNELS];
     uint8_t globalVolume;
     MelodyPlayer melodyPlayer;
+    TimerSetting applied;  // Последнее записанное в таймер
+    bool appliedValid;
+    
+    // Арпеджио. При включенном таймер пишет только прерывание: задача
+    // меняет каналы и ставит pending, применение - на ближайшем тике
+    uint16_t arpeggioRate;
+    uint16_t ticksPerStep;
+    uint16_t tickCount;
+    volatile uint8_t currentSlot;
+    volatile bool pending;
+    volatile bool timerOwned;  // false - TIM1 ведет другой вывод
     
     // Внутренние методы
     void updatePWM();
-    uint16_t calculatePWMValue(uint16_t frequency, uint8_t volume);
-    void mixChannels();
+    void applySetting(const TimerSetting& setting);
+    TimerSetting channelSetting(uint32_t timing, uint8_t volume) const;
+    TimerSetting channelSetting(const Channel* channel) const;
+    const Channel* nextArpeggioChannel(bool advance);
+    static void calculateTiming(uint16_t frequency, uint16_t& prescaler, uint16_t& reload);
 };
 
 #endif // BUZZER_HPP
@@ -4,6 +4,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "Buzzer.hpp"
+#include "synthesizer/SynthEngine.hpp"
+#include "synthesizer/VoiceManager.hpp"
 
 // Типы волн для синтезатора
 enum class WaveType {
@@ -28,6 +30,7 @@ struct ADSR {
 // Структура для голоса синтезатора
 struct Voice {
     uint16_t frequency;
+    uint8_t note;          // MIDI нота
     uint8_t velocity;      // Громкость (0-127)
     uint8_t channel;       // MIDI канал
     uint32_t startTime;    // Время начала ноты
@@ -36,10 +39,16 @@ struct Voice {
     bool released;
     ADSR adsr;
     
-    Voice() : frequency(0), velocity(0), channel(0), startTime(0), 
+    Voice() : frequency(0), note(0), velocity(0), channel(0), startTime(0), 
               releaseTime(0), active(false), released(false), adsr() {}
 };
 
+// Вывод голосов Synthesizer
+enum class SynthOutput {
+    BUZZER,     // Buzzer: до 4 голосов арпеджио, перенастройка таймера по смене ноты
+    ONE_BIT     // OneBitMixer: все голоса одновременно, 1-битный микшер через DMA
+};
+
 // Структура для барабанного звука
 struct DrumSound {
     uint16_t frequency;
@@ -51,20 +60,8 @@ struct DrumSound {
         : frequency(freq), duration(dur), volume(vol), isNoise(noise) {}
 };
 
-// Пресеты барабанов
-enum class DrumPreset {
-    KICK,       // Бас-барабан
-    SNARE,      // Малый барабан
-    HIHAT,      // Хай-хэт
-    CRASH,      // Крэш
-    RIDE,       // Райд
-    TOM_HIGH,   // Высокий том
-    TOM_MID,    // Средний том
-    TOM_LOW     // Низкий том
-};
-
 // Класс полифонического синтезатора
-class Synthesizer {
+class Synthesizer : public SynthEngine<Synthesizer> {
 public:
     static Synthesizer& getInstance();
     
@@ -95,6 +92,10 @@ public:
     void setReverb(uint8_t level);  // 0-10
     void setChorus(uint8_t level);  // 0-10
     
+    // Вывод: TIM1 занимает либо Buzzer, либо OneBitMixer
+    void setOutput(SynthOutput output);
+    SynthOutput getOutput() const { return output; }
+    
     // Обновление (вызывается из задачи)
     void update();
     
@@ -114,75 +115,39 @@ public:
     static constexpr uint8_t MIDI_C6 = 84;
     
 private:
-    Synthesizer() = default;
+    Synthesizer() : voiceManager(*this) {}
     ~Synthesizer() = default;
     Synthesizer(const Synthesizer&) = delete;
     Synthesizer& operator=(const Synthesizer&) = delete;
     
-    // Голоса синтезатора
-    Voice voices[MAX_VOICES];
+    // Голоса синтезатора: канал монофонический, вывод - Buzzer / OneBitMixer
+    typedef VoiceManager<Voice, MAX_VOICES, Synthesizer, MAX_CHANNELS> Voices;
+    friend Voices;
+    static constexpr bool MONO_CHANNELS = true;
+    Voices voiceManager;
     uint8_t masterVolume;
     uint8_t channelVolumes[MAX_CHANNELS];
     uint8_t reverbLevel;
     uint8_t chorusLevel;
+    SynthOutput output;
+    
+    // Часть голоса, которую ведет движок (VoiceManager)
+    void startVoice(Voice& voice);
+    void releaseVoice(Voice& voice);
+    void silenceVoice(Voice& voice) { (void)voice; }
+    float voiceLevel(const Voice& voice) const;
+    void configureVoice(Voice& voice) { (void)voice; }
     
     // Внутренние методы
-    uint8_t findFreeVoice() const;
-    uint8_t findVoice(uint8_t channel, uint8_t note) const;
-    uint16_t midiToFrequency(uint8_t note) const;
     uint8_t calculateVolume(const Voice& voice) const;
     void updateVoice(Voice& voice);
     void mixVoices();
+    void mixVoicesOneBit();
+    void stopOutput();
     void generateDrumSound(const DrumSound& sound);
     
     // Барабанные пресеты
     DrumSound getDrumPreset(DrumPreset preset) const;
 };
 
-// Класс для управления клавиатурой как пианино
-class PianoController {
-public:
-    static PianoController& getInstance();
-    
-    // Инициализация
-    bool init();
-    
-    // Обработка нажатий клавиш
-    void onKeyPress(uint8_t keyCode);
-    void onKeyRelease(uint8_t keyCode);
-    
-    // Настройки
-    void setOctave(int8_t octave);  // -2 до +2
-    void setChannel(uint8_t channel);
-    void setInstrument(uint8_t instrument);  // 0-127
-    
-    // Состояние
-    int8_t getOctave() const { return currentOctave; }
-    uint8_t getChannel() const { return currentChannel; }
-    uint8_t getInstrument() const { return currentInstrument; }
-    
-private:
-    PianoController() = default;
-    ~PianoController() = default;
-    PianoController(const PianoController&) = delete;
-    PianoController& operator=(const PianoController&) = delete;
-    
-    // Маппинг клавиш на ноты
-    static constexpr uint8_t KEYBOARD_KEYS = 16;
-    static constexpr uint8_t INVALID_NOTE = 255;
-    
-    // Маппинг клавиш клавиатуры на ноты (0-15 -> C, C#, D, D#, E, F, F#, G, G#, A, A#, B, C, C#, D, D#)
-    uint8_t keyToNote[KEYBOARD_KEYS];
-    
-    // Состояние
-    int8_t currentOctave;      // -2 до +2
-    uint8_t currentChannel;   // 0-15
-    uint8_t currentInstrument; // 0-127
-    bool keyStates[KEYBOARD_KEYS];  // Состояние каждой клавиши
-    
-    // Внутренние методы
-    uint8_t getMidiNote(uint8_t keyCode) const;
-    void updateKeyMapping();
-};
-
 #endif // SYNTHESIZER_HPP
@@ -27,6 +27,7 @@ public:
     // Проверка состояния
     bool isTxBusy() const;
     bool isRxDataAvailable() const;
+    uint16_t getTxFreeSpace() const { return txBuffer.getFreeSpace(); }
     
     // Обработчик прерывания (вызывается из HAL)
     void onReceiveISR();
@@ -56,6 +56,7 @@ void DebugMon_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
 /* USER CODE BEGIN EFP */
+void DMA2_Stream5_IRQHandler(void);
 
 /* USER CODE END EFP */
 
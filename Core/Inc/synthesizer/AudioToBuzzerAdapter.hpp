@@ -3,10 +3,12 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-#include "drivers/Buzzer.hpp"
+#include "drivers/Synthesizer.hpp"
+#include "synthesizer/SynthEngine.hpp"
+#include "synthesizer/VoiceManager.hpp"
 
 // Адаптер для преобразования аудиосигналов в команды Buzzer
-class AudioToBuzzerAdapter {
+class AudioToBuzzerAdapter : public SynthEngine<AudioToBuzzerAdapter> {
 public:
     static AudioToBuzzerAdapter& getInstance();
     
@@ -45,7 +47,7 @@ public:
     static constexpr uint8_t MAX_VOLUME = 10;
     
 private:
-    AudioToBuzzerAdapter() = default;
+    AudioToBuzzerAdapter() : voiceManager(*this), buzzer(Buzzer::getInstance()) {}
     ~AudioToBuzzerAdapter() = default;
     AudioToBuzzerAdapter(const AudioToBuzzerAdapter&) = delete;
     AudioToBuzzerAdapter& operator=(const AudioToBuzzerAdapter&) = delete;
@@ -53,6 +55,7 @@ private:
     // Структура для голоса
     struct Voice {
         uint16_t frequency;
+        uint8_t note;
         uint8_t velocity;
         uint8_t channel;
         uint32_t startTime;
@@ -61,37 +64,36 @@ private:
         bool released;
         ADSR adsr;
         WaveType waveType;
-        float phase;
-        float phaseIncrement;
+        uint32_t phase;           // DDS фаза, 2^32 = полный период
+        uint32_t phaseIncrement;
         
-        Voice() : frequency(0), velocity(0), channel(0), startTime(0), 
+        Voice() : frequency(0), note(0), velocity(0), channel(0), startTime(0), 
                   releaseTime(0), active(false), released(false), adsr(),
-                  waveType(WaveType::SINE), phase(0.0f), phaseIncrement(0.0f) {}
+                  waveType(WaveType::SINE), phase(0), phaseIncrement(0) {}
     };
     
     // Голоса синтезатора
-    Voice voices[MAX_VOICES];
+    typedef VoiceManager<Voice, MAX_VOICES, AudioToBuzzerAdapter, MAX_CHANNELS> Voices;
+    friend Voices;
+    static constexpr bool MONO_CHANNELS = false;
+    Voices voiceManager;
     uint8_t masterVolume;
     uint8_t channelVolumes[MAX_CHANNELS];
     
     // Buzzer для воспроизведения
     Buzzer& buzzer;
     
+    // Часть голоса, которую ведет адаптер (VoiceManager)
+    void startVoice(Voice& voice);
+    void releaseVoice(Voice& voice);
+    void silenceVoice(Voice& voice) { (void)voice; }
+    float voiceLevel(const Voice& voice) const;
+    void configureVoice(Voice& voice) { (void)voice; }
+    
     // Внутренние методы
-    uint8_t findFreeVoice() const;
-    uint8_t findVoice(uint8_t channel, uint8_t note) const;
-    uint16_t midiToFrequency(uint8_t note) const;
     float calculateADSRVolume(const Voice& voice) const;
     void updateVoice(Voice& voice);
     void selectBestVoice();
-    
-    // Генерация волн
-    float generateSine(float phase);
-    float generateSquare(float phase);
-    float generateSawtooth(float phase);
-    float generateTriangle(float phase);
-    float generateNoise();
-    float generateWave(WaveType type, float phase);
 };
 
 #endif // AUDIO_TO_BUZZER_ADAPTER_HPP
@@ -0,0 +1,80 @@
+#ifndef DSP_MATH_HPP
+#define DSP_MATH_HPP
+
+#include <stdint.h>
+
+// Режим рендеринга: 0 - float, 1 - фиксированная точка (Q15 семплы, Q31 аккумуляторы).
+// Выбирается при компиляции (-DSYNTH_FIXED_POINT=1)
+#ifndef SYNTH_FIXED_POINT
+#define SYNTH_FIXED_POINT 0
+#endif
+
+// На Cortex-M4 операции ниже - одна DSP-инструкция (CMSIS), в остальных
+// сборках - переносимая эталонная реализация с той же целочисленной
+// семантикой, поэтому результат побитно совпадает. DSP_MATH_PORTABLE
+// принудительно включает эталон и на плате.
+#if defined(__ARM_FEATURE_DSP) && !defined(DSP_MATH_PORTABLE)
+#define DSP_MATH_INTRINSICS 1
+#include "stm32f4xx_hal.h"
+#else
+#define DSP_MATH_INTRINSICS 0
+#endif
+
+class DspMath {
+public:
+    // Сложение Q31 с насыщением (QADD)
+    static inline int32_t qadd(int32_t a, int32_t b) {
+#if DSP_MATH_INTRINSICS
+        return __QADD(a, b);
+#else
+        int64_t sum = (int64_t)a + b;
+        if (sum > INT32_MAX) return INT32_MAX;
+        if (sum < INT32_MIN) return INT32_MIN;
+        return (int32_t)sum;
+#endif
+    }
+    
+    // acc + x.lo * y.lo + x.hi * y.hi, 16-битные половины со знаком (SMLAD).
+    // Переполнение - заворот по модулю 2^32, как у инструкции
+    static inline int32_t smlad(uint32_t x, uint32_t y, int32_t acc) {
+#if DSP_MATH_INTRINSICS
+        return (int32_t)__SMLAD(x, y, (uint32_t)acc);
+#else
+        int32_t low = (int32_t)(int16_t)x * (int16_t)y;
+        int32_t high = (int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16);
+        return (int32_t)((uint32_t)acc + (uint32_t)low + (uint32_t)high);
+#endif
+    }
+    
+    // Насыщение до Q15 (SSAT #16)
+    static inline int16_t ssat16(int32_t x) {
+#if DSP_MATH_INTRINSICS
+        return (int16_t)__SSAT(x, 16);
+#else
+        if (x > INT16_MAX) return INT16_MAX;
+        if (x < INT16_MIN) return INT16_MIN;
+        return (int16_t)x;
+#endif
+    }
+    
+    // Упаковка двух Q15 в слово: lo - младшая половина (PKHBT)
+    static inline uint32_t pack16(int32_t lo, int32_t hi) {
+#if DSP_MATH_INTRINSICS
+        return __PKHBT(lo, hi, 16);
+#else
+        return ((uint32_t)lo & 0xFFFFu) | ((uint32_t)hi << 16);
+#endif
+    }
+    
+    // Q15 * Q15 -> Q30 (SMULBB)
+    static inline int32_t mulQ15(int16_t a, int16_t b) {
+        return (int32_t)a * b;
+    }
+    
+    // Q30 * Q30 -> Q30 (SMULL + сдвиг)
+    static inline int32_t mulQ30(int32_t a, int32_t b) {
+        return (int32_t)(((int64_t)a * b) >> 30);
+    }
+};
+
+#endif // DSP_MATH_HPP
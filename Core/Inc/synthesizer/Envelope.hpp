@@ -0,0 +1,128 @@
+#ifndef ENVELOPE_HPP
+#define ENVELOPE_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include "synthesizer/DspMath.hpp"
+
+// Уровень огибающей: float или Q30 в режиме фиксированной точки
+#if SYNTH_FIXED_POINT
+typedef int32_t EnvelopeLevel;
+#else
+typedef float EnvelopeLevel;
+#endif
+
+// Стадии огибающей
+enum class EnvelopeStage : uint8_t {
+    IDLE,       // Голос молчит, можно освобождать
+    ATTACK,
+    DECAY,
+    SUSTAIN,
+    RELEASE
+};
+
+// Форма участков огибающей
+enum class EnvelopeCurve : uint8_t {
+    LINEAR,       // Линейные участки
+    EXPONENTIAL   // Однополюсное приближение к цели (RC-кривая)
+};
+
+// Инкрементальная ADSR огибающая: состояние - стадия и текущий уровень,
+// на каждый семпл одно умножение-сложение level = level * mul + add.
+// Коэффициенты считаются в setup(), от HAL_GetTick() не зависит.
+// При SYNTH_FIXED_POINT уровень и коэффициенты - Q30, шаг целочисленный.
+class Envelope {
+public:
+    Envelope();
+    
+    // Времена в мс, уровни в долях (0..1), rate - частота вызова next() в Гц.
+    // Текущие стадия и уровень сохраняются, можно вызывать на звучащей ноте.
+    void setup(uint16_t attackMs, uint16_t decayMs, float sustainLevel, uint16_t releaseMs,
+               float peakLevel, uint32_t rate, EnvelopeCurve curve = EnvelopeCurve::LINEAR);
+    
+    // Атака начинается с текущего уровня (без щелчка при краже голоса)
+    void trigger();
+    // Релиз от текущего уровня до нуля за заданное время
+    void release();
+    void reset();
+    
+    // Следующее значение огибающей
+    inline EnvelopeLevel next() {
+#if SYNTH_FIXED_POINT
+        level = DspMath::mulQ30(level, mul) + add;
+#else
+        level = level * mul + add;
+#endif
+        switch (stage) {
+            case EnvelopeStage::ATTACK:
+                if (level >= peak) {
+                    level = peak;
+                    enterStage(EnvelopeStage::DECAY);
+                }
+                break;
+            case EnvelopeStage::DECAY:
+                if (level <= sustain) {
+                    level = sustain;
+                    enterStage(EnvelopeStage::SUSTAIN);
+                }
+                break;
+            case EnvelopeStage::RELEASE:
+                if (level <= 0) {
+                    level = 0;
+                    enterStage(EnvelopeStage::IDLE);
+                }
+                break;
+            default:
+                break;
+        }
+        return level;
+    }
+    
+    // Заполнение буфера значениями огибающей (для блочного рендеринга),
+    // stride - шаг между семплами (для SoA буфера [семпл][голос])
+#if SYNTH_FIXED_POINT
+    void processQ15(int16_t* out, size_t frames, size_t stride = 1);
+#else
+    void process(float* out, size_t frames, size_t stride = 1);
+#endif
+    
+    bool isFinished() const { return stage == EnvelopeStage::IDLE; }
+    bool isReleased() const { return stage == EnvelopeStage::RELEASE || stage == EnvelopeStage::IDLE; }
+    EnvelopeStage getStage() const { return stage; }
+    float getLevel() const { return toFloat(level); }
+#if SYNTH_FIXED_POINT
+    int16_t getLevelQ15() const { return (int16_t)(level >> 15); }
+#endif
+    
+private:
+    // Коэффициенты одной стадии: level = level * mul + add
+    struct StageCoefficients {
+        EnvelopeLevel mul;
+        EnvelopeLevel add;
+        
+        StageCoefficients() : mul(fromFloat(1.0f)), add(0) {}
+    };
+    
+    // Перевод между долями и EnvelopeLevel (Q30 или float)
+    static EnvelopeLevel fromFloat(float value);
+    static float toFloat(EnvelopeLevel value);
+    
+    static StageCoefficients linearCoefficients(float from, float to, uint32_t samples);
+    static StageCoefficients exponentialCoefficients(float from, float to, uint32_t samples, float targetRatio);
+    
+    void enterStage(EnvelopeStage next);
+    
+    StageCoefficients attackCoef;
+    StageCoefficients decayCoef;
+    StageCoefficients releaseCoef;
+    EnvelopeLevel peak;
+    EnvelopeLevel sustain;
+    EnvelopeLevel level;
+    EnvelopeLevel mul;
+    EnvelopeLevel add;
+    uint32_t releaseLength;   // Длительность релиза в семплах
+    EnvelopeStage stage;
+    EnvelopeCurve shape;
+};
+
+#endif // ENVELOPE_HPP
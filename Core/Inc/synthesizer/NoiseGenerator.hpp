@@ -0,0 +1,115 @@
+#ifndef NOISE_GENERATOR_HPP
+#define NOISE_GENERATOR_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include "synthesizer/DspMath.hpp"
+
+// Окраска шума
+enum class NoiseColor : uint8_t {
+    WHITE,      // Белый: xorshift32
+    PINK,       // Розовый: Voss-McCartney, -3 дБ/октава
+    METALLIC    // Металлический: короткий LFSR (период 93) + ФВЧ, для хай-хэтов
+};
+
+// Детерминированный генератор шума голоса: несколько сдвигов и XOR на семпл,
+// без rand() и деления. Одинаковое зерно дает одинаковую последовательность -
+// шумовые голоса воспроизводимы в офлайн рендере и регрессионных тестах.
+class NoiseGenerator {
+public:
+    static constexpr uint32_t DEFAULT_SEED = 0x2545F491u;
+    static constexpr uint8_t PINK_ROWS = 15;  // Строк Voss-McCartney (+1 белая)
+
+    NoiseGenerator() : color(NoiseColor::WHITE) { seed(DEFAULT_SEED); }
+
+    // Сброс состояния; нулевое зерно заменяется DEFAULT_SEED (xorshift из 0 не выходит)
+    void seed(uint32_t value) {
+        state = value ? value : DEFAULT_SEED;
+        lfsr = (uint16_t)((state & 0x7FFFu) | 1u);
+        counter = 0;
+        pinkSum = 0;
+        for (uint8_t i = 0; i < PINK_ROWS; i++) {
+            pinkRows[i] = 0;
+        }
+        lastMetal = 0;
+    }
+
+    void setColor(NoiseColor value) { color = value; }
+    NoiseColor getColor() const { return color; }
+
+    // Следующее 32-битное случайное число (xorshift32, период 2^32 - 1)
+    inline uint32_t nextRaw() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    // Белый шум Q15
+    inline int16_t nextWhite() {
+        return (int16_t)(nextRaw() >> 16);
+    }
+
+    // Розовый шум Q15: на семпле n обновляется строка ctz(n), остальные держат
+    // значение - строка k меняется вдвое реже строки k - 1
+    inline int16_t nextPink() {
+        counter++;
+        uint8_t row = (uint8_t)__builtin_ctz(counter | (1u << (PINK_ROWS - 1)));
+        int16_t value = (int16_t)(nextRaw() >> 16) >> 4;
+        pinkSum += value - pinkRows[row];
+        pinkRows[row] = value;
+        // Строки + белая составляющая, x2 до уровня белого шума с насыщением
+        return DspMath::ssat16((pinkSum + ((int16_t)(nextRaw() >> 16) >> 4)) * 2);
+    }
+
+    // Металлический шум Q15: 15-битный LFSR в коротком режиме (отвод от бита 6)
+    // дает звенящий период 93 семпла, первая разность срезает низ
+    inline int16_t nextMetallic() {
+        uint16_t feedback = (lfsr ^ (lfsr >> 6)) & 1u;
+        lfsr = (uint16_t)((lfsr >> 1) | (feedback << 14));
+        int16_t value = (lfsr & 1u) ? 16383 : -16384;
+        int16_t out = (int16_t)(value - lastMetal);
+        lastMetal = value;
+        return out;
+    }
+
+    // Следующий семпл выбранной окраски
+    inline int16_t next() {
+        switch (color) {
+            case NoiseColor::PINK:
+                return nextPink();
+            case NoiseColor::METALLIC:
+                return nextMetallic();
+            case NoiseColor::WHITE:
+            default:
+                return nextWhite();
+        }
+    }
+
+    // Заполнение блока Q15 (выбор окраски вынесен из цикла)
+    void process(int16_t* out, size_t frames) {
+        switch (color) {
+            case NoiseColor::PINK:
+                for (size_t i = 0; i < frames; i++) out[i] = nextPink();
+                break;
+            case NoiseColor::METALLIC:
+                for (size_t i = 0; i < frames; i++) out[i] = nextMetallic();
+                break;
+            case NoiseColor::WHITE:
+            default:
+                for (size_t i = 0; i < frames; i++) out[i] = nextWhite();
+                break;
+        }
+    }
+
+private:
+    uint32_t state;
+    uint32_t counter;
+    int32_t pinkSum;
+    int16_t pinkRows[PINK_ROWS];
+    uint16_t lfsr;
+    int16_t lastMetal;
+    NoiseColor color;
+};
+
+#endif // NOISE_GENERATOR_HPP
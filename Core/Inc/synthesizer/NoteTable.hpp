@@ -0,0 +1,57 @@
+#ifndef NOTE_TABLE_HPP
+#define NOTE_TABLE_HPP
+
+#include <stdint.h>
+
+// Частота тактирования таймера зуммера (TIM1 на APB2, HSI 16 МГц без PLL)
+#define NOTE_TIMER_CLOCK 16000000
+
+#define MIDI_NOTE_COUNT 128
+#define CENTS_PER_SEMITONE 100
+
+// Таблицы по MIDI нотам, вычисляются на этапе компиляции
+struct NoteTableData {
+    uint32_t phaseIncrement[MIDI_NOTE_COUNT];  // Приращение 32-битной фазы за семпл
+    uint32_t timerPeriod[MIDI_NOTE_COUNT];     // Тактов таймера на период ноты
+    uint16_t timerPrescaler[MIDI_NOTE_COUNT];  // PSC: наименьший, при котором ARR влезает в 16 бит
+    uint16_t timerReload[MIDI_NOTE_COUNT];     // ARR при этом PSC
+    uint16_t frequency[MIDI_NOTE_COUNT];       // Частота в Гц (округленная)
+};
+
+// Множители 2^(c/1200) для c = 0..99 в Q30
+struct NoteCentTable {
+    uint32_t ratio[CENTS_PER_SEMITONE];
+};
+
+// Таблица нот для SAMPLE_RATE (WaveSynthesizer.hpp) и NOTE_TIMER_CLOCK: noteOn/noteOff без powf
+class NoteTable {
+public:
+    static const NoteTableData data;
+    
+    static const NoteCentTable cents;
+    
+    static inline uint32_t phaseIncrement(uint8_t note) {
+        return data.phaseIncrement[note & 0x7F];
+    }
+    
+    static inline uint32_t timerPeriod(uint8_t note) {
+        return data.timerPeriod[note & 0x7F];
+    }
+    
+    static inline uint16_t timerPrescaler(uint8_t note) {
+        return data.timerPrescaler[note & 0x7F];
+    }
+    
+    static inline uint16_t timerReload(uint8_t note) {
+        return data.timerReload[note & 0x7F];
+    }
+    
+    static inline uint16_t frequency(uint8_t note) {
+        return data.frequency[note & 0x7F];
+    }
+    
+    // Приращение фазы с подстройкой в центах (fine tune / pitch bend)
+    static uint32_t phaseIncrement(uint8_t note, int16_t detune);
+};
+
+#endif // NOTE_TABLE_HPP
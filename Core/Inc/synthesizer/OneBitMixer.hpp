@@ -0,0 +1,93 @@
+#ifndef ONE_BIT_MIXER_HPP
+#define ONE_BIT_MIXER_HPP
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "tim.h"
+#include "synthesizer/PingPongBuffer.hpp"
+
+// Программный микшер "1-битной музыки" для зуммера: до MAX_VOICES
+// прямоугольных голосов - фазовые аккумуляторы, смешиваются разделением
+// времени вывода. Период ШИМ TIM1 делится на MAX_VOICES слотов, голос в
+// верхней половине своего периода занимает импульсом часть слота по
+// громкости: CCR1 = сумма ширин, среднее на выводе - сумма голосов, без
+// перегрузки при любом числе голосов.
+//
+// На семпл и голос - сложение фазы и маска, без умножений и float. Значения
+// CCR1 блоками заполняют двойной буфер, DMA по событию обновления TIM1
+// переносит их в таймер (как SigmaDeltaPWM, TIM1 и DMA2 Stream5 у них общие -
+// одновременно работает один). render() доступен напрямую: на ПК битовый
+// поток строится без таймера.
+//
+// Голоса и огибающие ведет Synthesizer (SynthOutput::ONE_BIT): на каждом
+// обновлении он передает сюда ноту и громкость ADSR голоса.
+class OneBitMixer {
+public:
+    static OneBitMixer& getInstance();
+    
+    // Инициализация: частота ШИМ = частота семплов микшера
+    bool init(uint32_t pwmFreq = DEFAULT_PWM_FREQ);
+    
+    // Управление
+    void start();
+    void stop();
+    bool isRunning() const { return running; }
+    
+    // Голоса: громкость 0 - MAX_VOLUME (шкала Synthesizer/Buzzer)
+    void playNote(uint8_t voice, uint16_t frequency, uint8_t volume);
+    void playMidiNote(uint8_t voice, uint8_t note, uint8_t volume);
+    void stopNote(uint8_t voice);
+    void stopAll();
+    void setVolume(uint8_t voice, uint8_t volume);
+    
+    // frames значений CCR1 (по одному на период ШИМ)
+    void render(uint16_t* out, size_t frames);
+    
+    // Прерывания DMA: DMA дочитал первую / вторую половину буфера
+    void onDmaHalfTransfer();
+    void onDmaTransferComplete();
+    
+    // Недогрузки: DMA повторил блок, который не успели перезаполнить
+    uint32_t getUnderruns() const { return dmaBuffer.getUnderruns(); }
+    void resetUnderruns() { dmaBuffer.resetUnderruns(); }
+    
+    // Фактические частота семплов и ширина слота голоса в тактах таймера
+    uint32_t getSampleRate() const { return sampleRate; }
+    uint16_t getSlotTicks() const { return slotTicks; }
+    uint16_t getTop() const { return top; }
+    
+    // Константы
+    static constexpr uint8_t MAX_VOICES = 8;
+    static constexpr uint8_t MAX_VOLUME = 10;
+    static constexpr uint32_t DEFAULT_PWM_FREQ = 62500;  // 16 МГц / 256: слот 32 такта
+    static constexpr uint16_t BLOCK_FRAMES = 256;        // Значений CCR1 в половине буфера
+    
+private:
+    OneBitMixer() : running(false), sampleRate(0), top(0), slotTicks(0) {}
+    ~OneBitMixer() = default;
+    OneBitMixer(const OneBitMixer&) = delete;
+    OneBitMixer& operator=(const OneBitMixer&) = delete;
+    
+    // Фаза и приращение пишутся из задачи, читаются в прерывании DMA:
+    // 32-битные поля, частично обновленный голос звучит один блок
+    struct Channel {
+        uint32_t phase;
+        volatile uint32_t increment;
+        volatile uint16_t width;     // Ширина импульса в тактах, 0 - молчит
+        
+        Channel() : phase(0), increment(0), width(0) {}
+    };
+    
+    volatile bool running;
+    uint32_t sampleRate;
+    uint16_t top;        // ARR
+    uint16_t slotTicks;  // (ARR + 1) / MAX_VOICES
+    Channel channels[MAX_VOICES];
+    PingPongBuffer<uint16_t, 2 * BLOCK_FRAMES> dmaBuffer;
+    
+    void fillFreeHalf();
+    size_t dmaReadPosition() const;
+};
+
+#endif // ONE_BIT_MIXER_HPP
@@ -0,0 +1,47 @@
+#ifndef PATTERN_MODULATOR_HPP
+#define PATTERN_MODULATOR_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Модулятор по таблице шаблонов: альтернатива SigmaDeltaModulator для
+// сборок с малым запасом CPU. Для каждого уровня амплитуды заранее строится
+// шаблон из oversampling значений CCR1 с нужной суммарной скважностью,
+// импульсы распределены по периодам равномерно (соседние отличаются не
+// больше чем на такт). На семпл - одно умножение, выбор строки и копирование
+// шаблона, без обратной связи на каждый период ШИМ.
+//
+// Дробная часть уровня переносится на следующий семпл (формирование шума
+// 1-го порядка на частоте семплов) - средняя скважность точная.
+class PatternModulator {
+public:
+    // Размер таблицы в значениях CCR1: уровней = min(полная шкала, TABLE_SIZE / oversampling)
+    static constexpr uint16_t TABLE_SIZE = 4096;
+    
+    PatternModulator() : top(0), oversampling(1), levels(2), volume(32768), residual(0) {}
+    
+    // top - ARR таймера (скважность 100% = top + 1), oversampling - периодов ШИМ на семпл.
+    // Таблица строится здесь, не в прерывании
+    void configure(uint16_t top, uint8_t oversampling);
+    void reset() { residual = 0; }
+    
+    // Громкость Q15 (32768 = 1.0)
+    void setVolume(int32_t volumeQ15);
+    
+    // frames семплов -> frames * oversampling значений CCR1
+    void modulate(const int16_t* in, size_t frames, uint16_t* out);
+    
+    uint16_t getTop() const { return top; }
+    uint8_t getOversampling() const { return oversampling; }
+    uint16_t getLevels() const { return levels; }
+    
+private:
+    uint16_t top;
+    uint8_t oversampling;
+    uint16_t levels;     // Строк в таблице
+    int32_t volume;
+    uint32_t residual;   // Перенесенная дробь уровня, Q16
+    uint16_t table[TABLE_SIZE];  // levels строк по oversampling значений
+};
+
+#endif // PATTERN_MODULATOR_HPP
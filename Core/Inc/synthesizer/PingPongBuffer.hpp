@@ -0,0 +1,80 @@
+#ifndef PING_PONG_BUFFER_HPP
+#define PING_PONG_BUFFER_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Двойной буфер для кольцевого DMA: пока DMA читает одну половину, другая
+// заполняется. Только учет половин и недогрузок, без HAL - проверяется на ПК.
+//
+// Порядок на одну половину:
+//   consumed(h)  - DMA дочитал половину h и перешел к другой (HT/TC прерывание)
+//   half(h)      - заполнение
+//   commit(h, p) - половина готова, p - текущая позиция чтения DMA
+template<typename T, size_t Capacity>
+class PingPongBuffer {
+public:
+    static_assert(Capacity % 2 == 0, "PingPongBuffer capacity must be even");
+    static constexpr uint8_t NO_HALF = 0xFF;
+
+    PingPongBuffer() : halfLength(Capacity / 2), underruns(0) { reset(Capacity / 2); }
+
+    // Новая длина половины (<= Capacity / 2), обе половины свободны
+    void reset(size_t length) {
+        halfLength = (length > Capacity / 2) ? Capacity / 2 : length;
+        ready[0] = false;
+        ready[1] = false;
+        pending = 0;
+    }
+
+    T* data() { return buffer; }
+    T* half(uint8_t h) { return buffer + h * halfLength; }
+    size_t getHalfLength() const { return halfLength; }
+    size_t getLength() const { return 2 * halfLength; }
+
+    // Половина, ожидающая заполнения, NO_HALF - обе готовы. Если свободны обе,
+    // первой - последняя освобожденная: DMA прочитает ее следующей
+    uint8_t freeHalf() const {
+        if (!ready[0] && !ready[1]) return pending;
+        if (!ready[0]) return 0;
+        if (!ready[1]) return 1;
+        return NO_HALF;
+    }
+
+    // DMA дочитал половину h. false - следующая половина не была готова
+    // и DMA повторяет старые данные (недогрузка)
+    bool consumed(uint8_t h) {
+        ready[h] = false;
+        pending = h;
+        if (!ready[h ^ 1]) {
+            underruns++;
+            return false;
+        }
+        return true;
+    }
+
+    // Половина h заполнена. readPosition - индекс, который DMA читает сейчас:
+    // если он уже внутри h, заполнение опоздало (недогрузка)
+    bool commit(uint8_t h, size_t readPosition) {
+        ready[h] = true;
+        size_t start = h * halfLength;
+        if (readPosition >= start && readPosition < start + halfLength) {
+            underruns++;
+            return false;
+        }
+        return true;
+    }
+
+    bool isReady(uint8_t h) const { return ready[h]; }
+    uint32_t getUnderruns() const { return underruns; }
+    void resetUnderruns() { underruns = 0; }
+
+private:
+    T buffer[Capacity];
+    size_t halfLength;
+    volatile uint32_t underruns;
+    volatile bool ready[2];
+    volatile uint8_t pending;  // Последняя освобожденная половина (после reset - 0)
+};
+
+#endif // PING_PONG_BUFFER_HPP
@@ -0,0 +1,40 @@
+#ifndef POLYPHASE_INTERPOLATOR_HPP
+#define POLYPHASE_INTERPOLATOR_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Повышение частоты семплов в целое число раз (1-4) полифазным КИХ-фильтром:
+// синтезатор рендерит на 22-32 кГц, модулятор получает ratio семплов на каждый.
+// Фильтр - sinc с окном Кайзера, срез на половине входной частоты,
+// TAPS коэффициентов Q14 на фазу. Один выходной семпл - TAPS / 2 SMLAD,
+// блоки обрабатываются целиком, без деления и остатка на семпл.
+class PolyphaseInterpolator {
+public:
+    static constexpr uint8_t MAX_RATIO = 4;
+    static constexpr uint8_t TAPS = 16;
+    static constexpr size_t CHUNK_FRAMES = 32;  // Входных семплов за проход
+    
+    PolyphaseInterpolator() : ratio(1) { reset(); }
+    
+    // Коэффициенты для ratio (вычисляются здесь один раз, не в прерывании)
+    void configure(uint8_t ratio);
+    // Очистка линии задержки
+    void reset();
+    
+    // frames входных семплов -> frames * ratio выходных
+    void process(const int16_t* in, size_t frames, int16_t* out);
+    
+    uint8_t getRatio() const { return ratio; }
+    // Задержка фильтра в выходных семплах (округленная)
+    uint16_t getDelay() const { return (uint16_t)((TAPS * ratio) / 2); }
+    
+private:
+    uint8_t ratio;
+    // Коэффициенты фазы p в обратном порядке: выход = sum coefficients[p][j] * line[n + j]
+    alignas(4) int16_t coefficients[MAX_RATIO][TAPS];
+    // TAPS - 1 прошлых семплов + текущий блок
+    alignas(4) int16_t line[TAPS - 1 + CHUNK_FRAMES];
+};
+
+#endif // POLYPHASE_INTERPOLATOR_HPP
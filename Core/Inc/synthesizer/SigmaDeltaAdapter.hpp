@@ -3,44 +3,87 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <atomic>
+#include "synthesizer/SynthEngine.hpp"
 #include "synthesizer/WaveSynthesizer.hpp"
 #include "synthesizer/SigmaDeltaPWM.hpp"
+#include "synthesizer/SynthEvent.hpp"
+#include "utils/SpscQueue.hpp"
 
-// Адаптер для преобразования полифонического синтезатора в сигма-дельта PWM
-class SigmaDeltaAdapter {
+// Адаптер для преобразования полифонического синтезатора в сигма-дельта PWM.
+// Голоса меняет только рендерер (прерывание DMA): методы управления кладут
+// события в очередь SPSC и сразу возвращаются. Писатель один - задачи
+// главного цикла.
+//
+// Событие несет кадр (время рендерера в семплах): рендерер делит блок на
+// отрезки по кадрам событий, нота начинается ровно на своем семпле при
+// любом размере блока. Живые события (без кадра) получают кадр вывода DMA
+// плюс постоянную задержку в два блока - джиттер не зависит от блока.
+//
+// Движок SYNTH_ENGINE_WAVE: приложение играет WaveSynthesizer только через
+// адаптер, init() запускает вывод
+class SigmaDeltaAdapter : public SynthEngine<SigmaDeltaAdapter> {
 public:
     static SigmaDeltaAdapter& getInstance();
     
-    // Инициализация
+    // Инициализация синтезатора и запуск сигма-дельта PWM
     bool init();
     
-    // Управление ноты (проксируются в синтезатор)
-    void noteOn(uint8_t channel, uint8_t note, uint8_t velocity = 64);
-    void noteOff(uint8_t channel, uint8_t note);
-    void allNotesOff();
+    // Управление ноты (события для рендерера). false - очередь полна,
+    // событие отброшено (getDroppedEvents)
+    bool noteOn(uint8_t channel, uint8_t note, uint8_t velocity = 64);
+    bool noteOff(uint8_t channel, uint8_t note);
+    bool allNotesOff();
+    
+    // Ноты на заданном кадре (секвенсор планирует шаги заранее). Прошедший
+    // кадр - применяется в начале ближайшего блока
+    bool noteOnAt(uint32_t frame, uint8_t channel, uint8_t note, uint8_t velocity = 64);
+    bool noteOffAt(uint32_t frame, uint8_t channel, uint8_t note);
+    bool schedule(const SynthEvent& event);
     
     // Управление типом волны
-    void setWaveType(uint8_t channel, WaveType type);
+    bool setWaveType(uint8_t channel, WaveType type);
     
-    // Управление ADSR
-    void setADSR(uint8_t channel, const ADSR& adsr);
+    // Управление ADSR (применяется к каналу целиком, без промежуточных наборов)
+    bool setADSR(uint8_t channel, const ADSR& adsr);
+    bool setADSRAt(uint32_t frame, uint8_t channel, const ADSR& adsr);
     
-    // Управление громкостью
-    void setMasterVolume(uint8_t volume);
-    void setChannelVolume(uint8_t channel, uint8_t volume);
+    // Управление громкостью и высотой
+    bool setMasterVolume(uint8_t volume);
+    bool setChannelVolume(uint8_t channel, uint8_t volume);
+    bool setPitchBend(uint8_t channel, int16_t cents);
     
-    // Обновление (вызывается из задачи с частотой sampleRate)
-    void update();
+    // Рендеринг frames семплов с применением событий на их кадрах.
+    // Вызывается из прерывания DMA, без запуска PWM - напрямую (офлайн,
+    // float - без округления до Q15, для 24-битного вывода)
+    void render(int16_t* out, size_t frames);
+    void render(float* out, size_t frames);
     
-    // Обновление PWM (вызывается из таймера с частотой PWM)
-    void updatePWM();
+    // Обновление (вызывается из задачи). Звук рендерится блоками из
+    // прерываний DMA драйвера, здесь - только служебная работа синтезатора
+    // и применение событий, пока поток DMA остановлен
+    void update();
     
-    // Состояние
+    // Состояние на конец последнего блока (события из очереди - еще не учтены)
     uint8_t getActiveVoices() const;
     bool isChannelActive(uint8_t channel) const;
+    uint32_t getUnderruns() const;
+    uint32_t getDroppedEvents() const { return events.getDropped(); }
+    
+    // Часы: кадр начала следующего блока рендеринга и кадр, который сейчас
+    // выводит DMA (без запущенного PWM - совпадает с первым)
+    uint32_t getFrameTime() const { return frameTime.load(std::memory_order_relaxed); }
+    uint32_t getPlaybackFrame() const;
+    // Кадр для живого события: вывод + два блока (весь буфер DMA)
+    uint32_t getLiveFrame() const;
+    
+    static constexpr uint8_t MAX_CHANNELS = WaveSynthesizer::MAX_CHANNELS;
+    static constexpr uint32_t EVENT_QUEUE_SIZE = 64;
+    static constexpr uint32_t MAX_SCHEDULED = 64;  // Ждущих своего кадра
     
 private:
-    SigmaDeltaAdapter() = default;
+    SigmaDeltaAdapter() : synthesizer(WaveSynthesizer::getInstance()), pwmDriver(SigmaDeltaPWM::getInstance()),
+                          scheduledCount(0), playbackOrigin(0), originStart(0), frameTime(0), activeVoices(0), activeChannels(0) {}
     ~SigmaDeltaAdapter() = default;
     SigmaDeltaAdapter(const SigmaDeltaAdapter&) = delete;
     SigmaDeltaAdapter& operator=(const SigmaDeltaAdapter&) = delete;
@@ -48,8 +91,38 @@ private:
     WaveSynthesizer& synthesizer;
     SigmaDeltaPWM& pwmDriver;
     
-    static constexpr uint32_t SAMPLE_RATE = 44100;
-    static constexpr uint32_t PWM_FREQ = 1000000; // 1 MHz
+    // Очередь событий: пишут задачи, читает рендерер
+    SpscQueue<SynthEvent, EVENT_QUEUE_SIZE> events;
+    ADSR pendingAdsr;  // Сборка группы ATTACK..ADSR_APPLY (рендерер)
+    
+    // Разобранные из очереди события, по возрастанию кадра (рендерер).
+    // Порядок событий одного кадра сохраняется
+    SynthEvent scheduled[MAX_SCHEDULED];
+    uint8_t scheduledCount;
+    uint32_t playbackOrigin;  // frameTime в момент запуска PWM
+    uint32_t originStart;     // Запуск PWM (getStartCount), от которого playbackOrigin
+    
+    // Пишет только рендерер, задачи читают
+    std::atomic<uint32_t> frameTime;       // Кадров отрендерено с запуска
+    std::atomic<uint8_t> activeVoices;
+    std::atomic<uint16_t> activeChannels;  // Бит на канал
+    
+    bool post(SynthEventType type, uint8_t channel, uint8_t data1 = 0, uint8_t data2 = 0, uint16_t value = 0);
+    void collectEvents();
+    void applyDueEvents(uint32_t frame);
+    void applyEvent(const SynthEvent& event);
+    void publishState();
+    template<typename Sample>
+    void renderSegments(Sample* out, size_t frames);
+    
+    // Рендеринг блока для DMA (из прерывания)
+    static void renderBlock(int16_t* out, size_t frames);
+    
+    static constexpr uint32_t PWM_FREQ = 1000000; // Верхняя граница несущей, 1 MHz
+    // Вход модулятора не ниже 44.1 кГц: при пониженной SAMPLE_RATE недостающее
+    // дает интерполятор (32000 и 22050 -> x2)
+    static constexpr uint32_t MODULATOR_RATE = 44100;
+    static constexpr uint8_t INTERPOLATION = (MODULATOR_RATE + SAMPLE_RATE - 1) / SAMPLE_RATE;
 };
 
 #endif // SIGMA_DELTA_ADAPTER_HPP
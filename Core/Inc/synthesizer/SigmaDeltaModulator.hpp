@@ -0,0 +1,54 @@
+#ifndef SIGMA_DELTA_MODULATOR_HPP
+#define SIGMA_DELTA_MODULATOR_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Сигма-дельта модулятор блоками: Q15 семплы -> значения CCR1 для DMA.
+// Каждый семпл занимает oversampling периодов ШИМ. Без HAL - проверяется на ПК.
+//
+// Схема с обратной связью по ошибке квантования: NTF = (1 - z^-1)^order,
+// шум вытесняется к частоте ШИМ. Квантователь - levels уровней скважности
+// от 0 до ARR + 1 (2 - классический 1 бит, 0 - все значения CCR).
+// Для устойчивости ошибка ограничивается. Шум 3-го порядка требует
+// многоуровневого квантователя: с 1 битом схема неустойчива.
+class SigmaDeltaModulator {
+public:
+    static constexpr uint8_t MAX_ORDER = 3;
+    static constexpr uint16_t ALL_LEVELS = 0;
+    
+    SigmaDeltaModulator() : top(0), oversampling(1), order(1), levels(2), step(1),
+                            stepQ(256), reciprocal(0), volume(32768) { reset(); }
+    
+    // top - ARR таймера (скважность 100% = top + 1), oversampling - периодов ШИМ на семпл,
+    // order - порядок формирования шума (1-3), levels - уровни квантователя
+    void configure(uint16_t top, uint8_t oversampling, uint8_t order = 2, uint16_t levels = ALL_LEVELS);
+    void reset();
+    
+    // Громкость Q15 (32768 = 1.0)
+    void setVolume(int32_t volumeQ15);
+    
+    // frames семплов -> frames * oversampling значений CCR1
+    void modulate(const int16_t* in, size_t frames, uint16_t* out);
+    
+    uint16_t getTop() const { return top; }
+    uint8_t getOversampling() const { return oversampling; }
+    uint8_t getOrder() const { return order; }
+    uint16_t getLevels() const { return levels; }
+    
+private:
+    template<uint8_t Order>
+    void modulateLoop(const int16_t* in, size_t frames, uint16_t* out);
+    
+    uint16_t top;
+    uint8_t oversampling;
+    uint8_t order;
+    uint16_t levels;      // Фактическое число уровней
+    uint16_t step;        // Шаг квантователя в тактах таймера
+    int32_t stepQ;        // Он же, Q8
+    uint32_t reciprocal;  // 2^32 / stepQ - деление без UDIV
+    int32_t volume;
+    int32_t error[MAX_ORDER];  // Прошлые ошибки квантования, такты Q8
+};
+
+#endif // SIGMA_DELTA_MODULATOR_HPP
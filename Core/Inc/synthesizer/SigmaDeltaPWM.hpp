@@ -1,60 +1,120 @@
- #ifndef SIGMA_DELTA_PWM_HPP
+#ifndef SIGMA_DELTA_PWM_HPP
 #define SIGMA_DELTA_PWM_HPP
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "tim.h"
+#include "synthesizer/PingPongBuffer.hpp"
+#include "synthesizer/SigmaDeltaModulator.hpp"
+#include "synthesizer/PatternModulator.hpp"
+#include "synthesizer/PolyphaseInterpolator.hpp"
+
+// Способ получения CCR1 из семплов
+enum class ModulatorType : uint8_t {
+    ERROR_FEEDBACK,  // SigmaDeltaModulator: формирование шума на каждый период ШИМ
+    PATTERN_TABLE    // PatternModulator: готовый шаблон на семпл, дешевле в разы
+};
 
 // Класс для сигма-дельта модуляции и PWM
-// Преобразует аудиосигнал в битовый поток для PWM
+// Преобразует аудиосигнал в битовый поток для PWM. Вывод - двойной буфер
+// значений CCR1, который DMA по событию обновления TIM1 переносит в таймер;
+// следующий блок рендерится из прерываний половины/конца передачи.
+// Между рендерингом и модулятором - полифазный интерполятор: синтезатор
+// может работать на частоте в ratio раз ниже входа модулятора.
 class SigmaDeltaPWM {
 public:
+    // Источник звука: frames семплов Q15 (вызывается из прерывания DMA)
+    typedef void (*RenderCallback)(int16_t* out, size_t frames);
+    
     static SigmaDeltaPWM& getInstance();
     
-    // Инициализация
+    // Инициализация. sampleRate - частота рендеринга (до интерполятора)
     bool init(uint32_t sampleRate = 44100, uint32_t pwmFreq = 1000000);
     
-    // Добавление сэмпла для обработки
-    void pushSample(float sample); // sample в диапазоне [-1.0, 1.0]
-    
-    // Обновление PWM (вызывается из высокочастотного таймера)
-    void updatePWM(); // Вызывается на частоте pwmFreq
+    void setRenderCallback(RenderCallback callback);
     
     // Управление
     void start();
     void stop();
     bool isRunning() const { return running; }
+    // Число запусков: start() рендерит обе половины буфера до запуска DMA,
+    // источник звука отличает по нему новый запуск
+    uint32_t getStartCount() const { return startCount; }
+    
+    // Прерывания DMA: DMA дочитал первую / вторую половину буфера
+    void onDmaHalfTransfer();
+    void onDmaTransferComplete();
+    
+    // Недогрузки: DMA повторил блок, который не успели перезаполнить
+    uint32_t getUnderruns() const { return dmaBuffer.getUnderruns(); }
+    void resetUnderruns() { dmaBuffer.resetUnderruns(); }
+    
+    // Часы вывода: семплов рендеринга, которые DMA вывел с запуска (start),
+    // с точностью до семпла по счетчику DMA. Можно звать из задачи
+    uint32_t getPlayedFrames() const;
     
-    // Настройки
+    // Настройки. Применяются сразу, во время вывода - с перезапуском
+    // (stop -> настройка таймера -> start, часы getPlayedFrames - с нуля)
     void setSampleRate(uint32_t rate);
     void setPWMFreq(uint32_t freq);
     void setVolume(float volume); // 0.0 - 1.0
     
+    // Модулятор: порядок формирования шума (1-3) и уровни квантователя
+    // (2 - 1 бит, SigmaDeltaModulator::ALL_LEVELS - все значения CCR1)
+    void setModulator(uint8_t order, uint16_t levels);
+    void setModulatorType(ModulatorType type);
+    ModulatorType getModulatorType() const { return modulatorType; }
+    
+    // Интерполяция между рендерингом и модулятором (1 - выключена,
+    // до PolyphaseInterpolator::MAX_RATIO). Частота рендеринга сохраняется
+    void setInterpolation(uint8_t ratio);
+    
+    // Фактические частоты после подбора ARR и передискретизации
+    uint32_t getPWMFreq() const { return pwmFreq; }
+    uint32_t getSampleRate() const { return sampleRate; }
+    uint8_t getOversampling() const { return modulator.getOversampling(); }
+    uint8_t getInterpolation() const { return interpolator.getRatio(); }
+    // Семплов рендеринга на половину буфера
+    size_t getRenderFrames() const { return BLOCK_FRAMES / interpolator.getRatio(); }
+    
+    // Семплов модулятора в половине буфера и максимум периодов ШИМ на семпл
+    static constexpr uint16_t BLOCK_FRAMES = 64;
+    static constexpr uint8_t MAX_OVERSAMPLING = 32;
+    
 private:
-    SigmaDeltaPWM() : running(false), pwmFreq(0), sampleRate(0), 
-                     phaseAccumulator(0), error(0.0f), volume(1.0f), 
-                     currentSample(0.0f) {}
+    SigmaDeltaPWM() : running(false), playedHalves(0), startCount(0), pwmFreq(0), sampleRate(0), 
+                     requestedPwmFreq(0), requestedSampleRate(0), render(nullptr),
+                     modulatorOrder(2), modulatorLevels(SigmaDeltaModulator::ALL_LEVELS),
+                     interpolationRatio(1), modulatorType(ModulatorType::ERROR_FEEDBACK) {}
     ~SigmaDeltaPWM() = default;
     SigmaDeltaPWM(const SigmaDeltaPWM&) = delete;
     SigmaDeltaPWM& operator=(const SigmaDeltaPWM&) = delete;
     
-    bool running;
+    volatile bool running;
+    volatile uint32_t playedHalves;  // Половин буфера, дочитанных DMA с запуска
+    uint32_t startCount;
     uint32_t pwmFreq;
     uint32_t sampleRate;
+    uint32_t requestedPwmFreq;
+    uint32_t requestedSampleRate;
     
-    // Сигма-дельта модулятор
-    uint32_t phaseAccumulator;
-    float error;
-    float currentSample;
-    float volume;
-    
-    // Буфер для сглаживания переходов между семплами
-    float sampleBuffer[2];
-    uint8_t bufferIndex;
+    RenderCallback render;
+    uint8_t modulatorOrder;
+    uint16_t modulatorLevels;
+    uint8_t interpolationRatio;
+    ModulatorType modulatorType;
+    SigmaDeltaModulator modulator;
+    PatternModulator patternModulator;
+    PolyphaseInterpolator interpolator;
+    PingPongBuffer<uint16_t, 2 * BLOCK_FRAMES * MAX_OVERSAMPLING> dmaBuffer;
+    int16_t renderBuffer[BLOCK_FRAMES];
+    int16_t upsampledBuffer[BLOCK_FRAMES];
     
     void updateTimerSettings();
-    float interpolateSample();
+    void reconfigure();
+    void fillFreeHalf();
+    size_t dmaReadPosition() const;
 };
 
 #endif // SIGMA_DELTA_PWM_HPP
-
@@ -0,0 +1,83 @@
+#ifndef SYNTH_BENCHMARK_HPP
+#define SYNTH_BENCHMARK_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Микробенчмарки DSP синтезатора: генераторы WaveGenerator, огибающая,
+// сигма-дельта модулятор и микшер (mixBlock и mixVoices) для 1-32 голосов
+// каждой формы волны. Время на плате - такты DWT->CYCCNT, на ПК - нс
+// (steady_clock). Каждый замер повторяется REPEATS раз, берется минимум
+// (прерывания и планировщик ОС только добавляют время).
+//
+// Вывод - CSV или JSON, строка на замер:
+//   benchmark, variant, voices, samples, total, per_sample, per_voice_sample
+// В конце строки budget по каждой волне: сколько голосов mixBlock помещается
+// в бюджет семпла (такты ядра или нс на 1/SAMPLE_RATE) вместе с модулятором
+// 2-го порядка; per_sample у них - сам бюджет.
+//
+// Прогон пошаговый: step() делает один замер и выводит его строку, задача
+// UART вызывает его, пока в буфере передачи есть место. Микшер и голоса у
+// бенчмарка свои, звучащий WaveSynthesizer не затрагивается.
+// Заголовок не тянет WaveSynthesizer.hpp - его можно подключать из AppTasks
+// (drivers/Synthesizer.hpp объявляет Voice по-своему), микшер - по ссылке.
+class VoiceMixer;
+
+class SynthBenchmark {
+public:
+    enum class Format : uint8_t {
+        CSV,
+        JSON
+    };
+    
+    typedef void (*Writer)(const char* text);
+    
+    static SynthBenchmark& getInstance();
+    
+    // Начало прогона, samples - семплов на замер
+    void start(Format format, uint32_t samples = DEFAULT_SAMPLES);
+    
+    // Следующий замер и его строка (первый вызов - заголовок). false - прогон
+    // окончен, выведен хвост
+    bool step(Writer write);
+    
+    bool isRunning() const { return running; }
+    
+    // "cycles" на плате, "ns" на ПК
+    static const char* unit();
+    
+    static constexpr uint32_t DEFAULT_SAMPLES = 2048;
+    static constexpr uint8_t REPEATS = 3;
+    static constexpr size_t LINE_SIZE = 192;  // Самая длинная строка вывода
+
+private:
+    SynthBenchmark();
+    ~SynthBenchmark() = default;
+    SynthBenchmark(const SynthBenchmark&) = delete;
+    SynthBenchmark& operator=(const SynthBenchmark&) = delete;
+    
+    static constexpr uint8_t WAVE_COUNT = 5;
+    static constexpr uint8_t MAX_VOICES = 32;
+    
+    VoiceMixer& mixer;     // Свой микшер, не синтезатора
+    Format format;
+    uint32_t samples;
+    uint16_t cursor;       // Номер следующего шага
+    bool running;
+    uint32_t outputCost;   // Модулятор 2-го порядка за прогон (для бюджета)
+    uint32_t mixCost[WAVE_COUNT][MAX_VOICES];  // mixBlock за прогон
+    
+    // Результат одного замера
+    struct Result {
+        const char* benchmark;
+        const char* variant;
+        uint8_t voices;    // 0 - не зависит от голосов
+        uint32_t total;    // Единиц за samples семплов
+    };
+    
+    bool measureStep(uint16_t index, Result& result);
+    void writeResult(Writer write, const Result& result, bool first);
+    void writeBudget(Writer write, uint8_t wave);
+};
+
+#endif // SYNTH_BENCHMARK_HPP
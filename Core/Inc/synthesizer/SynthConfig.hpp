@@ -0,0 +1,29 @@
+#ifndef SYNTH_CONFIG_HPP
+#define SYNTH_CONFIG_HPP
+
+#include "synthesizer/DspMath.hpp"
+
+// Константы для синтезатора
+// Частота рендеринга. С сигма-дельта выводом можно собрать на 22050-32000
+// (-DSAMPLE_RATE=22050): до частоты модулятора поднимет интерполятор
+#ifndef SAMPLE_RATE
+#define SAMPLE_RATE 44100
+#endif
+#define WAVE_TABLE_BITS 9
+#define WAVE_TABLE_SIZE (1 << WAVE_TABLE_BITS)
+#define PHASE_RANGE 4294967296.0f  // 2^32 - полный период 32-битной фазы
+#define MAX_HARMONICS 8
+// Переключатели ниже задаются и из командной строки (-DAUDIO_BLOCK_SIZE=32 ...):
+// эталонный рендер (Host/Src/GoldenAudioCheck.cpp) сверяет с ними звук
+#ifndef AUDIO_BLOCK_SIZE
+#define AUDIO_BLOCK_SIZE 64      // Размер блока рендеринга (32/64/128 семплов)
+#endif
+#ifndef WAVE_BANK_ENABLED
+#define WAVE_BANK_ENABLED 1      // 1 - mip-map таблицы во flash (WaveBank), 0 - PolyBLEP
+#endif
+#ifndef VOICE_SOA_ENABLED
+#define VOICE_SOA_ENABLED 1      // 1 - табличные голоса рендерятся SIMD-ядрами по SoA пулу (нужен WaveBank)
+#endif
+// SYNTH_FIXED_POINT (DspMath.hpp) - 1: рендеринг в Q15 без float, 0: float
+
+#endif // SYNTH_CONFIG_HPP
@@ -0,0 +1,59 @@
+#ifndef SYNTH_ENGINE_HPP
+#define SYNTH_ENGINE_HPP
+
+#include <stdint.h>
+
+// Движок синтезатора выбирается при компиляции (-DSYNTH_ENGINE=...).
+// Приложение (задачи, секвенсор, пианино) играет через SynthesizerBridge:
+// подключается только заголовок выбранного движка, вызовы встраиваются в
+// него напрямую. Реализации Synthesizer и AudioToBuzzerAdapter собираются
+// только выбранными и в прошивку иначе не попадают; WaveSynthesizer
+// попадает в прошивку только с SYNTH_ENGINE_WAVE
+#define SYNTH_ENGINE_LEGACY 0          // Synthesizer: голоса на Buzzer / OneBitMixer
+#define SYNTH_ENGINE_WAVE 1            // SigmaDeltaAdapter: WaveSynthesizer на сигма-дельта PWM
+#define SYNTH_ENGINE_BUZZER_ADAPTER 2  // AudioToBuzzerAdapter: волны и ADSR на Buzzer
+#ifndef SYNTH_ENGINE
+#define SYNTH_ENGINE SYNTH_ENGINE_LEGACY
+#endif
+
+// Пресеты барабанов (общие для всех движков и секвенсора)
+enum class DrumPreset {
+    KICK,       // Бас-барабан
+    SNARE,      // Малый барабан
+    HIHAT,      // Хай-хэт
+    CRASH,      // Крэш
+    RIDE,       // Райд
+    TOM_HIGH,   // Высокий том
+    TOM_MID,    // Средний том
+    TOM_LOW     // Низкий том
+};
+
+// Статический интерфейс движка (CRTP): Derived - singleton с getInstance(),
+// init(), noteOn/noteOff/allNotesOff, update(), getActiveVoices(),
+// isChannelActive() и MAX_CHANNELS. Необязательные методы база реализует
+// сама - движок без своей версии получает пустую, без виртуальных вызовов и vtable.
+template<typename Derived>
+class SynthEngine {
+public:
+    // Тип волны канала. Тип параметра - WaveType движка: у старого Synthesizer
+    // и WaveSynthesizer свои объявления, в одной единице трансляции их нет
+    template<typename WaveTypeT>
+    void setWaveType(uint8_t channel, WaveTypeT type) {
+        (void)channel;
+        (void)type;
+    }
+    
+    // Барабан по пресету (у движков без барабанов - без эффекта)
+    void playDrum(DrumPreset preset, uint8_t velocity = 64) {
+        (void)preset;
+        (void)velocity;
+    }
+    
+    static Derived& instance() { return Derived::getInstance(); }
+
+protected:
+    SynthEngine() = default;
+    ~SynthEngine() = default;
+};
+
+#endif // SYNTH_ENGINE_HPP
@@ -0,0 +1,39 @@
+#ifndef SYNTH_EVENT_HPP
+#define SYNTH_EVENT_HPP
+
+#include <stdint.h>
+
+// Событие управления синтезатором: задачи (клавиатура, секвенсор, UART)
+// не трогают голоса сами, а кладут события в очередь, рендерер применяет
+// их на границе блока. Поля data1/data2/value - по типу события
+enum class SynthEventType : uint8_t {
+    NOTE_ON,            // data1 - нота, data2 - velocity
+    NOTE_OFF,           // data1 - нота
+    ALL_NOTES_OFF,
+    WAVE_TYPE,          // data1 - WaveType
+    // ADSR канала одной группой: ATTACK..RELEASE накапливаются,
+    // ADSR_APPLY применяет набор целиком (SpscQueue публикует группу атомарно)
+    ATTACK,             // value - мс
+    DECAY,              // value - мс
+    SUSTAIN,            // data1 - уровень 0-10
+    RELEASE,            // value - мс
+    ADSR_APPLY,         // data1 - EnvelopeCurve
+    MASTER_VOLUME,      // data1 - громкость 0-10
+    CHANNEL_VOLUME,     // data1 - громкость 0-10
+    PITCH_BEND          // value - центы (int16_t)
+};
+
+struct SynthEvent {
+    uint32_t time;          // Кадр рендерера, к которому относится событие
+    SynthEventType type;
+    uint8_t channel;
+    uint8_t data1;
+    uint8_t data2;
+    uint16_t value;
+    
+    SynthEvent() : time(0), type(SynthEventType::ALL_NOTES_OFF), channel(0), data1(0), data2(0), value(0) {}
+    SynthEvent(uint32_t t, SynthEventType ty, uint8_t ch, uint8_t d1 = 0, uint8_t d2 = 0, uint16_t v = 0)
+        : time(t), type(ty), channel(ch), data1(d1), data2(d2), value(v) {}
+};
+
+#endif // SYNTH_EVENT_HPP
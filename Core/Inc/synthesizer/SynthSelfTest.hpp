@@ -0,0 +1,30 @@
+#ifndef SYNTH_SELF_TEST_HPP
+#define SYNTH_SELF_TEST_HPP
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Проверка побитной воспроизводимости рендеринга: фиксированный сценарий
+// (аккорд, разные формы волны, pitch bend, шум, релиз) рендерится в Q15 и
+// сворачивается в CRC32. В режиме SYNTH_FIXED_POINT контрольная сумма
+// одинакова на ПК (переносимый DspMath) и на плате (DSP-инструкции M4).
+// Заголовок не тянет WaveSynthesizer.hpp - его можно подключать из AppTasks
+// (команда UART - только с SYNTH_ENGINE_WAVE, иначе движок не линкуется).
+class SynthSelfTest {
+public:
+    // CRC32 выхода сценария. Состояние WaveSynthesizer сбрасывается до и после
+    static uint32_t renderChecksum();
+    
+    // Ожидаемая сумма (Q15 режим, WaveBank) и признак, что сравнение имеет смысл
+    static uint32_t expectedChecksum();
+    static bool isChecksumComparable();
+    
+    // Запуск с выводом результата в UART, true - сумма совпала
+    static bool run();
+    
+    // Длина сценария в семплах
+    static constexpr uint32_t NOTE_SAMPLES = 2048;
+    static constexpr uint32_t RELEASE_SAMPLES = 2048;
+};
+
+#endif // SYNTH_SELF_TEST_HPP
@@ -1,53 +1,68 @@
 #ifndef SYNTHESIZER_BRIDGE_HPP
 #define SYNTHESIZER_BRIDGE_HPP
 
-#include "synthesizer/WaveSynthesizer.hpp"
-#include "synthesizer/AudioToBuzzerAdapter.hpp"
+#include <stdint.h>
+#include <stdbool.h>
+#include <type_traits>
+#include "synthesizer/SynthEngine.hpp"
+
+// Подключается только выбранный движок: заголовки старого и нового
+// синтезатора объявляют WaveType/ADSR/Voice каждый по-своему
+#if SYNTH_ENGINE == SYNTH_ENGINE_LEGACY
 #include "drivers/Synthesizer.hpp"
+typedef Synthesizer SelectedSynthEngine;
+#elif SYNTH_ENGINE == SYNTH_ENGINE_WAVE
+// WaveSynthesizer - через очередь событий и сигма-дельта вывод
+#include "synthesizer/SigmaDeltaAdapter.hpp"
+typedef SigmaDeltaAdapter SelectedSynthEngine;
+#elif SYNTH_ENGINE == SYNTH_ENGINE_BUZZER_ADAPTER
+#include "synthesizer/AudioToBuzzerAdapter.hpp"
+typedef AudioToBuzzerAdapter SelectedSynthEngine;
+#else
+#error "SYNTH_ENGINE: unknown engine"
+#endif
 
-// Мост между старым и новым синтезатором
+// Мост к движку синтезатора, выбранному при компиляции (SYNTH_ENGINE).
+// Без переключения на ходу: методы встраиваются в вызовы движка, в RAM -
+// голоса только одного синтезатора
 class SynthesizerBridge {
 public:
+    static_assert(std::is_base_of<SynthEngine<SelectedSynthEngine>, SelectedSynthEngine>::value,
+                  "SYNTH_ENGINE must derive from SynthEngine<Engine>");
+
     static SynthesizerBridge& getInstance();
-    
+
     // Инициализация
     bool init();
-    
-    // Переключение между синтезаторами
-    void useOldSynthesizer();
-    void useNewSynthesizer();
-    void useBuzzerAdapter();
-    
+
     // Универсальный интерфейс
-    void noteOn(uint8_t channel, uint8_t note, uint8_t velocity = 64);
-    void noteOff(uint8_t channel, uint8_t note);
-    void allNotesOff();
-    
-    // Управление типом волны (только для нового синтезатора)
-    void setWaveType(uint8_t channel, WaveType type);
-    
+    void noteOn(uint8_t channel, uint8_t note, uint8_t velocity = 64) { engine.noteOn(channel, note, velocity); }
+    void noteOff(uint8_t channel, uint8_t note) { engine.noteOff(channel, note); }
+    void allNotesOff() { engine.allNotesOff(); }
+    void playDrum(DrumPreset preset, uint8_t velocity = 64) { engine.playDrum(preset, velocity); }
+
+    // Управление типом волны (у старого синтезатора - без эффекта)
+    void setWaveType(uint8_t channel, WaveType type) { engine.setWaveType(channel, type); }
+
     // Обновление
-    void update();
-    
+    void update() { engine.update(); }
+
     // Состояние
-    uint8_t getActiveVoices() const;
-    bool isChannelActive(uint8_t channel) const;
-    
-    // Получение текущего синтезатора
-    bool isUsingNewSynthesizer() const { return useNew; }
-    bool isUsingBuzzerAdapter() const { return useAdapter; }
-    
+    uint8_t getActiveVoices() const { return engine.getActiveVoices(); }
+    bool isChannelActive(uint8_t channel) const { return engine.isChannelActive(channel); }
+
+    // Текущий движок
+    static constexpr uint8_t ENGINE = SYNTH_ENGINE;
+    static const char* engineName();
+    SelectedSynthEngine& getEngine() { return engine; }
+
 private:
-    SynthesizerBridge() = default;
+    SynthesizerBridge() : engine(SelectedSynthEngine::getInstance()) {}
     ~SynthesizerBridge() = default;
     SynthesizerBridge(const SynthesizerBridge&) = delete;
     SynthesizerBridge& operator=(const SynthesizerBridge&) = delete;
-    
-    bool useNew; // true = новый синтезатор, false = старый
-    bool useAdapter; // true = адаптер для Buzzer
-    Synthesizer& oldSynth;
-    WaveSynthesizer& newSynth;
-    AudioToBuzzerAdapter& adapter;
+
+    SelectedSynthEngine& engine;
 };
 
 #endif // SYNTHESIZER_BRIDGE_HPP
@@ -0,0 +1,165 @@
+#ifndef VOICE_ALLOCATOR_HPP
+#define VOICE_ALLOCATOR_HPP
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Политика кражи голоса, когда свободных не осталось
+enum class StealPolicy : uint8_t {
+    OLDEST,          // Самый давно включенный
+    QUIETEST,        // С минимальным текущим уровнем огибающей
+    RELEASED_FIRST   // Сначала отпущенные (самый тихий из них), иначе самый старый
+};
+
+// Распределитель голосов: стек свободных голосов, плотный массив активных
+// (для рендеринга) и карта (канал, нота) -> голос. Выделение, поиск и
+// освобождение - O(1), перебор только при краже голоса.
+template<uint8_t Voices, uint8_t Channels = 16>
+class VoiceAllocator {
+public:
+    static constexpr uint8_t NO_VOICE = 0xFF;
+    static constexpr uint8_t NOTE_COUNT = 128;
+    
+    static_assert(Voices > 0 && Voices < NO_VOICE, "VoiceAllocator: 1..254 voices");
+    
+    VoiceAllocator() { reset(); }
+    
+    void reset() {
+        freeCount = Voices;
+        activeCount = 0;
+        sequence = 0;
+        for (uint8_t i = 0; i < Voices; i++) {
+            freeStack[i] = Voices - 1 - i; // Первым выдается голос 0
+            activePos[i] = NO_VOICE;
+            voiceChannel[i] = 0;
+            voiceNote[i] = 0;
+            age[i] = 0;
+            released[i] = false;
+        }
+        for (uint8_t c = 0; c < Channels; c++) {
+            for (uint8_t n = 0; n < NOTE_COUNT; n++) {
+                noteMap[c][n] = NO_VOICE;
+            }
+        }
+    }
+    
+    // Выделение свободного голоса под (канал, ноту), NO_VOICE - если свободных нет
+    uint8_t allocate(uint8_t channel, uint8_t note) {
+        if (freeCount == 0 || channel >= Channels) return NO_VOICE;
+        
+        uint8_t voice = freeStack[--freeCount];
+        activePos[voice] = activeCount;
+        active[activeCount++] = voice;
+        
+        voiceChannel[voice] = channel;
+        voiceNote[voice] = note & 0x7F;
+        age[voice] = ++sequence;
+        released[voice] = false;
+        noteMap[channel][note & 0x7F] = voice;
+        return voice;
+    }
+    
+    // Голос, играющий (канал, ноту) и еще не отпущенный
+    uint8_t find(uint8_t channel, uint8_t note) const {
+        if (channel >= Channels) return NO_VOICE;
+        return noteMap[channel][note & 0x7F];
+    }
+    
+    // Нота отпущена: голос доигрывает релиз, но больше не находится по ноте
+    void release(uint8_t voice) {
+        if (voice >= Voices || activePos[voice] == NO_VOICE) return;
+        unmapNote(voice);
+        released[voice] = true;
+    }
+    
+    // Возврат голоса в стек свободных (swap-remove из плотного массива)
+    void freeVoice(uint8_t voice) {
+        if (voice >= Voices || activePos[voice] == NO_VOICE) return;
+        unmapNote(voice);
+        
+        uint8_t pos = activePos[voice];
+        uint8_t last = active[--activeCount];
+        active[pos] = last;
+        activePos[last] = pos;
+        activePos[voice] = NO_VOICE;
+        
+        freeStack[freeCount++] = voice;
+    }
+    
+    // Выбор и освобождение голоса по политике; level(voice) - текущий уровень огибающей.
+    // Возвращает освобожденный голос (его же вернет следующий allocate)
+    template<typename LevelFn>
+    uint8_t steal(StealPolicy policy, LevelFn level) {
+        if (activeCount == 0) return NO_VOICE;
+        
+        uint8_t victim = NO_VOICE;
+        if (policy == StealPolicy::RELEASED_FIRST) {
+            victim = quietest(level, true);
+        }
+        if (victim == NO_VOICE && policy == StealPolicy::QUIETEST) {
+            victim = quietest(level, false);
+        }
+        if (victim == NO_VOICE) {
+            victim = oldest();
+        }
+        
+        freeVoice(victim);
+        return victim;
+    }
+    
+    // Плотный список активных голосов для рендеринга
+    const uint8_t* activeVoices() const { return active; }
+    uint8_t getActiveCount() const { return activeCount; }
+    
+    bool isActive(uint8_t voice) const { return voice < Voices && activePos[voice] != NO_VOICE; }
+    bool isReleased(uint8_t voice) const { return voice < Voices && released[voice]; }
+    uint8_t getChannel(uint8_t voice) const { return voiceChannel[voice]; }
+    uint8_t getNote(uint8_t voice) const { return voiceNote[voice]; }
+    
+private:
+    void unmapNote(uint8_t voice) {
+        // Карта могла уже указывать на более новый голос той же ноты
+        uint8_t& slot = noteMap[voiceChannel[voice]][voiceNote[voice]];
+        if (slot == voice) slot = NO_VOICE;
+    }
+    
+    uint8_t oldest() const {
+        uint8_t best = active[0];
+        for (uint8_t i = 1; i < activeCount; i++) {
+            uint8_t voice = active[i];
+            // Разность с переполнением корректна и после заворота счетчика
+            if ((int32_t)(age[voice] - age[best]) < 0) best = voice;
+        }
+        return best;
+    }
+    
+    template<typename LevelFn>
+    uint8_t quietest(LevelFn level, bool releasedOnly) const {
+        uint8_t best = NO_VOICE;
+        float bestLevel = 0.0f;
+        for (uint8_t i = 0; i < activeCount; i++) {
+            uint8_t voice = active[i];
+            if (releasedOnly && !released[voice]) continue;
+            float value = level(voice);
+            if (best == NO_VOICE || value < bestLevel) {
+                best = voice;
+                bestLevel = value;
+            }
+        }
+        return best;
+    }
+    
+    uint8_t freeStack[Voices];
+    uint8_t active[Voices];
+    uint8_t activePos[Voices];              // Позиция голоса в active (NO_VOICE - свободен)
+    uint8_t voiceChannel[Voices];
+    uint8_t voiceNote[Voices];
+    bool released[Voices];
+    uint32_t age[Voices];                   // Порядковый номер выделения
+    uint8_t noteMap[Channels][NOTE_COUNT];  // (канал, нота) -> голос
+    uint32_t sequence;
+    uint8_t freeCount;
+    uint8_t activeCount;
+};
+
+#endif // VOICE_ALLOCATOR_HPP
@@ -0,0 +1,216 @@
+#ifndef VOICE_MANAGER_HPP
+#define VOICE_MANAGER_HPP
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "synthesizer/VoiceAllocator.hpp"
+
+// Общее ядро управления голосами для Synthesizer, WaveSynthesizer и
+// AudioToBuzzerAdapter: noteOn/noteOff, поиск и кража голоса, ADSR каналов,
+// обход активных голосов. Распределение - VoiceAllocator (O(1), плотный
+// список активных), движок подключает только свою часть через Policy:
+//
+//   void startVoice(VoiceT& voice)          - нота назначена голосу (note, velocity,
+//                                             channel, adsr уже записаны)
+//   void releaseVoice(VoiceT& voice)        - нота отпущена (released уже true)
+//   void silenceVoice(VoiceT& voice)        - голос заглушен без релиза
+//   float voiceLevel(const VoiceT& voice)   - текущий уровень, для кражи голоса
+//   void configureVoice(VoiceT& voice)      - изменились параметры ADSR голоса
+//   static constexpr bool MONO_CHANNELS     - новая нота канала заменяет звучащие
+//
+// VoiceT - структура голоса движка (note, velocity, channel, active, released, adsr).
+// Голос, закончивший звучать, движок помечает active = false, releaseFinished()
+// возвращает такие голоса распределителю.
+template<typename VoiceT, uint8_t Voices, typename Policy, uint8_t Channels = 16>
+class VoiceManager {
+public:
+    typedef decltype(VoiceT::adsr) Adsr;
+
+    static constexpr uint8_t NO_VOICE = VoiceAllocator<Voices, Channels>::NO_VOICE;
+    static constexpr uint8_t MAX_VELOCITY = 127;
+    static constexpr uint8_t MAX_SUSTAIN = 10;
+
+    explicit VoiceManager(Policy& policy) : policy(policy), stealPolicy(StealPolicy::RELEASED_FIRST) {}
+
+    void reset() {
+        for (uint8_t i = 0; i < Voices; i++) {
+            voices[i] = VoiceT();
+        }
+        allocator.reset();
+    }
+
+    // Голос под (канал, ноту): повтор звучащей ноты перезапускает тот же голос,
+    // без свободных - кража по политике. Возвращает индекс голоса
+    uint8_t noteOn(uint8_t channel, uint8_t note, uint8_t velocity) {
+        if (channel >= Channels || note > 127) return NO_VOICE;
+
+        if (Policy::MONO_CHANNELS) {
+            releaseChannel(channel);
+        } else {
+            uint8_t previous = allocator.find(channel, note);
+            if (previous != NO_VOICE) {
+                allocator.freeVoice(previous);
+            }
+        }
+
+        uint8_t index = allocator.allocate(channel, note);
+        if (index == NO_VOICE) {
+            allocator.steal(stealPolicy, [this](uint8_t v) { return policy.voiceLevel(voices[v]); });
+            index = allocator.allocate(channel, note);
+        }
+
+        VoiceT& voice = voices[index];
+        voice.note = note;
+        voice.velocity = (velocity > MAX_VELOCITY) ? MAX_VELOCITY : velocity;
+        voice.channel = channel;
+        voice.active = true;
+        voice.released = false;
+        voice.adsr = Adsr();
+        policy.startVoice(voice);
+        return index;
+    }
+
+    // Нота отпущена: голос доигрывает релиз. NO_VOICE - нота не звучала
+    uint8_t noteOff(uint8_t channel, uint8_t note) {
+        uint8_t index = allocator.find(channel, note);
+        if (index != NO_VOICE) {
+            allocator.release(index);
+            voices[index].released = true;
+            policy.releaseVoice(voices[index]);
+        }
+        return index;
+    }
+
+    void allNotesOff() {
+        const uint8_t* list = allocator.activeVoices();
+        for (uint8_t i = 0; i < allocator.getActiveCount(); i++) {
+            silence(voices[list[i]]);
+        }
+        allocator.reset();
+    }
+
+    // Возврат распределителю голосов, которые движок пометил неактивными.
+    // Обход с конца: freeVoice переносит последний элемент на место удаленного
+    void releaseFinished() {
+        const uint8_t* list = allocator.activeVoices();
+        for (uint8_t i = allocator.getActiveCount(); i > 0; i--) {
+            uint8_t index = list[i - 1];
+            if (!voices[index].active) {
+                allocator.freeVoice(index);
+            }
+        }
+    }
+
+    // Обход активных голосов: fn(VoiceT& voice)
+    template<typename Fn>
+    void forEachActive(Fn fn) {
+        const uint8_t* list = allocator.activeVoices();
+        for (uint8_t i = 0; i < allocator.getActiveCount(); i++) {
+            fn(voices[list[i]]);
+        }
+    }
+
+    template<typename Fn>
+    void forChannel(uint8_t channel, Fn fn) {
+        const uint8_t* list = allocator.activeVoices();
+        for (uint8_t i = 0; i < allocator.getActiveCount(); i++) {
+            if (voices[list[i]].channel == channel) {
+                fn(voices[list[i]]);
+            }
+        }
+    }
+
+    // ADSR звучащих голосов канала
+    void setADSR(uint8_t channel, const Adsr& adsr) {
+        forChannel(channel, [this, &adsr](VoiceT& v) { v.adsr = adsr; policy.configureVoice(v); });
+    }
+
+    void setAttack(uint8_t channel, uint16_t attack) {
+        forChannel(channel, [this, attack](VoiceT& v) { v.adsr.attack = attack; policy.configureVoice(v); });
+    }
+
+    void setDecay(uint8_t channel, uint16_t decay) {
+        forChannel(channel, [this, decay](VoiceT& v) { v.adsr.decay = decay; policy.configureVoice(v); });
+    }
+
+    void setSustain(uint8_t channel, uint8_t sustain) {
+        if (sustain > MAX_SUSTAIN) sustain = MAX_SUSTAIN;
+        forChannel(channel, [this, sustain](VoiceT& v) { v.adsr.sustain = sustain; policy.configureVoice(v); });
+    }
+
+    void setRelease(uint8_t channel, uint16_t release) {
+        forChannel(channel, [this, release](VoiceT& v) { v.adsr.release = release; policy.configureVoice(v); });
+    }
+
+    void setStealPolicy(StealPolicy value) { stealPolicy = value; }
+
+    // Огибающая по времени в мс для движков без посемпловой огибающей:
+    // атака 0 -> пик (velocity), спад до sustain (доля пика 0-10), релиз -
+    // линейно от уровня в момент отпускания. Результат 0.0 - 1.0
+    static float timedLevel(const VoiceT& voice, uint32_t now) {
+        const float peak = (float)voice.velocity / MAX_VELOCITY;
+        if (!voice.released) {
+            return holdLevel(voice, peak, now - voice.startTime);
+        }
+
+        uint32_t releaseElapsed = now - voice.releaseTime;
+        if (releaseElapsed >= voice.adsr.release) return 0.0f;
+        float start = holdLevel(voice, peak, voice.releaseTime - voice.startTime);
+        return start * (1.0f - (float)releaseElapsed / voice.adsr.release);
+    }
+
+    // Состояние
+    VoiceT& voice(uint8_t index) { return voices[index]; }
+    const VoiceT& voice(uint8_t index) const { return voices[index]; }
+    VoiceT* data() { return voices; }
+    const uint8_t* activeVoices() const { return allocator.activeVoices(); }
+    uint8_t getActiveCount() const { return allocator.getActiveCount(); }
+    bool isActive(uint8_t index) const { return allocator.isActive(index); }
+
+    bool isChannelActive(uint8_t channel) const {
+        const uint8_t* list = allocator.activeVoices();
+        for (uint8_t i = 0; i < allocator.getActiveCount(); i++) {
+            if (voices[list[i]].channel == channel) return true;
+        }
+        return false;
+    }
+
+private:
+    Policy& policy;
+    VoiceT voices[Voices];
+    VoiceAllocator<Voices, Channels> allocator;
+    StealPolicy stealPolicy;
+
+    void silence(VoiceT& voice) {
+        voice.active = false;
+        voice.released = false;
+        policy.silenceVoice(voice);
+    }
+
+    // Моноканал: звучащие голоса канала глушатся до выделения нового
+    void releaseChannel(uint8_t channel) {
+        const uint8_t* list = allocator.activeVoices();
+        for (uint8_t i = allocator.getActiveCount(); i > 0; i--) {
+            uint8_t index = list[i - 1];
+            if (voices[index].channel == channel) {
+                silence(voices[index]);
+                allocator.freeVoice(index);
+            }
+        }
+    }
+
+    // Уровень атаки/спада/сустейна через elapsed мс после noteOn
+    static float holdLevel(const VoiceT& voice, float peak, uint32_t elapsed) {
+        const float sustain = peak * voice.adsr.sustain / MAX_SUSTAIN;
+        if (elapsed < voice.adsr.attack) {
+            return peak * elapsed / voice.adsr.attack;
+        }
+        elapsed -= voice.adsr.attack;
+        if (elapsed < voice.adsr.decay) {
+            return peak - (peak - sustain) * elapsed / voice.adsr.decay;
+        }
+        return sustain;
+    }
+};
+
+#endif // VOICE_MANAGER_HPP
@@ -0,0 +1,74 @@
+#ifndef VOICE_POOL_HPP
+#define VOICE_POOL_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include "synthesizer/SynthConfig.hpp"
+
+// Максимум дорожек пула и выравнивание массивов (ширина AVX2 регистра)
+#define VOICE_POOL_CAPACITY 32
+#define VOICE_POOL_ALIGN 32
+
+// Горячее состояние голосов в виде структуры массивов (SoA): одна дорожка -
+// один голос, соседние голоса лежат подряд и обрабатываются одной SIMD
+// инструкцией. Холодные поля (ADSR, канал, время) остаются в Voice.
+struct VoicePool {
+    alignas(VOICE_POOL_ALIGN) uint32_t phase[VOICE_POOL_CAPACITY];
+    alignas(VOICE_POOL_ALIGN) uint32_t increment[VOICE_POOL_CAPACITY];
+    alignas(VOICE_POOL_ALIGN) uint32_t tableOffset[VOICE_POOL_CAPACITY];  // Смещение от WaveBank::base()
+    
+    // Огибающая по семплам блока: gain[семпл][дорожка]. В режиме фиксированной
+    // точки - Q15 с уже учтенной нормализацией, соседние дорожки читаются парой
+#if SYNTH_FIXED_POINT
+    alignas(VOICE_POOL_ALIGN) int16_t gain[AUDIO_BLOCK_SIZE][VOICE_POOL_CAPACITY];
+#else
+    alignas(VOICE_POOL_ALIGN) float gain[AUDIO_BLOCK_SIZE][VOICE_POOL_CAPACITY];
+#endif
+    
+    uint8_t voice[VOICE_POOL_CAPACITY];  // Индекс исходного Voice
+    uint8_t count;
+    
+    void clear() {
+        count = 0;
+    }
+    
+    // Новая дорожка, VOICE_POOL_CAPACITY - если пул заполнен
+    uint8_t add(uint8_t voiceIndex, uint32_t startPhase, uint32_t phaseIncrement, uint32_t offset) {
+        if (count >= VOICE_POOL_CAPACITY) return VOICE_POOL_CAPACITY;
+        uint8_t lane = count++;
+        phase[lane] = startPhase;
+        increment[lane] = phaseIncrement;
+        tableOffset[lane] = offset;
+        voice[lane] = voiceIndex;
+        return lane;
+    }
+};
+
+// Ядра рендеринга пула: несколько голосов за инструкцию.
+// AVX2 - 8 дорожек (gather пары соседних точек таблицы), SSE2 - 4 дорожки,
+// Cortex-M4 - __SMLAD (обе точки интерполяции одной инструкцией), иначе скаляр.
+// При SYNTH_FIXED_POINT - одно целочисленное ядро на DspMath (SMLAD/QADD на M4,
+// переносимый эталон на ПК), результат побитно одинаков.
+class VoiceKernels {
+public:
+#if SYNTH_FIXED_POINT
+    // Рендеринг frames семплов всех дорожек с насыщающим накоплением в acc (Q30 в int32)
+    static void renderQ15(VoicePool& pool, int32_t* acc, size_t frames);
+#else
+    // Рендеринг frames (<= AUDIO_BLOCK_SIZE) семплов всех дорожек с накоплением в out
+    static void render(VoicePool& pool, float* out, size_t frames);
+    
+    // Скалярная версия (эталон и хвост дорожек, не кратный ширине SIMD)
+    static void renderScalar(VoicePool& pool, uint8_t firstLane, float* out, size_t frames);
+#endif
+    
+    // Имя выбранного при компиляции ядра
+    static const char* name();
+    
+    // С какого числа голосов в блоке пул быстрее рендеринга по одному голосу
+    // (float путь, замер Host/Src/VoiceBenchmark.cpp). Больше
+    // VOICE_POOL_CAPACITY - выигрыша нет, пул не используется
+    static uint8_t minVoices();
+};
+
+#endif // VOICE_POOL_HPP
@@ -0,0 +1,80 @@
+#ifndef WAVE_BANK_HPP
+#define WAVE_BANK_HPP
+
+#include <stdint.h>
+#include "synthesizer/WaveSynthesizer.hpp"
+
+// Банк ограниченных по полосе таблиц волн (mip-map по октавам).
+// Таблицы вычисляются на этапе компиляции и лежат во flash.
+//
+// Полоса выбирается по приращению фазы: для inc в [2^k, 2^(k+1))
+// до Найквиста помещается 2^(30-k) гармоник, независимо от SAMPLE_RATE.
+#define WAVE_BANK_BANDS WAVE_TABLE_BITS  // от WAVE_BANK_MAX_HARMONICS до 1 гармоники
+#define WAVE_BANK_MAX_HARMONICS (WAVE_TABLE_SIZE / 2 - 1)
+
+// Одна таблица (+1 точка для интерполяции без маски индекса)
+struct WaveTable {
+    int16_t data[WAVE_TABLE_SIZE + 1];
+};
+
+// Набор таблиц одной формы по полосам: band[0] - самые низкие ноты
+struct WaveBandTables {
+    WaveTable band[WAVE_BANK_BANDS];
+};
+
+// Все таблицы банка одним блоком: SIMD-ядра адресуют любую таблицу
+// смещением от начала банка
+struct WaveBankTables {
+    WaveTable sine;
+    WaveBandTables square;
+    WaveBandTables sawtooth;
+    WaveBandTables triangle;
+};
+
+class WaveBank {
+public:
+    // Таблицы (Q15)
+    static const WaveBankTables tables;
+    
+    // Общий масштаб формы, чтобы пик ограниченной по полосе волны не вышел за
+    // [-1, 1]: прямоугольная - 4/π (одна гармоника), пила - константа Гиббса 1.179.
+    // PolyBLEP генераторы умножаются на тот же масштаб - громкость не зависит от WAVE_BANK_ENABLED
+    static constexpr double SQUARE_SCALE = 3.14159265358979323846 / 4.0;
+    static constexpr double SAWTOOTH_SCALE = 1.0 / 1.18;
+    
+    // Выбор полосы по приращению фазы
+    static inline uint8_t bandForIncrement(uint32_t increment) {
+        if (increment == 0) return 0;
+        int32_t band = (31 - __builtin_clz(increment)) - (30 - BAND0_LOG2_HARMONICS);
+        if (band < 0) band = 0;
+        if (band >= WAVE_BANK_BANDS) band = WAVE_BANK_BANDS - 1;
+        return (uint8_t)band;
+    }
+    
+    // Таблица для формы волны и приращения фазы (NOISE -> синус)
+    static const int16_t* selectTable(WaveType type, uint32_t increment);
+    
+    // Начало банка и смещение таблицы от него (в семплах)
+    static inline const int16_t* base() {
+        return tables.sine.data;
+    }
+    
+    static inline uint32_t tableOffset(WaveType type, uint32_t increment) {
+        return (uint32_t)(selectTable(type, increment) - base());
+    }
+    
+    // Чтение таблицы с линейной интерполяцией, результат в [-1, 1]
+    static inline float read(const int16_t* table, uint32_t phase) {
+        uint32_t index = phase >> (32 - WAVE_TABLE_BITS);
+        int32_t frac = (int32_t)((phase >> (16 - WAVE_TABLE_BITS)) & 0xFFFF);
+        int32_t a = table[index];
+        int32_t b = table[index + 1];
+        return (float)(a + (((b - a) * frac) >> 16)) * (1.0f / 32768.0f);
+    }
+    
+private:
+    // log2 числа гармоник нижней полосы (ограничено размером таблицы)
+    static constexpr int32_t BAND0_LOG2_HARMONICS = WAVE_TABLE_BITS - 1;
+};
+
+#endif // WAVE_BANK_HPP
@@ -3,14 +3,14 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <math.h>
-
-// Константы для синтезатора
-#define SAMPLE_RATE 44100
-#define MAX_VOICES 8
-#define MAX_CHANNELS 16
-#define WAVE_TABLE_SIZE 1024
-#define MAX_HARMONICS 8
+#include "synthesizer/SynthConfig.hpp"
+#include "synthesizer/VoicePool.hpp"
+#include "synthesizer/Envelope.hpp"
+#include "synthesizer/NoiseGenerator.hpp"
+#include "synthesizer/VoiceManager.hpp"
+#include "synthesizer/SynthEngine.hpp"
 
 // Типы волн
 enum class WaveType {
@@ -27,28 +27,34 @@ struct ADSR {
     uint16_t decay;    // Время спада в мс
     uint8_t sustain;   // Уровень сустейна (0-10)
     uint16_t release;  // Время релиза в мс
+    EnvelopeCurve curve; // Форма участков
     
-    ADSR(uint16_t a = 50, uint16_t d = 100, uint8_t s = 7, uint16_t r = 200)
-        : attack(a), decay(d), sustain(s), release(r) {}
+    ADSR(uint16_t a = 50, uint16_t d = 100, uint8_t s = 7, uint16_t r = 200,
+         EnvelopeCurve c = EnvelopeCurve::LINEAR)
+        : attack(a), decay(d), sustain(s), release(r), curve(c) {}
 };
 
 // Структура для голоса синтезатора
 struct Voice {
     uint16_t frequency;        // Частота в Гц
+    uint8_t note;              // MIDI нота
     uint8_t velocity;          // Громкость (0-127)
     uint8_t channel;           // MIDI канал
     uint32_t startTime;        // Время начала ноты
     uint32_t releaseTime;      // Время начала релиза
     bool active;              // Активен ли голос
     bool released;            // В фазе релиза
-    ADSR adsr;                // ADSR огибающая
+    ADSR adsr;                // ADSR огибающая (параметры)
     WaveType waveType;        // Тип волны
-    float phase;              // Текущая фаза (0-2π)
-    float phaseIncrement;     // Приращение фазы за семпл
+    uint32_t phase;           // Текущая фаза (DDS, 2^32 = полный период)
+    uint32_t phaseIncrement;  // Приращение фазы за семпл
+    Envelope envelope;        // Состояние огибающей, продвигается по семплам
+    NoiseGenerator noise;     // Источник шума (WaveType::NOISE), зерно задается в noteOn
     
-    Voice() : frequency(0), velocity(0), channel(0), startTime(0), 
+    Voice() : frequency(0), note(0), velocity(0), channel(0), startTime(0), 
               releaseTime(0), active(false), released(false), adsr(),
-              waveType(WaveType::SINE), phase(0.0f), phaseIncrement(0.0f) {}
+              waveType(WaveType::SINE), phase(0), phaseIncrement(0),
+              envelope(), noise() {}
 };
 
 // Класс для генерации волн
@@ -56,18 +62,25 @@ class WaveGenerator {
 public:
     static WaveGenerator& getInstance();
     
-    // Генерация различных типов волн
-    float generateSine(float phase);
-    float generateSquare(float phase);
-    float generateSawtooth(float phase);
-    float generateTriangle(float phase);
-    float generateNoise();
+    // Генерация различных типов волн (фаза - 32-битный аккумулятор)
+    float generateSine(uint32_t phase);
+    float generateSquare(uint32_t phase);
+    float generateSawtooth(uint32_t phase);
+    float generateTriangle(uint32_t phase);
+    float generateNoise();     // Белый шум общего генератора
+    void seedNoise(uint32_t seed);
+    
+    // Ограниченные по полосе версии (PolyBLEP/PolyBLAMP), increment - приращение фазы за семпл
+    float generateSquare(uint32_t phase, uint32_t increment);
+    float generateSawtooth(uint32_t phase, uint32_t increment);
+    float generateTriangle(uint32_t phase, uint32_t increment);
     
     // Генерация волны по типу
-    float generateWave(WaveType type, float phase);
+    float generateWave(WaveType type, uint32_t phase);
+    float generateWave(WaveType type, uint32_t phase, uint32_t increment);
     
     // Генерация с гармониками
-    float generateWithHarmonics(WaveType type, float phase, uint8_t harmonics);
+    float generateWithHarmonics(WaveType type, uint32_t phase, uint8_t harmonics);
     
 private:
     WaveGenerator() = default;
@@ -75,41 +88,100 @@ private:
     WaveGenerator(const WaveGenerator&) = delete;
     WaveGenerator& operator=(const WaveGenerator&) = delete;
     
-    // Таблица волн для быстрого доступа
-    float waveTable[WAVE_TABLE_SIZE];
-    bool tableGenerated;
-    
-    // Генерация таблицы волн
-    void generateWaveTable();
+    NoiseGenerator noise;
 };
 
-// Класс для микширования голосов
+// Класс для микширования голосов. Состояние блока (пул, буферы) - свое
+// у каждого экземпляра: микшер принадлежит синтезатору
 class VoiceMixer {
 public:
-    static VoiceMixer& getInstance();
+    VoiceMixer() : normGain(NORM_ONE), soaEnabled(VOICE_SOA_ENABLED && WAVE_BANK_ENABLED),
+                   soaMinVoices(VoiceKernels::minVoices()) {}
+    ~VoiceMixer() = default;
     
-    // Микширование голосов
+    // Микширование голосов (один семпл, обертка над mixBlock)
     float mixVoices(Voice* voices, uint8_t voiceCount);
     
+    // Блочное микширование: огибающая каждого голоса продвигается по семплам,
+    // голос с завершенным релизом освобождается
+    void mixBlock(Voice* voices, uint8_t voiceCount, float* out, size_t frames);
+    
+    // То же по плотному списку индексов активных голосов (без перебора молчащих)
+    void mixBlock(Voice* voices, const uint8_t* activeList, uint8_t activeCount,
+                  float* out, size_t frames);
+    
+#if SYNTH_FIXED_POINT
+    // Микширование в Q15: Q30 аккумуляторы с насыщением, нормализация учтена в огибающей
+    void mixBlockQ15(Voice* voices, const uint8_t* activeList, uint8_t activeCount,
+                     int16_t* out, size_t frames);
+#endif
+    
     // Применение ADSR огибающей
     float applyADSR(const Voice& voice, float sample);
     
-    // Расчет громкости по ADSR
+    // Текущий уровень огибающей голоса
     float calculateADSRVolume(const Voice& voice);
     
     // Генерация семпла волны
     float generateWaveSample(const Voice& voice);
     
+    // Рендеринг табличных голосов через SoA пул и SIMD-ядра (иначе по одному голосу).
+    // Пул включается с minVoices активных голосов в блоке (по умолчанию -
+    // VoiceKernels::minVoices(), ниже пул медленнее); float путь
+    void setSoaEnabled(bool enabled) { soaEnabled = enabled; }
+    bool isSoaEnabled() const { return soaEnabled; }
+    void setSoaMinVoices(uint8_t voices) { soaMinVoices = voices; }
+    uint8_t getSoaMinVoices() const { return soaMinVoices; }
+    
 private:
-    VoiceMixer() = default;
-    ~VoiceMixer() = default;
     VoiceMixer(const VoiceMixer&) = delete;
     VoiceMixer& operator=(const VoiceMixer&) = delete;
+    
+    // Горячее состояние табличных голосов на время блока
+    VoicePool voicePool;
+    
+#if SYNTH_FIXED_POINT
+    // Рендеринг не табличного голоса (шум, PolyBLEP) в Q30 аккумуляторы
+    void renderVoiceQ15(Voice& voice, int32_t* acc, size_t frames, const int16_t* gains);
+    
+    // Огибающая текущего голоса на блок (Q15) и аккумуляторы блока
+    int16_t envelopeBuffer[AUDIO_BLOCK_SIZE];
+    int32_t accumulator[AUDIO_BLOCK_SIZE];
+    
+    // Нормализация 1/N по семплам (Q15), переходит из блока в блок;
+    // NORM_KNEE - огибающая с полным весом голоса в N (-42 дБ)
+    static constexpr int32_t NORM_ONE = 32768;
+    static constexpr int16_t NORM_KNEE = 256;
+    int32_t normGain;
+#else
+    // Рендеринг одного голоса в блок (с накоплением), gains - огибающая по семплам
+    void renderVoice(Voice& voice, float* out, size_t frames, const float* gains);
+    
+    template<typename Oscillator>
+    static uint32_t renderLoop(Oscillator osc, float* out, size_t frames, uint32_t phase,
+                               uint32_t increment, const float* gains);
+    
+    // Огибающая текущего голоса на блок
+    float envelopeBuffer[AUDIO_BLOCK_SIZE];
+    
+    // Нормализация 1/N по семплам, переходит из блока в блок;
+    // NORM_KNEE - огибающая с полным весом голоса в N (-42 дБ)
+    static constexpr float NORM_ONE = 1.0f;
+    static constexpr float NORM_KNEE = 1.0f / 128.0f;
+    float normGain;
+#endif
+    bool soaEnabled;
+    uint8_t soaMinVoices;
 };
 
-// Основной класс синтезатора с микшированием волн
-class WaveSynthesizer {
+// Основной класс синтезатора с микшированием волн. На плате - один экземпляр
+// (getInstance), на ПК можно создать несколько независимых движков
+// (офлайн-рендер в потоках): общих изменяемых данных у экземпляров нет
+class WaveSynthesizer : public SynthEngine<WaveSynthesizer> {
 public:
+    WaveSynthesizer() : voiceManager(*this), waveGen(WaveGenerator::getInstance()) {}
+    ~WaveSynthesizer() = default;
+    
     static WaveSynthesizer& getInstance();
     
     // Инициализация
@@ -120,9 +192,12 @@ public:
     void noteOff(uint8_t channel, uint8_t note);
     void allNotesOff();
     
+    // Политика кражи голоса при полной полифонии
+    void setStealPolicy(StealPolicy policy);
+    
     // Управление типом волны
     void setWaveType(uint8_t channel, WaveType type);
-    void setWaveType(uint8_t voice, WaveType type);
+    void setVoiceWaveType(uint8_t voice, WaveType type);
     
     // Управление ADSR
     void setADSR(uint8_t channel, const ADSR& adsr);
@@ -135,8 +210,19 @@ public:
     void setMasterVolume(uint8_t volume);
     void setChannelVolume(uint8_t channel, uint8_t volume);
     
-    // Генерация аудиосигнала
-    float generateSample();
+    // Подстройка высоты канала в центах (fine tune / pitch bend)
+    void setPitchBend(uint8_t channel, int16_t cents);
+    
+    // Шум: окраска для новых нот канала и зерно последовательности зерен голосов
+    // (одинаковое зерно + одинаковые события = одинаковый звук)
+    void setNoiseColor(uint8_t channel, NoiseColor color);
+    void setNoiseSeed(uint32_t seed);
+    
+    // Генерация аудиосигнала. Родной формат задает SYNTH_FIXED_POINT
+    // (Q15 или float), второй вариант renderBlock - с преобразованием
+    float generateSample();                        // Один семпл (обертка над renderBlock)
+    void renderBlock(float* out, size_t frames);   // Блок семплов [-1.0, 1.0]
+    void renderBlock(int16_t* out, size_t frames); // Блок семплов Q15
     
     // Обновление (вызывается из задачи)
     void update();
@@ -144,33 +230,46 @@ public:
     // Состояние
     uint8_t getActiveVoices() const;
     bool isChannelActive(uint8_t channel) const;
+    uint16_t getActiveChannels() const;  // Бит на канал с активными голосами
+    
+    // Микшер этого экземпляра (режим SoA, бенчмарки)
+    VoiceMixer& getMixer() { return mixer; }
     
     // Константы
-    static constexpr uint8_t MAX_VOICES = 8;
+    static constexpr uint8_t MAX_VOICES = 32;
     static constexpr uint8_t MAX_CHANNELS = 16;
     static constexpr uint8_t MAX_VELOCITY = 127;
     static constexpr uint8_t MAX_VOLUME = 10;
     
 private:
-    WaveSynthesizer() = default;
-    ~WaveSynthesizer() = default;
     WaveSynthesizer(const WaveSynthesizer&) = delete;
     WaveSynthesizer& operator=(const WaveSynthesizer&) = delete;
     
-    // Голоса синтезатора
-    Voice voices[MAX_VOICES];
+    // Голоса синтезатора: распределение и ADSR каналов - VoiceManager,
+    // здесь - только настройка голоса и рендеринг
+    typedef VoiceManager<Voice, MAX_VOICES, WaveSynthesizer, MAX_CHANNELS> Voices;
+    friend Voices;
+    static constexpr bool MONO_CHANNELS = false;
+    Voices voiceManager;
     uint8_t masterVolume;
     uint8_t channelVolumes[MAX_CHANNELS];
+    int16_t channelDetune[MAX_CHANNELS];
+    NoiseColor channelNoiseColor[MAX_CHANNELS];
+    NoiseGenerator seedSource;  // Выдает зерна шума голосам по порядку noteOn
     
-    // Генератор волн и микшер
+    // Генератор волн общий (осцилляторы без состояния, шум - у голоса), микшер свой
     WaveGenerator& waveGen;
-    VoiceMixer& mixer;
+    VoiceMixer mixer;
+    
+    // Часть голоса, которую ведет синтезатор (VoiceManager)
+    void startVoice(Voice& voice);
+    void releaseVoice(Voice& voice);
+    void silenceVoice(Voice& voice) { voice.envelope.reset(); }
+    float voiceLevel(const Voice& voice) const { return voice.envelope.getLevel(); }
+    void configureVoice(Voice& voice) { configureEnvelope(voice); }
     
     // Внутренние методы
-    uint8_t findFreeVoice() const;
-    uint8_t findVoice(uint8_t channel, uint8_t note) const;
-    uint16_t midiToFrequency(uint8_t note) const;
-    void updateVoice(Voice& voice);
+    void configureEnvelope(Voice& voice);
 };
 
 #endif // WAVE_SYNTHESIZER_HPP
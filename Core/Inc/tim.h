@@ -37,6 +37,7 @@ extern TIM_HandleTypeDef htim1;
 extern TIM_HandleTypeDef htim6;
 
 /* USER CODE BEGIN Private defines */
+extern DMA_HandleTypeDef hdma_tim1_up;
 
 /* USER CODE END Private defines */
 
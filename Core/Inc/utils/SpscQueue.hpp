@@ -0,0 +1,81 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <atomic>
+
+// Очередь без блокировок для одного писателя и одного читателя (например,
+// задачи главного цикла -> прерывание DMA). push и pop - без ожидания:
+// постоянное число шагов, никто никого не останавливает. Индексы свободно
+// бегут по uint32_t, позиция в буфере - по маске (Size - степень двойки).
+//
+// Писатель меняет только head, читатель - только tail. Запись элемента
+// публикуется сохранением head с release, читатель видит его после load
+// с acquire - на Cortex-M4 это обычные LDR/STR + DMB, на ПК - std::atomic.
+template<typename T, uint32_t Size>
+class SpscQueue {
+public:
+    static_assert(Size >= 2 && (Size & (Size - 1)) == 0, "SpscQueue size must be a power of two");
+    
+    SpscQueue() : head(0), tail(0), dropped(0) {}
+    
+    // Писатель: false - очередь полна, элемент отброшен (учтен в getDropped)
+    bool push(const T& item) {
+        return push(&item, 1);
+    }
+    
+    // Писатель: все count элементов или ни одного. Публикуются одной записью
+    // head - читатель не увидит группу частично
+    bool push(const T* items, uint32_t count) {
+        const uint32_t h = head.load(std::memory_order_relaxed);
+        const uint32_t t = tail.load(std::memory_order_acquire);
+        if (Size - (h - t) < count) {
+            dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            buffer[(h + i) & (Size - 1)] = items[i];
+        }
+        head.store(h + count, std::memory_order_release);
+        return true;
+    }
+    
+    // Читатель: false - очередь пуста
+    bool pop(T& item) {
+        const uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        item = buffer[t & (Size - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Читатель: fn(const T&) для элементов, опубликованных к моменту вызова.
+    // Добавленные во время обхода остаются до следующего вызова
+    template<typename Fn>
+    uint32_t consume(Fn fn) {
+        const uint32_t t = tail.load(std::memory_order_relaxed);
+        const uint32_t h = head.load(std::memory_order_acquire);
+        for (uint32_t i = t; i != h; i++) {
+            fn(buffer[i & (Size - 1)]);
+        }
+        tail.store(h, std::memory_order_release);
+        return h - t;
+    }
+    
+    // Оценка с любой стороны: вторая сторона может изменить ее сразу после чтения
+    uint32_t getCount() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+    bool isEmpty() const { return getCount() == 0; }
+    uint32_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+    static constexpr uint32_t capacity() { return Size; }
+
+private:
+    T buffer[Size];
+    std::atomic<uint32_t> head;     // Следующая запись (писатель)
+    std::atomic<uint32_t> tail;     // Следующее чтение (читатель)
+    std::atomic<uint32_t> dropped;  // Отброшено из-за переполнения (писатель)
+};
+
+#endif // SPSC_QUEUE_HPP
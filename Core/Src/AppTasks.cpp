@@ -5,6 +5,10 @@
 #include "usart.h"
 #include "Sequencer.hpp"
 #include "SequencerUI.hpp"
+#if SYNTH_ENGINE == SYNTH_ENGINE_WAVE
+#include "synthesizer/SynthSelfTest.hpp"
+#endif
+#include "synthesizer/SynthBenchmark.hpp"
 #include <stdio.h>
 #include <string.h>
 
@@ -56,7 +60,7 @@ void KeyboardTask::onKeyEvent(uint8_t keyCode, KeyEvent event) {
                     DrumPreset::KICK, DrumPreset::SNARE, DrumPreset::HIHAT, DrumPreset::CRASH,
                     DrumPreset::RIDE, DrumPreset::TOM_HIGH, DrumPreset::TOM_MID, DrumPreset::TOM_LOW
                 };
-                Synthesizer::getInstance().playDrum(drums[keyCode], 80);
+                SynthesizerBridge::getInstance().playDrum(drums[keyCode], 80);
             } else {
                 // Остальные клавиши - ноты
                 PianoController::getInstance().onKeyPress(keyCode);
@@ -142,8 +146,19 @@ void UartTask::onInit() {
     uart.printf("Keyboard, Display, Buzzer ready\n");
 }
 
+// Вывод бенчмарка в UART (SynthBenchmark::Writer)
+static void uartWrite(const char* text) {
+    Uart::getInstance().send(text);
+}
+
 void UartTask::update() {
     processReceivedData();
+    
+    // Бенчмарк DSP: замер за вызов, пока строка результата помещается в буфер передачи
+    SynthBenchmark& bench = SynthBenchmark::getInstance();
+    if (bench.isRunning() && uart.getTxFreeSpace() >= SynthBenchmark::LINE_SIZE) {
+        bench.step(uartWrite);
+    }
 }
 
 void UartTask::processReceivedData() {
@@ -165,6 +180,13 @@ void UartTask::processReceivedData() {
                 uart.printf("h - help\n");
                 uart.printf("s - status\n");
                 uart.printf("t - tasks info\n");
+#if SYNTH_ENGINE == SYNTH_ENGINE_WAVE
+                uart.printf("x - synth self-test (render checksum)\n");
+#endif
+#if SYNTH_ENGINE == SYNTH_ENGINE_LEGACY
+                uart.printf("o - toggle output: buzzer / 1-bit mixer\n");
+#endif
+                uart.printf("b - DSP benchmark (CSV), j - DSP benchmark (JSON)\n");
                 uart.printf("save - save project\n");
                 uart.printf("load - load project\n");
                 uart.printf("play - start playback\n");
@@ -178,7 +200,7 @@ void UartTask::processReceivedData() {
                 uart.printf("BPM: %d\n", Sequencer::getInstance().getBPM());
                 uart.printf("Volume: %d\n", Sequencer::getInstance().getVolume());
                 uart.printf("Playing: %s\n", Sequencer::getInstance().isPlaying() ? "Yes" : "No");
-                uart.printf("Active voices: %d\n", Synthesizer::getInstance().getActiveVoices());
+                uart.printf("Active voices: %d\n", SynthesizerBridge::getInstance().getActiveVoices());
                 break;
                 
             case 'p':
@@ -200,6 +222,41 @@ void UartTask::processReceivedData() {
                 uart.printf("=== END TASKS INFO ===\n");
                 break;
                 
+#if SYNTH_ENGINE == SYNTH_ENGINE_WAVE
+            // Самотест есть только с WaveSynthesizer (иначе движок не попадает
+            // в прошивку). Он рендерит тот же экземпляр, что и прерывание DMA, -
+            // вывод на время теста останавливается
+            case 'x':
+            case 'X': {
+                uart.printf("\n");
+                SigmaDeltaPWM& pwm = SigmaDeltaPWM::getInstance();
+                pwm.stop();
+                SynthSelfTest::run();
+                pwm.start();
+                break;
+            }
+#endif
+                
+#if SYNTH_ENGINE == SYNTH_ENGINE_LEGACY
+            // Выбор вывода есть только у старого Synthesizer
+            case 'o':
+            case 'O': {
+                uart.printf("\n");
+                Synthesizer& synth = SynthesizerBridge::getInstance().getEngine();
+                synth.setOutput((synth.getOutput() == SynthOutput::ONE_BIT) ? SynthOutput::BUZZER : SynthOutput::ONE_BIT);
+                break;
+            }
+#endif
+                
+            case 'b':
+            case 'B':
+            case 'j':
+            case 'J':
+                uart.printf("\n");
+                SynthBenchmark::getInstance().start((data == 'j' || data == 'J') ? SynthBenchmark::Format::JSON
+                                                                                  : SynthBenchmark::Format::CSV);
+                break;
+                
             case '\r':
             case '\n':
                 uart.printf("\n> ");
@@ -221,7 +278,7 @@ void BuzzerTask::update() {
 }
 
 // Реализация SynthesizerTask
-SynthesizerTask::SynthesizerTask() : Task(50), synthesizer(Synthesizer::getInstance()) {
+SynthesizerTask::SynthesizerTask() : Task(50), synthesizer(SynthesizerBridge::getInstance()) {
 }
 
 void SynthesizerTask::onInit() {
@@ -0,0 +1,97 @@
+#include "PianoController.hpp"
+#include "synthesizer/SynthesizerBridge.hpp"
+#include "drivers/Uart.hpp"
+
+// Реализация PianoController
+PianoController& PianoController::getInstance() {
+    static PianoController instance;
+    return instance;
+}
+
+bool PianoController::init() {
+    currentOctave = 0;
+    currentChannel = 0;
+    currentInstrument = 0;
+    
+    // Инициализация состояний клавиш
+    for (uint8_t i = 0; i < KEYBOARD_KEYS; i++) {
+        keyStates[i] = false;
+    }
+    
+    // Инициализация маппинга клавиш
+    updateKeyMapping();
+    
+    return true;
+}
+
+void PianoController::onKeyPress(uint8_t keyCode) {
+    if (keyCode >= KEYBOARD_KEYS) return;
+    
+    if (!keyStates[keyCode]) {
+        keyStates[keyCode] = true;
+        uint8_t midiNote = getMidiNote(keyCode);
+        if (midiNote != INVALID_NOTE) {
+            SynthesizerBridge::getInstance().noteOn(currentChannel, midiNote, 64);
+            
+            // Отладочный вывод
+            Uart::getInstance().printf("Piano: key %d -> MIDI note %d on channel %d\n", 
+                                      keyCode, midiNote, currentChannel);
+        }
+    }
+}
+
+void PianoController::onKeyRelease(uint8_t keyCode) {
+    if (keyCode >= KEYBOARD_KEYS) return;
+    
+    if (keyStates[keyCode]) {
+        keyStates[keyCode] = false;
+        uint8_t midiNote = getMidiNote(keyCode);
+        if (midiNote != INVALID_NOTE) {
+            SynthesizerBridge::getInstance().noteOff(currentChannel, midiNote);
+        }
+    }
+}
+
+void PianoController::setOctave(int8_t octave) {
+    if (octave >= -2 && octave <= 2) {
+        currentOctave = octave;
+        updateKeyMapping();
+    }
+}
+
+void PianoController::setChannel(uint8_t channel) {
+    if (channel < SelectedSynthEngine::MAX_CHANNELS) {
+        currentChannel = channel;
+    }
+}
+
+void PianoController::setInstrument(uint8_t instrument) {
+    currentInstrument = instrument;
+}
+
+uint8_t PianoController::getMidiNote(uint8_t keyCode) const {
+    if (keyCode >= KEYBOARD_KEYS) return INVALID_NOTE;
+    
+    uint8_t baseNote = keyToNote[keyCode];
+    if (baseNote == INVALID_NOTE) return INVALID_NOTE;
+    
+    // Применяем октаву
+    int8_t midiNote = baseNote + (currentOctave + 4) * 12;
+    
+    // Проверяем диапазон MIDI (0-127)
+    if (midiNote < 0 || midiNote > 127) return INVALID_NOTE;
+    
+    return (uint8_t)midiNote;
+}
+
+void PianoController::updateKeyMapping() {
+    // Маппинг клавиш 0-15 на ноты C4-C5 (60-72)
+    // Клавиши: 0=C, 1=C#, 2=D, 3=D#, 4=E, 5=F, 6=F#, 7=G, 8=G#, 9=A, 10=A#, 11=B, 12=C, 13=C#, 14=D, 15=D#
+    uint8_t baseNotes[KEYBOARD_KEYS] = {
+        60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75
+    };
+    
+    for (uint8_t i = 0; i < KEYBOARD_KEYS; i++) {
+        keyToNote[i] = baseNotes[i];
+    }
+}
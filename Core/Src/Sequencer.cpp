@@ -1,18 +1,43 @@
 #include "Sequencer.hpp"
-#include "drivers/Synthesizer.hpp"
+#include "synthesizer/SynthesizerBridge.hpp"
 #include "drivers/Display.hpp"
 #include "drivers/Uart.hpp"
 #include <algorithm>
 #include "stm32f4xx_hal.h"
 
+// Вывод по умолчанию - в движок, выбранный SYNTH_ENGINE
+static void synthNoteOn(uint8_t channel, uint8_t note, uint8_t velocity) {
+    SynthesizerBridge::getInstance().noteOn(channel, note, velocity);
+}
+
+static void synthNoteOff(uint8_t channel, uint8_t note) {
+    SynthesizerBridge::getInstance().noteOff(channel, note);
+}
+
+static void synthPlayDrum(DrumPreset preset, uint8_t velocity) {
+    SynthesizerBridge::getInstance().playDrum(preset, velocity);
+}
+
+static void synthAllNotesOff() {
+    SynthesizerBridge::getInstance().allNotesOff();
+}
+
 Sequencer& Sequencer::getInstance() {
     static Sequencer instance;
     return instance;
 }
 
+Sequencer::Sequencer() : lastUpdateTime(0), lastNoteOffTime(0) {
+    output.noteOn = synthNoteOn;
+    output.noteOff = synthNoteOff;
+    output.playDrum = synthPlayDrum;
+    output.allNotesOff = synthAllNotesOff;
+}
+
 bool Sequencer::init() {
     project = Project();
     lastUpdateTime = 0;
+    lastNoteOffTime = 0;
     
     // Добавляем тестовые данные для проверки
     Uart::getInstance().printf("Initializing Sequencer with test data\n");
@@ -49,7 +74,7 @@ void Sequencer::stop() {
     project.currentBeat = 0;
     
     // Остановить все звуки
-    Synthesizer::getInstance().allNotesOff();
+    output.allNotesOff();
     
     // Сбросить все дорожки
     for (int i = 0; i < MAX_TRACKS; i++) {
@@ -62,11 +87,12 @@ void Sequencer::pause() {
 }
 
 void Sequencer::setBPM(uint16_t bpm) {
-    project.bpm = std::max(MIN_BPM, std::min(MAX_BPM, bpm));
+    // Копии констант: std::max/min берут ссылки, а определений вне класса нет
+    project.bpm = std::max((uint16_t)MIN_BPM, std::min((uint16_t)MAX_BPM, bpm));
 }
 
 void Sequencer::setVolume(uint8_t volume) {
-    project.volume = std::min(MAX_VOLUME, volume);
+    project.volume = std::min((uint8_t)MAX_VOLUME, volume);
 }
 
 Track& Sequencer::getTrack(uint8_t trackIndex) {
@@ -158,10 +184,9 @@ void Sequencer::processDrumTrack(uint8_t trackIndex, const Beat& beat) {
     if (!beat.active) return;
     
     Track& track = project.tracks[trackIndex];
-    Synthesizer& synth = Synthesizer::getInstance();
     
     // Играем барабанный звук
-    synth.playDrum(track.drumType, project.volume * 12); // Масштабируем громкость
+    output.playDrum(track.drumType, project.volume * 12); // Масштабируем громкость
     
     // Отладочный вывод
     Uart::getInstance().printf("Drum track %d: drum type %d, volume %d\n", 
@@ -171,11 +196,10 @@ void Sequencer::processDrumTrack(uint8_t trackIndex, const Beat& beat) {
 void Sequencer::processPianoTrack(uint8_t trackIndex, const Beat& beat) {
     if (beat.note == 255) return; // Нет ноты
     
-    Synthesizer& synth = Synthesizer::getInstance();
     uint8_t midiNote = getMidiNote(beat.note, beat.halfTone);
     
     // Играем ноту на канале дорожки
-    synth.noteOn(trackIndex, midiNote, project.volume * 12);
+    output.noteOn(trackIndex, midiNote, project.volume * 12);
     
     // Отладочный вывод
     Uart::getInstance().printf("Piano track %d: note %d, midi %d, volume %d\n", 
@@ -185,11 +209,10 @@ void Sequencer::processPianoTrack(uint8_t trackIndex, const Beat& beat) {
     // (это будет обработано в следующем update)
     
     // Автоматически останавливаем ноту через короткое время
-    static uint32_t lastNoteTime = 0;
     uint32_t currentTime = HAL_GetTick();
-    if (currentTime - lastNoteTime > 100) { // 100мс задержка
-        synth.noteOff(trackIndex, midiNote);
-        lastNoteTime = currentTime;
+    if (currentTime - lastNoteOffTime > 100) { // 100мс задержка
+        output.noteOff(trackIndex, midiNote);
+        lastNoteOffTime = currentTime;
     }
 }
 
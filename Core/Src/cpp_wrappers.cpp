@@ -1,6 +1,7 @@
 #include "cpp_wrappers.h"
 #include "scheduler/Scheduler.hpp"
 #include "drivers/Uart.hpp"
+#include "drivers/Buzzer.hpp"
 
 // C wrapper functions for C++ classes
 // These functions provide C-compatible interfaces to C++ objects
@@ -18,4 +19,9 @@ void uart_process_tx_buffer(void) {
     Uart::getInstance().processTxBuffer();
 }
 
+// Buzzer wrapper functions
+void buzzer_on_timer_tick(void) {
+    Buzzer::getInstance().onTimerTick();
+}
+
 } // extern "C"
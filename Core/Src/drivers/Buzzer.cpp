@@ -1,5 +1,5 @@
 #include "drivers/Buzzer.hpp"
-#include "drivers/Uart.hpp"
+#include "synthesizer/NoteTable.hpp"
 #include "tim.h"
 #include "stm32f4xx_hal.h"
 
@@ -18,8 +18,19 @@ bool Buzzer::init() {
     }
     
     globalVolume = MAX_VOLUME;
+    timerOwned = true;
+    setArpeggioRate(DEFAULT_ARPEGGIO_RATE);
     
-    // Запуск таймера
+    // Теневые ARR и CCR1: запись вступает в силу по событию обновления
+    TIM1->CR1 |= TIM_CR1_ARPE;
+    TIM1->CCMR1 |= TIM_CCMR1_OC1PE;
+    
+    // Тишина, UG сразу переносит значения в рабочие регистры
+    appliedValid = false;
+    applySetting(TimerSetting());
+    TIM1->EGR = TIM_EGR_UG;
+    
+    // Таймер работает постоянно, дальше меняются только PSC/ARR/CCR1
     HAL_TIM_PWM_Start(&htim1, TIM_CHANNEL_1);
     
     return true;
@@ -28,12 +39,28 @@ bool Buzzer::init() {
 void Buzzer::playNote(uint8_t channel, uint16_t frequency, uint8_t volume) {
     if (channel >= MAX_CHANNELS) return;
     
-    Uart::getInstance().printf("Buzzer::playNote: ch=%d, freq=%d, vol=%d\n", 
-                              channel, frequency, volume);
+    Channel& ch = channels[channel];
+    if (frequency != ch.frequency) {
+        uint16_t prescaler, reload;
+        calculateTiming(frequency, prescaler, reload);
+        ch.timing = packTiming(prescaler, reload);
+        ch.frequency = frequency;
+    }
+    ch.volume = (volume > MAX_VOLUME) ? MAX_VOLUME : volume;
+    // За пределами слышимого - тишина
+    ch.sounding = (frequency > 0 && frequency < 20000) ? ch.timing : 0;
     
-    channels[channel].frequency = frequency;
-    channels[channel].volume = (volume > MAX_VOLUME) ? MAX_VOLUME : volume;
-    channels[channel].active = (frequency > 0);
+    updatePWM();
+}
+
+void Buzzer::playMidiNote(uint8_t channel, uint8_t note, uint8_t volume) {
+    if (channel >= MAX_CHANNELS) return;
+    
+    Channel& ch = channels[channel];
+    ch.frequency = NoteTable::frequency(note);
+    ch.timing = packTiming(NoteTable::timerPrescaler(note), NoteTable::timerReload(note));
+    ch.volume = (volume > MAX_VOLUME) ? MAX_VOLUME : volume;
+    ch.sounding = ch.timing;
     
     updatePWM();
 }
@@ -41,8 +68,7 @@ void Buzzer::playNote(uint8_t channel, uint16_t frequency, uint8_t volume) {
 void Buzzer::stopNote(uint8_t channel) {
     if (channel >= MAX_CHANNELS) return;
     
-    channels[channel].active = false;
-    channels[channel].frequency = 0;
+    channels[channel].sounding = 0;
     channels[channel].volume = 0;
     
     updatePWM();
@@ -50,8 +76,7 @@ void Buzzer::stopNote(uint8_t channel) {
 
 void Buzzer::stopAll() {
     for (uint8_t i = 0; i < MAX_CHANNELS; i++) {
-        channels[i].active = false;
-        channels[i].frequency = 0;
+        channels[i].sounding = 0;
         channels[i].volume = 0;
     }
     
@@ -86,63 +111,117 @@ void Buzzer::update() {
     melodyPlayer.update();
 }
 
+void Buzzer::setArpeggioRate(uint16_t stepsPerSecond) {
+    if (stepsPerSecond > ARPEGGIO_TICK_HZ) stepsPerSecond = ARPEGGIO_TICK_HZ;
+    ticksPerStep = stepsPerSecond ? (uint16_t)(ARPEGGIO_TICK_HZ / stepsPerSecond) : 1;
+    tickCount = 0;
+    arpeggioRate = stepsPerSecond;
+    updatePWM();
+}
+
+void Buzzer::releaseTimer() {
+    // Тик проверяет флаг первым, после возврата TIM1 не пишется. Следующий
+    // init() перезапишет регистры целиком
+    timerOwned = false;
+    appliedValid = false;
+}
+
+void Buzzer::onTimerTick() {
+    if (arpeggioRate == 0 || !timerOwned) return;
+    
+    bool advance = (++tickCount >= ticksPerStep);
+    if (advance) tickCount = 0;
+    if (!advance && !pending) return;
+    pending = false;
+    
+    // Один активный канал - тот же шаблон, applySetting ничего не пишет
+    applySetting(channelSetting(nextArpeggioChannel(advance)));
+}
+
 void Buzzer::updatePWM() {
-    // Находим активный канал с максимальной частотой
-    uint16_t maxFreq = 0;
-    uint8_t maxVolume = 0;
+    if (arpeggioRate != 0) {
+        pending = true;
+        return;
+    }
     
+    // Находим активный канал с максимальной частотой
+    const Channel* selected = nullptr;
     for (uint8_t i = 0; i < MAX_CHANNELS; i++) {
-        if (channels[i].active && channels[i].frequency > maxFreq) {
-            maxFreq = channels[i].frequency;
-            maxVolume = channels[i].volume;
+        if (channels[i].active() && (selected == nullptr || channels[i].frequency > selected->frequency)) {
+            selected = &channels[i];
         }
     }
     
-    if (maxFreq > 0 && maxFreq < 20000) { // Проверяем разумные пределы частоты
-        // Настраиваем частоту и громкость
-        // Частота = PCLK / ((PSC + 1) * (ARR + 1))
-        // Для простоты используем ARR = 1000, тогда PSC = PCLK / (freq * 1000) - 1
-        uint32_t pclk = HAL_RCC_GetPCLK1Freq();
-        uint32_t psc = (pclk / (maxFreq * 1000)) - 1;
-        
-        // Ограничиваем PSC разумными значениями
-        if (psc > 65535) psc = 65535;
-        if (psc < 1) psc = 1;
-        
-        // Останавливаем таймер перед изменением параметров
-        HAL_TIM_PWM_Stop(&htim1, TIM_CHANNEL_1);
-        
-        TIM1->PSC = psc;
-        TIM1->ARR = 1000;
-        
-        // Устанавливаем duty cycle для громкости
-        uint32_t duty = (maxVolume * globalVolume * 1000) / (MAX_VOLUME * MAX_VOLUME);
-        if (duty > 1000) duty = 1000;
-        TIM1->CCR1 = duty;
-        
-        // Запускаем таймер с новыми параметрами
-        HAL_TIM_PWM_Start(&htim1, TIM_CHANNEL_1);
-        
-        // Отладочный вывод
-        Uart::getInstance().printf("PWM: freq=%d, pclk=%lu, psc=%lu, duty=%lu\n", 
-                                  maxFreq, pclk, psc, duty);
+    applySetting(channelSetting(selected));
+}
+
+Buzzer::TimerSetting Buzzer::channelSetting(const Channel* channel) const {
+    // sounding читается один раз - PSC и ARR из одной и той же ноты
+    if (channel == nullptr) return channelSetting(0, 0);
+    return channelSetting(channel->sounding, channel->volume);
+}
+
+Buzzer::TimerSetting Buzzer::channelSetting(uint32_t timing, uint8_t volume) const {
+    TimerSetting setting;
+    if (timing != 0) {
+        setting.prescaler = (uint16_t)(timing >> 16);
+        setting.reload = (uint16_t)timing;
+        // Громкость - скважность до 50% (меандр - самый громкий для зуммера)
+        uint32_t period = (uint32_t)setting.reload + 1;
+        setting.compare = (uint16_t)(period * volume * globalVolume / (2 * MAX_VOLUME * MAX_VOLUME));
     } else {
-        // Выключаем звук
-        HAL_TIM_PWM_Stop(&htim1, TIM_CHANNEL_1);
-        TIM1->CCR1 = 0;
+        // Тишина: таймер не останавливается, выход держится в нуле
+        setting.prescaler = applied.prescaler;
+        setting.reload = applied.reload;
+        setting.compare = 0;
     }
+    return setting;
 }
 
-uint16_t Buzzer::calculatePWMValue(uint16_t frequency, uint8_t volume) {
-    if (frequency == 0) return 0;
+const Buzzer::Channel* Buzzer::nextArpeggioChannel(bool advance) {
+    // Текущий канал (или следующий по кругу при смене шага), пропуская неактивные
+    uint8_t slot = advance ? (uint8_t)((currentSlot + 1) % MAX_CHANNELS) : currentSlot;
+    for (uint8_t i = 0; i < MAX_CHANNELS; i++) {
+        uint8_t candidate = (uint8_t)((slot + i) % MAX_CHANNELS);
+        if (channels[candidate].active()) {
+            currentSlot = candidate;
+            return &channels[candidate];
+        }
+    }
+    return nullptr;
+}
+
+void Buzzer::applySetting(const TimerSetting& setting) {
+    // TIM1 ведет другой вывод - регистры не наши
+    if (!timerOwned) return;
+    
+    // Быстрый путь: ничего не изменилось - регистры не трогаем
+    if (appliedValid && setting == applied) return;
     
-    // Простое микширование - берем максимальную частоту
-    return volume;
+    // UDIS: событие обновления посреди записи не должно загрузить
+    // в рабочие регистры новый PSC со старым ARR
+    TIM1->CR1 |= TIM_CR1_UDIS;
+    TIM1->PSC = setting.prescaler;
+    TIM1->ARR = setting.reload;
+    TIM1->CCR1 = setting.compare;
+    TIM1->CR1 &= ~TIM_CR1_UDIS;
+    
+    applied = setting;
+    appliedValid = true;
 }
 
-void Buzzer::mixChannels() {
-    // Простое микширование - находим канал с максимальной частотой
-    updatePWM();
+void Buzzer::calculateTiming(uint16_t frequency, uint16_t& prescaler, uint16_t& reload) {
+    if (frequency == 0) {
+        prescaler = 0;
+        reload = 0;
+        return;
+    }
+    
+    // Такт TIM1 - PCLK2 (NOTE_TIMER_CLOCK), наименьший PSC с ARR в 16 битах
+    uint32_t period = (NOTE_TIMER_CLOCK + frequency / 2) / frequency;
+    uint32_t psc = (period - 1) >> 16;
+    prescaler = (uint16_t)psc;
+    reload = (uint16_t)((period + psc / 2) / (psc + 1) - 1);
 }
 
 // Реализация MelodyPlayer
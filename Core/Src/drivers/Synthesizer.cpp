@@ -1,7 +1,11 @@
 #include "drivers/Synthesizer.hpp"
 #include "drivers/Uart.hpp"
+#include "synthesizer/NoteTable.hpp"
+#include "synthesizer/OneBitMixer.hpp"
 #include "tim.h"
-#include <math.h>
+
+// Старый синтезатор собирается, только если выбран (SynthEngine.hpp)
+#if SYNTH_ENGINE == SYNTH_ENGINE_LEGACY
 
 // Внешние переменные из HAL
 extern TIM_HandleTypeDef htim1;
@@ -14,9 +18,7 @@ Synthesizer& Synthesizer::getInstance() {
 
 bool Synthesizer::init() {
     // Инициализация голосов
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        voices[i] = Voice();
-    }
+    voiceManager.reset();
     
     // Инициализация каналов
     for (uint8_t i = 0; i < MAX_CHANNELS; i++) {
@@ -28,46 +30,28 @@ bool Synthesizer::init() {
     chorusLevel = 0;
     
     // Инициализация Buzzer
+    output = SynthOutput::BUZZER;
     Buzzer::getInstance().init();
     
     return true;
 }
 
 void Synthesizer::noteOn(uint8_t channel, uint8_t note, uint8_t velocity) {
-    if (channel >= MAX_CHANNELS || note > 127) return;
-    
-    // АГРЕССИВНО: Отключаем ВСЕ старые голоса при новой ноте
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active) {
-            voices[i].active = false;
-            Uart::getInstance().printf("Stopping old voice %d for new note\n", i);
-        }
-    }
-    
-    // Настраиваем голос
-    Voice& voice = voices[voiceIndex];
-    voice.frequency = midiToFrequency(note);
-    voice.velocity = (velocity > MAX_VELOCITY) ? MAX_VELOCITY : velocity;
-    voice.channel = channel;
-    voice.startTime = HAL_GetTick();
-    voice.releaseTime = 0;
-    voice.active = true;
-    voice.released = false;
-    
-    // Применяем настройки ADSR по умолчанию
-    voice.adsr = ADSR(50, 100, 7, 200);
+    // Канал монофонический: новая нота заменяет голос этого канала, голоса
+    // других каналов (вторая дорожка пианино) продолжают звучать - аккорд
+    // выводится арпеджио Buzzer
+    uint8_t voiceIndex = voiceManager.noteOn(channel, note, velocity);
+    if (voiceIndex == Voices::NO_VOICE) return;
     
     // Отладочный вывод
+    const Voice& voice = voiceManager.voice(voiceIndex);
     Uart::getInstance().printf("MIDI: noteOn ch=%d, note=%d, freq=%d, vel=%d, voice=%d\n", 
                               channel, note, voice.frequency, voice.velocity, voiceIndex);
 }
 
 void Synthesizer::noteOff(uint8_t channel, uint8_t note) {
-    uint8_t voiceIndex = findVoice(channel, note);
-    if (voiceIndex < MAX_VOICES) {
-        voices[voiceIndex].released = true;
-        voices[voiceIndex].releaseTime = HAL_GetTick();
-        
+    uint8_t voiceIndex = voiceManager.noteOff(channel, note);
+    if (voiceIndex != Voices::NO_VOICE) {
         Uart::getInstance().printf("MIDI: noteOff ch=%d, note=%d, voice=%d\n", 
                                   channel, note, voiceIndex);
     } else {
@@ -77,52 +61,29 @@ void Synthesizer::noteOff(uint8_t channel, uint8_t note) {
 }
 
 void Synthesizer::allNotesOff() {
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        voices[i].active = false;
-        voices[i].released = false;
-    }
-    Buzzer::getInstance().stopAll();
+    voiceManager.allNotesOff();
+    stopOutput();
 }
 
 void Synthesizer::setADSR(uint8_t channel, const ADSR& adsr) {
     // Применяем ADSR ко всем активным голосам канала
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active && voices[i].channel == channel) {
-            voices[i].adsr = adsr;
-        }
-    }
+    voiceManager.setADSR(channel, adsr);
 }
 
 void Synthesizer::setAttack(uint8_t channel, uint16_t attack) {
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active && voices[i].channel == channel) {
-            voices[i].adsr.attack = attack;
-        }
-    }
+    voiceManager.setAttack(channel, attack);
 }
 
 void Synthesizer::setDecay(uint8_t channel, uint16_t decay) {
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active && voices[i].channel == channel) {
-            voices[i].adsr.decay = decay;
-        }
-    }
+    voiceManager.setDecay(channel, decay);
 }
 
 void Synthesizer::setSustain(uint8_t channel, uint8_t sustain) {
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active && voices[i].channel == channel) {
-            voices[i].adsr.sustain = (sustain > MAX_VOLUME) ? MAX_VOLUME : sustain;
-        }
-    }
+    voiceManager.setSustain(channel, sustain);
 }
 
 void Synthesizer::setRelease(uint8_t channel, uint16_t release) {
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active && voices[i].channel == channel) {
-            voices[i].adsr.release = release;
-        }
-    }
+    voiceManager.setRelease(channel, release);
 }
 
 void Synthesizer::playDrum(DrumPreset preset, uint8_t velocity) {
@@ -158,97 +119,63 @@ void Synthesizer::setChorus(uint8_t level) {
     chorusLevel = (level > MAX_VOLUME) ? MAX_VOLUME : level;
 }
 
-void Synthesizer::update() {
-    // Обновляем все активные голоса
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active) {
-            updateVoice(voices[i]);
-        }
+void Synthesizer::setOutput(SynthOutput newOutput) {
+    if (newOutput == output) return;
+    
+    // Оба вывода настраивают TIM1 под себя: старый останавливается,
+    // новый инициализируется заново
+    stopOutput();
+    if (newOutput == SynthOutput::ONE_BIT) {
+        // Buzzer (арпеджио из TIM6, MelodyPlayer, playNote из задач) больше
+        // не пишет в TIM1, пока CCR1 ведет DMA микшера
+        Buzzer::getInstance().releaseTimer();
+        OneBitMixer& mixer = OneBitMixer::getInstance();
+        mixer.init();
+        mixer.start();
+    } else {
+        OneBitMixer::getInstance().stop();
+        Buzzer::getInstance().init();
     }
+    output = newOutput;
+    
+    Uart::getInstance().printf("Synthesizer output: %s\n", (output == SynthOutput::ONE_BIT) ? "1-bit mixer" : "buzzer");
+}
+
+void Synthesizer::update() {
+    // Обновляем все активные голоса, завершившие релиз возвращаются распределителю
+    voiceManager.forEachActive([this](Voice& voice) { updateVoice(voice); });
+    voiceManager.releaseFinished();
     
     // Микшируем голоса
     mixVoices();
 }
 
 uint8_t Synthesizer::getActiveVoices() const {
-    uint8_t count = 0;
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active) count++;
-    }
-    return count;
+    return voiceManager.getActiveCount();
 }
 
 bool Synthesizer::isChannelActive(uint8_t channel) const {
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active && voices[i].channel == channel) {
-            return true;
-        }
-    }
-    return false;
+    return voiceManager.isChannelActive(channel);
 }
 
-uint8_t Synthesizer::findFreeVoice() const {
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (!voices[i].active) {
-            return i;
-        }
-    }
-    return MAX_VOICES; // Нет свободных голосов
+void Synthesizer::startVoice(Voice& voice) {
+    voice.frequency = NoteTable::frequency(voice.note);
+    voice.startTime = HAL_GetTick();
+    voice.releaseTime = 0;
 }
 
-uint8_t Synthesizer::findVoice(uint8_t channel, uint8_t note) const {
-    uint16_t frequency = midiToFrequency(note);
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active && voices[i].channel == channel && voices[i].frequency == frequency) {
-            return i;
-        }
-    }
-    return MAX_VOICES; // Голос не найден
+void Synthesizer::releaseVoice(Voice& voice) {
+    voice.releaseTime = HAL_GetTick();
 }
 
-uint16_t Synthesizer::midiToFrequency(uint8_t note) const {
-    // A4 = 440 Hz, MIDI note 69
-    if (note == 0) return 0;
-    
-    // Формула: f = 440 * 2^((note - 69) / 12)
-    float frequency = 440.0f * powf(2.0f, (note - 69) / 12.0f);
-    return (uint16_t)frequency;
+float Synthesizer::voiceLevel(const Voice& voice) const {
+    return Voices::timedLevel(voice, HAL_GetTick());
 }
 
 uint8_t Synthesizer::calculateVolume(const Voice& voice) const {
-    uint32_t currentTime = HAL_GetTick();
-    uint32_t elapsed = currentTime - voice.startTime;
-    
-    uint8_t baseVolume = (voice.velocity * MAX_VOLUME) / MAX_VELOCITY;
-    uint8_t adsrVolume = baseVolume;
-    
-    if (voice.released) {
-        // Фаза Release
-        uint32_t releaseElapsed = currentTime - voice.releaseTime;
-        if (releaseElapsed >= voice.adsr.release) {
-            return 0; // Голос должен быть отключен
-        }
-        // Линейное затухание в фазе Release
-        adsrVolume = (voice.adsr.sustain * (voice.adsr.release - releaseElapsed)) / voice.adsr.release;
-    } else {
-        // Фазы Attack, Decay, Sustain
-        if (elapsed < voice.adsr.attack) {
-            // Фаза Attack
-            adsrVolume = (baseVolume * elapsed) / voice.adsr.attack;
-        } else if (elapsed < voice.adsr.attack + voice.adsr.decay) {
-            // Фаза Decay
-            uint32_t decayElapsed = elapsed - voice.adsr.attack;
-            adsrVolume = baseVolume - ((baseVolume - voice.adsr.sustain) * decayElapsed) / voice.adsr.decay;
-        } else {
-            // Фаза Sustain
-            adsrVolume = voice.adsr.sustain;
-        }
-    }
-    
-    // Применяем громкость канала и мастер-громкость
-    adsrVolume = (adsrVolume * channelVolumes[voice.channel] * masterVolume) / (MAX_VOLUME * MAX_VOLUME);
-    
-    return adsrVolume;
+    // Огибающая (0.0 - 1.0) с громкостью канала и мастер-громкостью, шкала 0-10
+    float level = voiceLevel(voice) * channelVolumes[voice.channel] * masterVolume / MAX_VOLUME;
+    return (uint8_t)(level + 0.5f);
 }
 
 void Synthesizer::updateVoice(Voice& voice) {
@@ -265,38 +192,51 @@ void Synthesizer::updateVoice(Voice& voice) {
 }
 
 void Synthesizer::mixVoices() {
-    // Полифоническое микширование - находим самый громкий активный голос
-    uint16_t mixedFreq = 0;
-    uint8_t mixedVolume = 0;
-    uint8_t activeVoices = 0;
-    uint8_t loudestVoice = 0;
-    uint8_t maxVolume = 0;
+    if (output == SynthOutput::ONE_BIT) {
+        mixVoicesOneBit();
+        return;
+    }
+    
+    // Полифоническое микширование: звучащие голоса по порядку занимают каналы
+    // Buzzer (до Buzzer::MAX_CHANNELS), Buzzer чередует их арпеджио.
+    // Порядок голосов стабилен - канал голоса не меняется между обновлениями
+    Buzzer& buzzer = Buzzer::getInstance();
+    uint8_t buzzerChannel = 0;
     
-    // Находим самый громкий активный голос
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active) {
-            uint8_t volume = calculateVolume(voices[i]);
+    for (uint8_t i = 0; i < MAX_VOICES && buzzerChannel < Buzzer::MAX_CHANNELS; i++) {
+        const Voice& voice = voiceManager.voice(i);
+        if (voice.active) {
+            uint8_t volume = calculateVolume(voice);
             if (volume > 0) {
-                activeVoices++;
-                if (volume > maxVolume) {
-                    maxVolume = volume;
-                    loudestVoice = i;
-                    mixedFreq = voices[i].frequency;
-                    mixedVolume = volume;
-                }
+                buzzer.playMidiNote(buzzerChannel++, voice.note, volume);
             }
         }
     }
     
-    // Отладочный вывод
-    if (activeVoices > 0) {
-        Uart::getInstance().printf("mixVoices: %d active voices, loudest=%d, freq=%d, vol=%d\n", 
-                                  activeVoices, loudestVoice, mixedFreq, mixedVolume);
+    // Остальные каналы молчат
+    for (; buzzerChannel < Buzzer::MAX_CHANNELS; buzzerChannel++) {
+        buzzer.stopNote(buzzerChannel);
     }
-    
-    // Обновляем Buzzer только если есть активные голоса
-    if (activeVoices > 0 && mixedFreq > 0 && mixedVolume > 0) {
-        Buzzer::getInstance().playNote(0, mixedFreq, mixedVolume);
+}
+
+void Synthesizer::mixVoicesOneBit() {
+    // Голос i - голос i микшера: звучат все сразу, огибающая - громкостью
+    // импульса, фаза голоса микшера между обновлениями не сбрасывается
+    OneBitMixer& mixer = OneBitMixer::getInstance();
+    for (uint8_t i = 0; i < MAX_VOICES && i < OneBitMixer::MAX_VOICES; i++) {
+        const Voice& voice = voiceManager.voice(i);
+        uint8_t volume = voice.active ? calculateVolume(voice) : 0;
+        if (volume > 0) {
+            mixer.playMidiNote(i, voice.note, volume);
+        } else {
+            mixer.stopNote(i);
+        }
+    }
+}
+
+void Synthesizer::stopOutput() {
+    if (output == SynthOutput::ONE_BIT) {
+        OneBitMixer::getInstance().stopAll();
     } else {
         Buzzer::getInstance().stopAll();
     }
@@ -307,15 +247,17 @@ void Synthesizer::generateDrumSound(const DrumSound& sound) {
                               sound.frequency, sound.volume, sound.isNoise);
     
     // АГРЕССИВНО: Отключаем ВСЕ голоса для барабанного звука
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active) {
-            voices[i].active = false;
-            Uart::getInstance().printf("Stopping voice %d for drum sound\n", i);
-        }
+    if (voiceManager.getActiveCount() > 0) {
+        Uart::getInstance().printf("Stopping %d voices for drum sound\n", voiceManager.getActiveCount());
+        voiceManager.allNotesOff();
     }
     
     // ПРИНУДИТЕЛЬНО играем барабанный звук
-    Buzzer::getInstance().playNote(0, sound.frequency, sound.volume);
+    if (output == SynthOutput::ONE_BIT) {
+        OneBitMixer::getInstance().playNote(0, sound.frequency, sound.volume);
+    } else {
+        Buzzer::getInstance().playNote(0, sound.frequency, sound.volume);
+    }
     Uart::getInstance().printf("FORCED Drum sound: freq=%d, vol=%d\n", sound.frequency, sound.volume);
 }
 
@@ -342,96 +284,4 @@ DrumSound Synthesizer::getDrumPreset(DrumPreset preset) const {
     }
 }
 
-// Реализация PianoController
-PianoController& PianoController::getInstance() {
-    static PianoController instance;
-    return instance;
-}
-
-bool PianoController::init() {
-    currentOctave = 0;
-    currentChannel = 0;
-    currentInstrument = 0;
-    
-    // Инициализация состояний клавиш
-    for (uint8_t i = 0; i < KEYBOARD_KEYS; i++) {
-        keyStates[i] = false;
-    }
-    
-    // Инициализация маппинга клавиш
-    updateKeyMapping();
-    
-    return true;
-}
-
-void PianoController::onKeyPress(uint8_t keyCode) {
-    if (keyCode >= KEYBOARD_KEYS) return;
-    
-    if (!keyStates[keyCode]) {
-        keyStates[keyCode] = true;
-        uint8_t midiNote = getMidiNote(keyCode);
-        if (midiNote != INVALID_NOTE) {
-            Synthesizer::getInstance().noteOn(currentChannel, midiNote, 64);
-            
-            // Отладочный вывод
-            Uart::getInstance().printf("Piano: key %d -> MIDI note %d on channel %d\n", 
-                                      keyCode, midiNote, currentChannel);
-        }
-    }
-}
-
-void PianoController::onKeyRelease(uint8_t keyCode) {
-    if (keyCode >= KEYBOARD_KEYS) return;
-    
-    if (keyStates[keyCode]) {
-        keyStates[keyCode] = false;
-        uint8_t midiNote = getMidiNote(keyCode);
-        if (midiNote != INVALID_NOTE) {
-            Synthesizer::getInstance().noteOff(currentChannel, midiNote);
-        }
-    }
-}
-
-void PianoController::setOctave(int8_t octave) {
-    if (octave >= -2 && octave <= 2) {
-        currentOctave = octave;
-        updateKeyMapping();
-    }
-}
-
-void PianoController::setChannel(uint8_t channel) {
-    if (channel < Synthesizer::MAX_CHANNELS) {
-        currentChannel = channel;
-    }
-}
-
-void PianoController::setInstrument(uint8_t instrument) {
-    currentInstrument = instrument;
-}
-
-uint8_t PianoController::getMidiNote(uint8_t keyCode) const {
-    if (keyCode >= KEYBOARD_KEYS) return INVALID_NOTE;
-    
-    uint8_t baseNote = keyToNote[keyCode];
-    if (baseNote == INVALID_NOTE) return INVALID_NOTE;
-    
-    // Применяем октаву
-    int8_t midiNote = baseNote + (currentOctave + 4) * 12;
-    
-    // Проверяем диапазон MIDI (0-127)
-    if (midiNote < 0 || midiNote > 127) return INVALID_NOTE;
-    
-    return (uint8_t)midiNote;
-}
-
-void PianoController::updateKeyMapping() {
-    // Маппинг клавиш 0-15 на ноты C4-C5 (60-72)
-    // Клавиши: 0=C, 1=C#, 2=D, 3=D#, 4=E, 5=F, 6=F#, 7=G, 8=G#, 9=A, 10=A#, 11=B, 12=C, 13=C#, 14=D, 15=D#
-    uint8_t baseNotes[KEYBOARD_KEYS] = {
-        60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75
-    };
-    
-    for (uint8_t i = 0; i < KEYBOARD_KEYS; i++) {
-        keyToNote[i] = baseNotes[i];
-    }
-}
+#endif // SYNTH_ENGINE == SYNTH_ENGINE_LEGACY
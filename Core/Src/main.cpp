@@ -37,7 +37,7 @@
 #include "drivers/Display.hpp"
 #include "drivers/Keyboard.hpp"
 #include "drivers/Buzzer.hpp"
-#include "drivers/Synthesizer.hpp"
+#include "synthesizer/SynthesizerBridge.hpp"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -114,7 +114,6 @@ int main(void)
   Display::getInstance().init();
   Keyboard::getInstance().init();
   Buzzer::getInstance().init();
-  Synthesizer::getInstance().init();
   
   // Тестирование зуделки перед запуском шедулера
   Uart::getInstance().printf("=== BUZZER TEST START ===\n");
@@ -154,21 +153,30 @@ int main(void)
   }
   
   Uart::getInstance().printf("Test melody completed\n");
+  
+  // Движок - после теста зуделки: с SYNTH_ENGINE_WAVE init() отдает TIM1
+  // сигма-дельта выводу (DMA), прямые записи таймера выше его бы сбили.
+  // Buzzer (мелодии, команды из задач) с этого момента TIM1 не трогает
+#if SYNTH_ENGINE == SYNTH_ENGINE_WAVE
+  Buzzer::getInstance().releaseTimer();
+#endif
+  SynthesizerBridge::getInstance().init();
+  
   // Тест синтезатора
   Uart::getInstance().printf("Testing synthesizer...\n");
-  Synthesizer::getInstance().noteOn(0, 60, 64);  // MIDI note 60 (C4)
+  SynthesizerBridge::getInstance().noteOn(0, 60, 64);  // MIDI note 60 (C4)
   HAL_Delay(1000);
-  Synthesizer::getInstance().noteOff(0, 60);
+  SynthesizerBridge::getInstance().noteOff(0, 60);
   HAL_Delay(200);
   
-  Synthesizer::getInstance().noteOn(0, 64, 64);  // MIDI note 64 (E4)
+  SynthesizerBridge::getInstance().noteOn(0, 64, 64);  // MIDI note 64 (E4)
   HAL_Delay(1000);
-  Synthesizer::getInstance().noteOff(0, 64);
+  SynthesizerBridge::getInstance().noteOff(0, 64);
   HAL_Delay(200);
   
-  Synthesizer::getInstance().noteOn(0, 67, 64);  // MIDI note 67 (G4)
+  SynthesizerBridge::getInstance().noteOn(0, 67, 64);  // MIDI note 67 (G4)
   HAL_Delay(1000);
-  Synthesizer::getInstance().allNotesOff();
+  SynthesizerBridge::getInstance().allNotesOff();
   
   Uart::getInstance().printf("Synthesizer test completed\n");
   Uart::getInstance().printf("=== BUZZER TEST END ===\n");
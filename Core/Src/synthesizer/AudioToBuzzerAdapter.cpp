@@ -1,7 +1,10 @@
 #include "synthesizer/AudioToBuzzerAdapter.hpp"
 #include "drivers/Uart.hpp"
+#include "synthesizer/NoteTable.hpp"
 #include "tim.h"
-#include <math.h>
+
+// Адаптер собирается, только если выбран (SynthEngine.hpp)
+#if SYNTH_ENGINE == SYNTH_ENGINE_BUZZER_ADAPTER
 
 // Реализация AudioToBuzzerAdapter
 AudioToBuzzerAdapter& AudioToBuzzerAdapter::getInstance() {
@@ -11,9 +14,7 @@ AudioToBuzzerAdapter& AudioToBuzzerAdapter::getInstance() {
 
 bool AudioToBuzzerAdapter::init() {
     // Инициализация голосов
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        voices[i] = Voice();
-    }
+    voiceManager.reset();
     
     // Инициализация каналов
     for (uint8_t i = 0; i < MAX_CHANNELS; i++) {
@@ -23,7 +24,6 @@ bool AudioToBuzzerAdapter::init() {
     masterVolume = MAX_VOLUME;
     
     // Инициализация Buzzer
-    buzzer = Buzzer::getInstance();
     buzzer.init();
     
     Uart::getInstance().printf("AudioToBuzzerAdapter initialized\n");
@@ -37,39 +37,11 @@ void AudioToBuzzerAdapter::processAudioSignal(float audioSample) {
 }
 
 void AudioToBuzzerAdapter::noteOn(uint8_t channel, uint8_t note, uint8_t velocity) {
-    if (channel >= MAX_CHANNELS || note > 127) return;
-    
-    // Ищем свободный голос
-    uint8_t voiceIndex = findFreeVoice();
-    if (voiceIndex >= MAX_VOICES) {
-        // Если нет свободных голосов, освобождаем самый старый
-        voiceIndex = 0;
-        uint32_t oldestTime = voices[0].startTime;
-        for (uint8_t i = 1; i < MAX_VOICES; i++) {
-            if (voices[i].startTime < oldestTime) {
-                oldestTime = voices[i].startTime;
-                voiceIndex = i;
-            }
-        }
-        Uart::getInstance().printf("No free voices, using oldest voice %d\n", voiceIndex);
-    }
-    
-    // Настраиваем голос
-    Voice& voice = voices[voiceIndex];
-    voice.frequency = midiToFrequency(note);
-    voice.velocity = (velocity > MAX_VELOCITY) ? MAX_VELOCITY : velocity;
-    voice.channel = channel;
-    voice.startTime = HAL_GetTick();
-    voice.releaseTime = 0;
-    voice.active = true;
-    voice.released = false;
-    voice.waveType = WaveType::SINE;
-    voice.phase = 0.0f;
-    voice.phaseIncrement = (2.0f * M_PI * voice.frequency) / 44100.0f;
-    
-    // Применяем настройки ADSR по умолчанию
-    voice.adsr = ADSR(50, 100, 7, 200);
+    // Без свободных голосов VoiceManager крадет голос (сначала отпущенные)
+    uint8_t voiceIndex = voiceManager.noteOn(channel, note, velocity);
+    if (voiceIndex == Voices::NO_VOICE) return;
     
+    const Voice& voice = voiceManager.voice(voiceIndex);
     Uart::getInstance().printf("AudioToBuzzer: noteOn ch=%d, note=%d, freq=%d, vel=%d, voice=%d\n", 
                               channel, note, voice.frequency, voice.velocity, voiceIndex);
     
@@ -78,11 +50,8 @@ void AudioToBuzzerAdapter::noteOn(uint8_t channel, uint8_t note, uint8_t velocit
 }
 
 void AudioToBuzzerAdapter::noteOff(uint8_t channel, uint8_t note) {
-    uint8_t voiceIndex = findVoice(channel, note);
-    if (voiceIndex < MAX_VOICES) {
-        voices[voiceIndex].released = true;
-        voices[voiceIndex].releaseTime = HAL_GetTick();
-        
+    uint8_t voiceIndex = voiceManager.noteOff(channel, note);
+    if (voiceIndex != Voices::NO_VOICE) {
         Uart::getInstance().printf("AudioToBuzzer: noteOff ch=%d, note=%d, voice=%d\n", 
                                   channel, note, voiceIndex);
     }
@@ -92,27 +61,16 @@ void AudioToBuzzerAdapter::noteOff(uint8_t channel, uint8_t note) {
 }
 
 void AudioToBuzzerAdapter::allNotesOff() {
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        voices[i].active = false;
-        voices[i].released = false;
-    }
+    voiceManager.allNotesOff();
     buzzer.stopAll();
 }
 
 void AudioToBuzzerAdapter::setWaveType(uint8_t channel, WaveType type) {
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active && voices[i].channel == channel) {
-            voices[i].waveType = type;
-        }
-    }
+    voiceManager.forChannel(channel, [type](Voice& v) { v.waveType = type; });
 }
 
 void AudioToBuzzerAdapter::setADSR(uint8_t channel, const ADSR& adsr) {
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active && voices[i].channel == channel) {
-            voices[i].adsr = adsr;
-        }
-    }
+    voiceManager.setADSR(channel, adsr);
 }
 
 void AudioToBuzzerAdapter::setMasterVolume(uint8_t volume) {
@@ -126,97 +84,47 @@ void AudioToBuzzerAdapter::setChannelVolume(uint8_t channel, uint8_t volume) {
 }
 
 void AudioToBuzzerAdapter::update() {
-    // Обновляем все активные голоса
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active) {
-            updateVoice(voices[i]);
-        }
-    }
+    // Обновляем все активные голоса, завершившие релиз возвращаются распределителю
+    voiceManager.forEachActive([this](Voice& voice) { updateVoice(voice); });
+    voiceManager.releaseFinished();
     
     // Выбираем лучший голос для воспроизведения
     selectBestVoice();
 }
 
 uint8_t AudioToBuzzerAdapter::getActiveVoices() const {
-    uint8_t count = 0;
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active) count++;
-    }
-    return count;
+    return voiceManager.getActiveCount();
 }
 
 bool AudioToBuzzerAdapter::isChannelActive(uint8_t channel) const {
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active && voices[i].channel == channel) {
-            return true;
-        }
-    }
-    return false;
+    return voiceManager.isChannelActive(channel);
 }
 
-uint8_t AudioToBuzzerAdapter::findFreeVoice() const {
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (!voices[i].active) {
-            return i;
-        }
-    }
-    return MAX_VOICES;
+void AudioToBuzzerAdapter::startVoice(Voice& voice) {
+    voice.frequency = NoteTable::frequency(voice.note);
+    voice.startTime = HAL_GetTick();
+    voice.releaseTime = 0;
+    voice.waveType = WaveType::SINE;
+    voice.phase = 0;
+    voice.phaseIncrement = NoteTable::phaseIncrement(voice.note);
 }
 
-uint8_t AudioToBuzzerAdapter::findVoice(uint8_t channel, uint8_t note) const {
-    uint16_t frequency = midiToFrequency(note);
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active && voices[i].channel == channel && voices[i].frequency == frequency) {
-            return i;
-        }
-    }
-    return MAX_VOICES;
+void AudioToBuzzerAdapter::releaseVoice(Voice& voice) {
+    voice.releaseTime = HAL_GetTick();
 }
 
-uint16_t AudioToBuzzerAdapter::midiToFrequency(uint8_t note) const {
-    if (note == 0) return 0;
-    float frequency = 440.0f * powf(2.0f, (note - 69) / 12.0f);
-    return (uint16_t)frequency;
+float AudioToBuzzerAdapter::voiceLevel(const Voice& voice) const {
+    return Voices::timedLevel(voice, HAL_GetTick());
 }
 
 float AudioToBuzzerAdapter::calculateADSRVolume(const Voice& voice) const {
-    uint32_t currentTime = HAL_GetTick();
-    uint32_t elapsed = currentTime - voice.startTime;
-    
-    float baseVolume = (float)voice.velocity / 127.0f;
-    float adsrVolume = baseVolume;
-    
-    if (voice.released) {
-        // Фаза Release
-        uint32_t releaseElapsed = currentTime - voice.releaseTime;
-        if (releaseElapsed >= voice.adsr.release) {
-            return 0.0f;
-        }
-        adsrVolume = baseVolume * ((float)voice.adsr.sustain / 10.0f) * 
-                     (1.0f - (float)releaseElapsed / voice.adsr.release);
-    } else {
-        // Фазы Attack, Decay, Sustain
-        if (elapsed < voice.adsr.attack) {
-            adsrVolume = baseVolume * ((float)elapsed / voice.adsr.attack);
-        } else if (elapsed < voice.adsr.attack + voice.adsr.decay) {
-            uint32_t decayElapsed = elapsed - voice.adsr.attack;
-            float sustainLevel = (float)voice.adsr.sustain / 10.0f;
-            adsrVolume = baseVolume - (baseVolume - sustainLevel) * 
-                        ((float)decayElapsed / voice.adsr.decay);
-        } else {
-            adsrVolume = baseVolume * ((float)voice.adsr.sustain / 10.0f);
-        }
-    }
-    
-    return adsrVolume;
+    // Огибающая с громкостью канала и мастер-громкостью
+    return voiceLevel(voice) * channelVolumes[voice.channel] * masterVolume / (MAX_VOLUME * MAX_VOLUME);
 }
 
 void AudioToBuzzerAdapter::updateVoice(Voice& voice) {
-    // Обновляем фазу
+    // Обновляем фазу (переполнение uint32 - естественный перенос периода)
     voice.phase += voice.phaseIncrement;
-    if (voice.phase >= 2.0f * M_PI) {
-        voice.phase -= 2.0f * M_PI;
-    }
     
     // Проверяем, нужно ли отключить голос
     if (voice.released) {
@@ -229,77 +137,23 @@ void AudioToBuzzerAdapter::updateVoice(Voice& voice) {
 }
 
 void AudioToBuzzerAdapter::selectBestVoice() {
-    // Находим самый громкий активный голос
-    uint16_t bestFreq = 0;
-    uint8_t bestVolume = 0;
-    uint8_t bestChannel = 0;
-    float maxVolume = 0.0f;
-    
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active) {
-            float adsrVolume = calculateADSRVolume(voices[i]);
-            if (adsrVolume > maxVolume) {
-                maxVolume = adsrVolume;
-                bestFreq = voices[i].frequency;
-                bestVolume = (uint8_t)(adsrVolume * MAX_VOLUME);
-                bestChannel = voices[i].channel;
+    // Звучащие голоса по порядку занимают каналы Buzzer, аккорд выводится
+    // арпеджио. Вызывается на каждом обновлении: без вывода в UART,
+    // неизменные PSC/ARR/CCR1 Buzzer не перезаписывает
+    uint8_t buzzerChannel = 0;
+    for (uint8_t i = 0; i < MAX_VOICES && buzzerChannel < Buzzer::MAX_CHANNELS; i++) {
+        const Voice& voice = voiceManager.voice(i);
+        if (voice.active) {
+            uint8_t volume = (uint8_t)(calculateADSRVolume(voice) * MAX_VOLUME);
+            if (volume > 0) {
+                buzzer.playMidiNote(buzzerChannel++, voice.note, volume);
             }
         }
     }
     
-    // Воспроизводим лучший голос
-    if (bestFreq > 0 && bestVolume > 0) {
-        buzzer.playNote(0, bestFreq, bestVolume);
-        Uart::getInstance().printf("Best voice: freq=%d, vol=%d, ch=%d\n", 
-                                  bestFreq, bestVolume, bestChannel);
-    } else {
-        buzzer.stopAll();
-    }
-}
-
-// Генерация волн (упрощенная версия для демонстрации)
-float AudioToBuzzerAdapter::generateSine(float phase) {
-    return sinf(phase);
-}
-
-float AudioToBuzzerAdapter::generateSquare(float phase) {
-    return (sinf(phase) >= 0.0f) ? 1.0f : -1.0f;
-}
-
-float AudioToBuzzerAdapter::generateSawtooth(float phase) {
-    while (phase < 0.0f) phase += 2.0f * M_PI;
-    while (phase >= 2.0f * M_PI) phase -= 2.0f * M_PI;
-    return 2.0f * (phase / (2.0f * M_PI)) - 1.0f;
-}
-
-float AudioToBuzzerAdapter::generateTriangle(float phase) {
-    while (phase < 0.0f) phase += 2.0f * M_PI;
-    while (phase >= 2.0f * M_PI) phase -= 2.0f * M_PI;
-    
-    if (phase < M_PI) {
-        return 2.0f * (phase / M_PI) - 1.0f;
-    } else {
-        return 3.0f - 2.0f * (phase / M_PI);
+    for (; buzzerChannel < Buzzer::MAX_CHANNELS; buzzerChannel++) {
+        buzzer.stopNote(buzzerChannel);
     }
 }
 
-float AudioToBuzzerAdapter::generateNoise() {
-    return ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
-}
-
-float AudioToBuzzerAdapter::generateWave(WaveType type, float phase) {
-    switch (type) {
-        case WaveType::SINE:
-            return generateSine(phase);
-        case WaveType::SQUARE:
-            return generateSquare(phase);
-        case WaveType::SAWTOOTH:
-            return generateSawtooth(phase);
-        case WaveType::TRIANGLE:
-            return generateTriangle(phase);
-        case WaveType::NOISE:
-            return generateNoise();
-        default:
-            return generateSine(phase);
-    }
-}
+#endif // SYNTH_ENGINE == SYNTH_ENGINE_BUZZER_ADAPTER
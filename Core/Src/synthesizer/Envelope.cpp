@@ -0,0 +1,166 @@
+#include "synthesizer/Envelope.hpp"
+#include <math.h>
+
+// Насколько экспоненциальная стадия "целится" за конечный уровень
+// (доля от пикового уровня): атака почти линейная, спад и релиз - RC-кривая
+static constexpr float ATTACK_TARGET_RATIO = 0.3f;
+static constexpr float DECAY_TARGET_RATIO = 0.0001f;
+
+#if SYNTH_FIXED_POINT
+static constexpr float Q30_ONE = 1073741824.0f;
+static constexpr int32_t Q30_MAX_LEVEL = (1 << 30) - 1;  // Уровень 1.0 после >> 15 дает 32767
+#endif
+
+EnvelopeLevel Envelope::fromFloat(float value) {
+#if SYNTH_FIXED_POINT
+    float scaled = value * Q30_ONE;
+    return (int32_t)(scaled + ((scaled >= 0.0f) ? 0.5f : -0.5f));
+#else
+    return value;
+#endif
+}
+
+float Envelope::toFloat(EnvelopeLevel value) {
+#if SYNTH_FIXED_POINT
+    return (float)value * (1.0f / Q30_ONE);
+#else
+    return value;
+#endif
+}
+
+Envelope::Envelope()
+    : peak(fromFloat(1.0f)), sustain(0), level(0), mul(fromFloat(1.0f)), add(0), releaseLength(1),
+      stage(EnvelopeStage::IDLE), shape(EnvelopeCurve::LINEAR) {}
+
+void Envelope::setup(uint16_t attackMs, uint16_t decayMs, float sustainLevel, uint16_t releaseMs,
+                     float peakLevel, uint32_t rate, EnvelopeCurve curve) {
+    peak = fromFloat(peakLevel);
+    sustain = fromFloat(sustainLevel * peakLevel);
+#if SYNTH_FIXED_POINT
+    if (peak > Q30_MAX_LEVEL) peak = Q30_MAX_LEVEL;
+    if (sustain > Q30_MAX_LEVEL) sustain = Q30_MAX_LEVEL;
+#endif
+    
+    // Длительность стадий в семплах (минимум один семпл)
+    uint32_t attackSamples = (uint32_t)(((uint64_t)attackMs * rate) / 1000);
+    uint32_t decaySamples = (uint32_t)(((uint64_t)decayMs * rate) / 1000);
+    uint32_t releaseSamples = (uint32_t)(((uint64_t)releaseMs * rate) / 1000);
+    if (attackSamples == 0) attackSamples = 1;
+    if (decaySamples == 0) decaySamples = 1;
+    if (releaseSamples == 0) releaseSamples = 1;
+    
+    releaseLength = releaseSamples;
+    shape = curve;
+    if (shape == EnvelopeCurve::EXPONENTIAL) {
+        attackCoef = exponentialCoefficients(0.0f, toFloat(peak), attackSamples, ATTACK_TARGET_RATIO);
+        decayCoef = exponentialCoefficients(toFloat(peak), toFloat(sustain), decaySamples, DECAY_TARGET_RATIO);
+    } else {
+        attackCoef = linearCoefficients(0.0f, toFloat(peak), attackSamples);
+        decayCoef = linearCoefficients(toFloat(peak), toFloat(sustain), decaySamples);
+    }
+    
+    // Обновляем коэффициенты текущей стадии
+    if (stage == EnvelopeStage::RELEASE) {
+        release();
+    } else {
+        enterStage(stage);
+    }
+}
+
+void Envelope::trigger() {
+    enterStage(EnvelopeStage::ATTACK);
+}
+
+void Envelope::release() {
+    if (stage == EnvelopeStage::IDLE) return;
+    
+    // Релиз всегда длится releaseLength семплов - от уровня, на котором отпустили ноту
+    if (shape == EnvelopeCurve::EXPONENTIAL) {
+        releaseCoef = exponentialCoefficients(toFloat(level), 0.0f, releaseLength, DECAY_TARGET_RATIO);
+    } else {
+        releaseCoef = linearCoefficients(toFloat(level), 0.0f, releaseLength);
+    }
+    enterStage(EnvelopeStage::RELEASE);
+}
+
+void Envelope::reset() {
+    level = 0;
+    enterStage(EnvelopeStage::IDLE);
+}
+
+#if SYNTH_FIXED_POINT
+void Envelope::processQ15(int16_t* out, size_t frames, size_t stride) {
+    // Q30 -> Q15; уровень не превышает Q30_MAX_LEVEL, поэтому без насыщения
+    if (stage == EnvelopeStage::SUSTAIN || stage == EnvelopeStage::IDLE) {
+        const int16_t value = (int16_t)(level >> 15);
+        for (size_t i = 0; i < frames; i++) {
+            out[i * stride] = value;
+        }
+        return;
+    }
+    
+    for (size_t i = 0; i < frames; i++) {
+        out[i * stride] = (int16_t)(next() >> 15);
+    }
+}
+#else
+void Envelope::process(float* out, size_t frames, size_t stride) {
+    // Sustain и тишина - константа, без пересчета
+    if (stage == EnvelopeStage::SUSTAIN || stage == EnvelopeStage::IDLE) {
+        for (size_t i = 0; i < frames; i++) {
+            out[i * stride] = level;
+        }
+        return;
+    }
+    
+    for (size_t i = 0; i < frames; i++) {
+        out[i * stride] = next();
+    }
+}
+#endif
+
+Envelope::StageCoefficients Envelope::linearCoefficients(float from, float to, uint32_t samples) {
+    StageCoefficients coef;
+    coef.mul = fromFloat(1.0f);
+    coef.add = fromFloat((to - from) / (float)samples);
+    return coef;
+}
+
+Envelope::StageCoefficients Envelope::exponentialCoefficients(float from, float to, uint32_t samples,
+                                                               float targetRatio) {
+    // Однополюсный фильтр к цели, вынесенной за конечный уровень на
+    // targetRatio * |to - from|, - конечный уровень достигается ровно за samples
+    float range = fabsf(to - from);
+    float overshoot = (to > from) ? to + targetRatio * range : to - targetRatio * range;
+    
+    float mul = expf(-logf((1.0f + targetRatio) / targetRatio) / (float)samples);
+    
+    StageCoefficients coef;
+    coef.mul = fromFloat(mul);
+    coef.add = fromFloat(overshoot * (1.0f - mul));
+    return coef;
+}
+
+void Envelope::enterStage(EnvelopeStage next) {
+    stage = next;
+    switch (stage) {
+        case EnvelopeStage::ATTACK:
+            mul = attackCoef.mul;
+            add = attackCoef.add;
+            break;
+        case EnvelopeStage::DECAY:
+            mul = decayCoef.mul;
+            add = decayCoef.add;
+            break;
+        case EnvelopeStage::RELEASE:
+            mul = releaseCoef.mul;
+            add = releaseCoef.add;
+            break;
+        case EnvelopeStage::SUSTAIN:
+        case EnvelopeStage::IDLE:
+        default:
+            mul = fromFloat(1.0f);
+            add = 0;
+            break;
+    }
+}
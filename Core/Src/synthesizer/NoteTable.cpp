@@ -0,0 +1,72 @@
+#include "synthesizer/NoteTable.hpp"
+#include "synthesizer/SynthConfig.hpp"
+
+// Вычисление таблиц на этапе компиляции (C++14 constexpr)
+
+static constexpr double SEMITONE_RATIO = 1.0594630943592952646;  // 2^(1/12)
+static constexpr double LN2 = 0.69314718055994530942;
+
+// f = 440 * 2^((note - 69) / 12): октавы - точные степени двойки,
+// внутри октавы - не более 11 умножений на 2^(1/12)
+static constexpr double noteFrequency(uint32_t note) {
+    int32_t delta = (int32_t)note - 69;
+    int32_t octave = (delta >= 0) ? delta / 12 : -((11 - delta) / 12);
+    int32_t semitone = delta - octave * 12;
+    
+    double frequency = 440.0;
+    for (int32_t i = 0; i < semitone; i++) frequency *= SEMITONE_RATIO;
+    for (int32_t i = 0; i < octave; i++) frequency *= 2.0;
+    for (int32_t i = 0; i > octave; i--) frequency *= 0.5;
+    return frequency;
+}
+
+static constexpr double expTaylor(double x) {
+    double term = 1.0;
+    double sum = 1.0;
+    for (int i = 1; i < 20; i++) {
+        term *= x / i;
+        sum += term;
+    }
+    return sum;
+}
+
+template<uint32_t SampleRate, uint32_t TimerClock>
+static constexpr NoteTableData makeNoteTable() {
+    NoteTableData table = {};
+    for (uint32_t note = 0; note < MIDI_NOTE_COUNT; note++) {
+        double frequency = noteFrequency(note);
+        table.phaseIncrement[note] = (uint32_t)(frequency * 4294967296.0 / SampleRate + 0.5);
+        table.timerPeriod[note] = (uint32_t)(TimerClock / frequency + 0.5);
+        // Наибольший ARR - лучшее разрешение скважности и высоты
+        uint32_t prescaler = (table.timerPeriod[note] - 1) >> 16;
+        table.timerPrescaler[note] = (uint16_t)prescaler;
+        table.timerReload[note] = (uint16_t)((uint32_t)(TimerClock / (frequency * (prescaler + 1)) + 0.5) - 1);
+        table.frequency[note] = (uint16_t)(frequency + 0.5);
+    }
+    return table;
+}
+
+static constexpr NoteCentTable makeCentTable() {
+    NoteCentTable table = {};
+    for (uint32_t c = 0; c < CENTS_PER_SEMITONE; c++) {
+        table.ratio[c] = (uint32_t)(expTaylor(c * LN2 / 1200.0) * 1073741824.0 + 0.5);
+    }
+    return table;
+}
+
+static constexpr NoteTableData NOTE_TABLE = makeNoteTable<SAMPLE_RATE, NOTE_TIMER_CLOCK>();
+static constexpr NoteCentTable CENT_TABLE = makeCentTable();
+
+const NoteTableData NoteTable::data = NOTE_TABLE;
+const NoteCentTable NoteTable::cents = CENT_TABLE;
+
+uint32_t NoteTable::phaseIncrement(uint8_t note, int16_t detune) {
+    // Раскладываем на целые полутона и остаток в центах (деление на константу - без libm)
+    int32_t total = (int32_t)(note & 0x7F) * CENTS_PER_SEMITONE + detune;
+    if (total < 0) total = 0;
+    if (total > (MIDI_NOTE_COUNT - 1) * CENTS_PER_SEMITONE) total = (MIDI_NOTE_COUNT - 1) * CENTS_PER_SEMITONE;
+    
+    uint32_t semitone = (uint32_t)total / CENTS_PER_SEMITONE;
+    uint32_t rest = (uint32_t)total % CENTS_PER_SEMITONE;
+    return (uint32_t)(((uint64_t)data.phaseIncrement[semitone] * NoteTable::cents.ratio[rest]) >> 30);
+}
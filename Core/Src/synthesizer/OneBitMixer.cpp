@@ -0,0 +1,175 @@
+#include "synthesizer/OneBitMixer.hpp"
+#include "synthesizer/NoteTable.hpp"
+#include "drivers/Uart.hpp"
+#include <string.h>
+
+extern TIM_HandleTypeDef htim1;
+extern DMA_HandleTypeDef hdma_tim1_up;
+
+// Прерывания DMA2 Stream5 (TIM1_UP) передаются в микшер
+static void dmaHalfTransferCallback(DMA_HandleTypeDef* hdma) {
+    (void)hdma;
+    OneBitMixer::getInstance().onDmaHalfTransfer();
+}
+
+static void dmaTransferCompleteCallback(DMA_HandleTypeDef* hdma) {
+    (void)hdma;
+    OneBitMixer::getInstance().onDmaTransferComplete();
+}
+
+OneBitMixer& OneBitMixer::getInstance() {
+    static OneBitMixer instance;
+    return instance;
+}
+
+bool OneBitMixer::init(uint32_t pwmFreq) {
+    stop();
+    
+    // TIM1 на APB2 без делителя: такт таймера = PCLK2 (NOTE_TIMER_CLOCK)
+    uint32_t pclk = HAL_RCC_GetPCLK2Freq();
+    uint32_t ticks = (pwmFreq > 0) ? (pclk + pwmFreq / 2) / pwmFreq : 0;
+    // Не меньше такта на слот голоса
+    if (ticks < MAX_VOICES) ticks = MAX_VOICES;
+    if (ticks > 65536) ticks = 65536;
+    
+    HAL_TIM_PWM_Stop(&htim1, TIM_CHANNEL_1);
+    top = (uint16_t)(ticks - 1);
+    TIM1->PSC = 0;
+    TIM1->ARR = top;
+    TIM1->CCR1 = 0;
+    
+    sampleRate = pclk / ticks;
+    slotTicks = (uint16_t)(ticks / MAX_VOICES);
+    for (uint8_t i = 0; i < MAX_VOICES; i++) {
+        channels[i] = Channel();
+    }
+    dmaBuffer.reset(BLOCK_FRAMES);
+    dmaBuffer.resetUnderruns();
+    
+    Uart::getInstance().printf("OneBitMixer initialized: sampleRate=%lu, arr=%d, slot=%d\n",
+                              sampleRate, top, slotTicks);
+    return true;
+}
+
+void OneBitMixer::start() {
+    if (!running) {
+        // Обе половины заполняются до запуска DMA
+        dmaBuffer.reset(BLOCK_FRAMES);
+        fillFreeHalf();
+        fillFreeHalf();
+        
+        running = true;
+        hdma_tim1_up.XferHalfCpltCallback = dmaHalfTransferCallback;
+        hdma_tim1_up.XferCpltCallback = dmaTransferCompleteCallback;
+        HAL_DMA_Start_IT(&hdma_tim1_up, (uintptr_t)dmaBuffer.data(), (uintptr_t)&TIM1->CCR1,
+                         dmaBuffer.getLength());
+        __HAL_TIM_ENABLE_DMA(&htim1, TIM_DMA_UPDATE);
+        HAL_TIM_PWM_Start(&htim1, TIM_CHANNEL_1);
+        Uart::getInstance().printf("OneBitMixer started\n");
+    }
+}
+
+void OneBitMixer::stop() {
+    if (running) {
+        running = false;
+        __HAL_TIM_DISABLE_DMA(&htim1, TIM_DMA_UPDATE);
+        HAL_DMA_Abort(&hdma_tim1_up);
+        HAL_TIM_PWM_Stop(&htim1, TIM_CHANNEL_1);
+        TIM1->CCR1 = 0;
+        Uart::getInstance().printf("OneBitMixer stopped\n");
+    }
+}
+
+void OneBitMixer::playNote(uint8_t voice, uint16_t frequency, uint8_t volume) {
+    if (voice >= MAX_VOICES || sampleRate == 0) return;
+    
+    // Выше Найквиста голос не звучит
+    if (frequency == 0 || frequency >= sampleRate / 2) {
+        stopNote(voice);
+        return;
+    }
+    channels[voice].increment = (uint32_t)(((uint64_t)frequency << 32) / sampleRate);
+    setVolume(voice, volume);
+}
+
+void OneBitMixer::playMidiNote(uint8_t voice, uint8_t note, uint8_t volume) {
+    if (voice >= MAX_VOICES || sampleRate == 0) return;
+    
+    // Период ноты в тактах таймера уже в таблице: приращение без округления
+    // частоты до герца, (ARR + 1) тактов на семпл
+    uint32_t period = NoteTable::timerPeriod(note);
+    if (period < 2 * ((uint32_t)top + 1)) {
+        stopNote(voice);
+        return;
+    }
+    channels[voice].increment = (uint32_t)((((uint64_t)top + 1) << 32) / period);
+    setVolume(voice, volume);
+}
+
+void OneBitMixer::stopNote(uint8_t voice) {
+    if (voice >= MAX_VOICES) return;
+    channels[voice].width = 0;
+}
+
+void OneBitMixer::stopAll() {
+    for (uint8_t i = 0; i < MAX_VOICES; i++) {
+        channels[i].width = 0;
+    }
+}
+
+void OneBitMixer::setVolume(uint8_t voice, uint8_t volume) {
+    if (voice >= MAX_VOICES) return;
+    if (volume > MAX_VOLUME) volume = MAX_VOLUME;
+    channels[voice].width = (uint16_t)((uint32_t)slotTicks * volume / MAX_VOLUME);
+}
+
+void OneBitMixer::render(uint16_t* out, size_t frames) {
+    memset(out, 0, frames * sizeof(uint16_t));
+    
+    for (uint8_t v = 0; v < MAX_VOICES; v++) {
+        Channel& ch = channels[v];
+        const uint32_t increment = ch.increment;
+        const uint16_t width = ch.width;
+        uint32_t phase = ch.phase;
+        
+        if (width == 0) {
+            // Молчащий голос только продвигает фазу - нота продолжится без скачка
+            ch.phase = phase + increment * (uint32_t)frames;
+            continue;
+        }
+        
+        // Верхняя половина периода: старший бит фазы -> маска 0 / 0xFFFF
+        for (size_t i = 0; i < frames; i++) {
+            uint16_t mask = (uint16_t)(0u - (phase >> 31));
+            out[i] += width & mask;
+            phase += increment;
+        }
+        ch.phase = phase;
+    }
+}
+
+void OneBitMixer::onDmaHalfTransfer() {
+    dmaBuffer.consumed(0);
+    fillFreeHalf();
+}
+
+void OneBitMixer::onDmaTransferComplete() {
+    dmaBuffer.consumed(1);
+    fillFreeHalf();
+}
+
+void OneBitMixer::fillFreeHalf() {
+    uint8_t half = dmaBuffer.freeHalf();
+    if (half == dmaBuffer.NO_HALF) return;
+    
+    render(dmaBuffer.half(half), dmaBuffer.getHalfLength());
+    
+    // До запуска DMA позиция чтения вне буфера - опоздания нет
+    dmaBuffer.commit(half, running ? dmaReadPosition() : dmaBuffer.getLength());
+}
+
+size_t OneBitMixer::dmaReadPosition() const {
+    // NDTR - сколько передач осталось до конца круга
+    size_t remaining = __HAL_DMA_GET_COUNTER(&hdma_tim1_up);
+    return (dmaBuffer.getLength() - remaining) % dmaBuffer.getLength();
+}
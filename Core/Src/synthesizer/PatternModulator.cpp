@@ -0,0 +1,54 @@
+#include "synthesizer/PatternModulator.hpp"
+void PatternModulator::configure(uint16_t arr, uint8_t ratio) {
+    top = arr;
+    oversampling = ratio ? ratio : 1;
+    
+    // Полная шкала - (top + 1) * oversampling тактов за семпл, +1 уровень для нуля
+    const uint32_t span = ((uint32_t)top + 1) * oversampling;
+    uint32_t count = span + 1;
+    if (count > TABLE_SIZE / oversampling) count = TABLE_SIZE / oversampling;
+    levels = (uint16_t)count;
+    
+    // Строка i: round(i * span / (levels - 1)) тактов, период k получает
+    // разность накопленных долей - импульсы размазаны равномерно
+    for (uint32_t i = 0; i < levels; i++) {
+        uint32_t ticks = (i * span * 2 + (levels - 1)) / (2 * (levels - 1));
+        uint16_t* row = table + i * oversampling;
+        uint32_t previous = 0;
+        for (uint32_t k = 0; k < oversampling; k++) {
+            uint32_t next = ticks * (k + 1) / oversampling;
+            row[k] = (uint16_t)(next - previous);
+            previous = next;
+        }
+    }
+    
+    reset();
+}
+
+void PatternModulator::setVolume(int32_t volumeQ15) {
+    if (volumeQ15 < 0) volumeQ15 = 0;
+    if (volumeQ15 > 32768) volumeQ15 = 32768;
+    volume = volumeQ15;
+}
+
+void PatternModulator::modulate(const int16_t* in, size_t frames, uint16_t* out) {
+    const uint32_t scale = levels - 1;
+    uint32_t carry = residual;
+    
+    for (size_t i = 0; i < frames; i++) {
+        // [-1, 1) -> [0, levels - 1], Q16; дробь уходит в следующий семпл
+        uint32_t level = (uint32_t)(((in[i] * volume) >> 15) + 32768);
+        uint32_t position = level * scale + carry;
+        uint32_t index = position >> 16;
+        if (index > scale) index = scale;
+        carry = position - (index << 16);
+        if (carry > 0xFFFFu) carry = 0xFFFFu;
+        
+        const uint16_t* row = table + index * oversampling;
+        for (uint8_t k = 0; k < oversampling; k++) {
+            *out++ = row[k];
+        }
+    }
+    
+    residual = carry;
+}
@@ -0,0 +1,92 @@
+#include "synthesizer/PolyphaseInterpolator.hpp"
+#include "synthesizer/DspMath.hpp"
+#include <math.h>
+#include <string.h>
+
+// Коэффициенты Q14: центральный отвод фазы 0 близок к 1.0 и не влезает в Q15
+#define INTERPOLATOR_COEF_BITS 14
+// Окно Кайзера: подавление образов около 60 дБ
+#define INTERPOLATOR_KAISER_BETA 5.5f
+
+// Модифицированная функция Бесселя I0 (ряд, достаточно 20 членов)
+static float besselI0(float x) {
+    float sum = 1.0f;
+    float term = 1.0f;
+    float half = x * 0.5f;
+    for (uint8_t k = 1; k < 20; k++) {
+        term *= (half / k) * (half / k);
+        sum += term;
+    }
+    return sum;
+}
+
+void PolyphaseInterpolator::configure(uint8_t value) {
+    ratio = (value < 1) ? 1 : (value > MAX_RATIO) ? MAX_RATIO : value;
+    
+    // Прототип длины TAPS * ratio на выходной частоте: sinc со срезом
+    // на половине входной частоты, фаза p - каждый ratio-й отвод с p
+    const uint16_t length = (uint16_t)(TAPS * ratio);
+    const float center = (length - 1) * 0.5f;
+    const float windowNorm = besselI0(INTERPOLATOR_KAISER_BETA);
+    float prototype[TAPS * MAX_RATIO];
+    for (uint16_t m = 0; m < length; m++) {
+        float t = (m - center) / ratio;
+        float sinc = (fabsf(t) < 1e-6f) ? 1.0f : sinf((float)M_PI * t) / ((float)M_PI * t);
+        float r = (m - center) / center;
+        float window = besselI0(INTERPOLATOR_KAISER_BETA * sqrtf(1.0f - r * r)) / windowNorm;
+        prototype[m] = sinc * window;
+    }
+    
+    // Сумма каждой фазы = 1: постоянная составляющая проходит без пульсаций
+    for (uint8_t p = 0; p < ratio; p++) {
+        float sum = 0.0f;
+        for (uint8_t k = 0; k < TAPS; k++) {
+            sum += prototype[k * ratio + p];
+        }
+        for (uint8_t k = 0; k < TAPS; k++) {
+            float value = prototype[k * ratio + p] / sum * (1 << INTERPOLATOR_COEF_BITS);
+            coefficients[p][TAPS - 1 - k] = (int16_t)lrintf(value);
+        }
+    }
+    
+    reset();
+}
+
+void PolyphaseInterpolator::reset() {
+    memset(line, 0, sizeof(line));
+}
+
+void PolyphaseInterpolator::process(const int16_t* in, size_t frames, int16_t* out) {
+    if (ratio == 1) {
+        memcpy(out, in, frames * sizeof(int16_t));
+        return;
+    }
+    
+    while (frames > 0) {
+        size_t count = (frames > CHUNK_FRAMES) ? CHUNK_FRAMES : frames;
+        memcpy(line + TAPS - 1, in, count * sizeof(int16_t));
+        
+        for (size_t n = 0; n < count; n++) {
+            const int16_t* x = line + n;
+            for (uint8_t p = 0; p < ratio; p++) {
+                const int16_t* c = coefficients[p];
+                int32_t acc = 1 << (INTERPOLATOR_COEF_BITS - 1);
+                // Пары семплов и коэффициентов - по SMLAD; x может быть
+                // не выровнен, memcpy дает LDR без нарушения алиасинга
+                for (uint8_t j = 0; j < TAPS; j += 2) {
+                    uint32_t samples;
+                    uint32_t taps;
+                    memcpy(&samples, x + j, sizeof(samples));
+                    memcpy(&taps, c + j, sizeof(taps));
+                    acc = DspMath::smlad(samples, taps, acc);
+                }
+                *out++ = DspMath::ssat16(acc >> INTERPOLATOR_COEF_BITS);
+            }
+        }
+        
+        // Хвост блока - история для следующего
+        memmove(line, line + count, (TAPS - 1) * sizeof(int16_t));
+        in += count;
+        frames -= count;
+    }
+}
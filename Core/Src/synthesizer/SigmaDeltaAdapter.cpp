@@ -8,75 +8,243 @@ SigmaDeltaAdapter& SigmaDeltaAdapter::getInstance() {
 
 bool SigmaDeltaAdapter::init() {
     // Инициализация синтезатора
-    synthesizer = WaveSynthesizer::getInstance();
     if (!synthesizer.init()) {
         Uart::getInstance().printf("Failed to initialize WaveSynthesizer\n");
         return false;
     }
     
-    // Инициализация сигма-дельта PWM
-    pwmDriver = SigmaDeltaPWM::getInstance();
+    // Инициализация сигма-дельта PWM, интерполяция - до расчета таймера
+    pwmDriver.setInterpolation(INTERPOLATION);
     if (!pwmDriver.init(SAMPLE_RATE, PWM_FREQ)) {
         Uart::getInstance().printf("Failed to initialize SigmaDeltaPWM\n");
         return false;
     }
+    pwmDriver.setRenderCallback(renderBlock);
     
-    // Запускаем PWM
+    // Запускаем PWM. Часы вывода DMA отсчитываются от первого блока (renderSegments)
     pwmDriver.start();
     
     Uart::getInstance().printf("SigmaDeltaAdapter initialized\n");
     return true;
 }
 
-void SigmaDeltaAdapter::noteOn(uint8_t channel, uint8_t note, uint8_t velocity) {
-    synthesizer.noteOn(channel, note, velocity);
+bool SigmaDeltaAdapter::noteOn(uint8_t channel, uint8_t note, uint8_t velocity) {
+    return post(SynthEventType::NOTE_ON, channel, note, velocity);
 }
 
-void SigmaDeltaAdapter::noteOff(uint8_t channel, uint8_t note) {
-    synthesizer.noteOff(channel, note);
+bool SigmaDeltaAdapter::noteOff(uint8_t channel, uint8_t note) {
+    return post(SynthEventType::NOTE_OFF, channel, note);
 }
 
-void SigmaDeltaAdapter::allNotesOff() {
-    synthesizer.allNotesOff();
+bool SigmaDeltaAdapter::allNotesOff() {
+    return post(SynthEventType::ALL_NOTES_OFF, 0);
 }
 
-void SigmaDeltaAdapter::setWaveType(uint8_t channel, WaveType type) {
-    synthesizer.setWaveType(channel, type);
+bool SigmaDeltaAdapter::noteOnAt(uint32_t frame, uint8_t channel, uint8_t note, uint8_t velocity) {
+    return schedule(SynthEvent(frame, SynthEventType::NOTE_ON, channel, note, velocity));
 }
 
-void SigmaDeltaAdapter::setADSR(uint8_t channel, const ADSR& adsr) {
-    synthesizer.setADSR(channel, adsr);
+bool SigmaDeltaAdapter::noteOffAt(uint32_t frame, uint8_t channel, uint8_t note) {
+    return schedule(SynthEvent(frame, SynthEventType::NOTE_OFF, channel, note));
 }
 
-void SigmaDeltaAdapter::setMasterVolume(uint8_t volume) {
-    synthesizer.setMasterVolume(volume);
+bool SigmaDeltaAdapter::schedule(const SynthEvent& event) {
+    return events.push(event);
 }
 
-void SigmaDeltaAdapter::setChannelVolume(uint8_t channel, uint8_t volume) {
-    synthesizer.setChannelVolume(channel, volume);
+bool SigmaDeltaAdapter::setWaveType(uint8_t channel, WaveType type) {
+    return post(SynthEventType::WAVE_TYPE, channel, (uint8_t)type);
+}
+
+bool SigmaDeltaAdapter::setADSR(uint8_t channel, const ADSR& adsr) {
+    return setADSRAt(getLiveFrame(), channel, adsr);
+}
+
+bool SigmaDeltaAdapter::setADSRAt(uint32_t frame, uint8_t channel, const ADSR& adsr) {
+    // Группа уходит одной публикацией: рендерер не увидит половину набора
+    const SynthEvent group[] = {
+        SynthEvent(frame, SynthEventType::ATTACK, channel, 0, 0, adsr.attack),
+        SynthEvent(frame, SynthEventType::DECAY, channel, 0, 0, adsr.decay),
+        SynthEvent(frame, SynthEventType::SUSTAIN, channel, adsr.sustain),
+        SynthEvent(frame, SynthEventType::RELEASE, channel, 0, 0, adsr.release),
+        SynthEvent(frame, SynthEventType::ADSR_APPLY, channel, (uint8_t)adsr.curve)
+    };
+    return events.push(group, sizeof(group) / sizeof(group[0]));
+}
+
+bool SigmaDeltaAdapter::setMasterVolume(uint8_t volume) {
+    return post(SynthEventType::MASTER_VOLUME, 0, volume);
+}
+
+bool SigmaDeltaAdapter::setChannelVolume(uint8_t channel, uint8_t volume) {
+    return post(SynthEventType::CHANNEL_VOLUME, channel, volume);
+}
+
+bool SigmaDeltaAdapter::setPitchBend(uint8_t channel, int16_t cents) {
+    return post(SynthEventType::PITCH_BEND, channel, 0, 0, (uint16_t)cents);
 }
 
 void SigmaDeltaAdapter::update() {
+    // Без потока DMA рендерер не вызывается - события применяет задача,
+    // конкурента у нее в этот момент нет
+    if (!pwmDriver.isRunning()) {
+        collectEvents();
+        for (uint8_t i = 0; i < scheduledCount; i++) {
+            applyEvent(scheduled[i]);
+        }
+        scheduledCount = 0;
+        publishState();
+    }
+    
     // Обновляем синтезатор
     synthesizer.update();
+}
+
+bool SigmaDeltaAdapter::post(SynthEventType type, uint8_t channel, uint8_t data1, uint8_t data2, uint16_t value) {
+    return events.push(SynthEvent(getLiveFrame(), type, channel, data1, data2, value));
+}
+
+uint32_t SigmaDeltaAdapter::getPlaybackFrame() const {
+    if (!pwmDriver.isRunning()) return getFrameTime();
+    return playbackOrigin + pwmDriver.getPlayedFrames();
+}
+
+uint32_t SigmaDeltaAdapter::getLiveFrame() const {
+    // Рендерер опережает вывод не больше чем на весь буфер DMA (два блока):
+    // кадр с такой задержкой еще не отрендерен, событие попадет точно на него
+    if (!pwmDriver.isRunning()) return getFrameTime();
+    return getPlaybackFrame() + 2 * pwmDriver.getRenderFrames();
+}
+
+// Очередь -> список ждущих событий, вставкой по кадру. Сравнение через
+// разность - переполнение счетчика кадров не ломает порядок
+void SigmaDeltaAdapter::collectEvents() {
+    SynthEvent event;
+    while (scheduledCount < MAX_SCHEDULED && events.pop(event)) {
+        uint8_t i = scheduledCount;
+        while (i > 0 && (int32_t)(scheduled[i - 1].time - event.time) > 0) {
+            scheduled[i] = scheduled[i - 1];
+            i--;
+        }
+        scheduled[i] = event;
+        scheduledCount++;
+    }
+}
+
+// Применение событий с кадром не позже frame (опоздавшие - сразу)
+void SigmaDeltaAdapter::applyDueEvents(uint32_t frame) {
+    uint8_t due = 0;
+    while (due < scheduledCount && (int32_t)(scheduled[due].time - frame) <= 0) {
+        applyEvent(scheduled[due]);
+        due++;
+    }
+    if (due == 0) return;
+    for (uint8_t i = due; i < scheduledCount; i++) {
+        scheduled[i - due] = scheduled[i];
+    }
+    scheduledCount -= due;
+}
+
+void SigmaDeltaAdapter::applyEvent(const SynthEvent& event) {
+    switch (event.type) {
+        case SynthEventType::NOTE_ON:
+            synthesizer.noteOn(event.channel, event.data1, event.data2);
+            break;
+        case SynthEventType::NOTE_OFF:
+            synthesizer.noteOff(event.channel, event.data1);
+            break;
+        case SynthEventType::ALL_NOTES_OFF:
+            synthesizer.allNotesOff();
+            break;
+        case SynthEventType::WAVE_TYPE:
+            synthesizer.setWaveType(event.channel, (WaveType)event.data1);
+            break;
+        case SynthEventType::ATTACK:
+            pendingAdsr.attack = event.value;
+            break;
+        case SynthEventType::DECAY:
+            pendingAdsr.decay = event.value;
+            break;
+        case SynthEventType::SUSTAIN:
+            pendingAdsr.sustain = event.data1;
+            break;
+        case SynthEventType::RELEASE:
+            pendingAdsr.release = event.value;
+            break;
+        case SynthEventType::ADSR_APPLY:
+            pendingAdsr.curve = (EnvelopeCurve)event.data1;
+            synthesizer.setADSR(event.channel, pendingAdsr);
+            break;
+        case SynthEventType::MASTER_VOLUME:
+            synthesizer.setMasterVolume(event.data1);
+            break;
+        case SynthEventType::CHANNEL_VOLUME:
+            synthesizer.setChannelVolume(event.channel, event.data1);
+            break;
+        case SynthEventType::PITCH_BEND:
+            synthesizer.setPitchBend(event.channel, (int16_t)event.value);
+            break;
+    }
+}
+
+// Снимок состояния для задач: сами голоса они не читают
+void SigmaDeltaAdapter::publishState() {
+    activeVoices.store(synthesizer.getActiveVoices(), std::memory_order_relaxed);
+    activeChannels.store(synthesizer.getActiveChannels(), std::memory_order_relaxed);
+}
+
+template<typename Sample>
+void SigmaDeltaAdapter::renderSegments(Sample* out, size_t frames) {
+    // start() драйвера (и перезапуск после перенастройки) заполняет буфер до
+    // запуска DMA: часы вывода отсчитываются от первого блока этого запуска
+    if (!pwmDriver.isRunning() && pwmDriver.getStartCount() != originStart) {
+        originStart = pwmDriver.getStartCount();
+        playbackOrigin = getFrameTime();
+    }
     
-    // Генерируем аудио сэмпл с полифонией
-    float sample = synthesizer.generateSample();
+    collectEvents();
+    
+    // Блок режется на отрезки по кадрам событий: голоса меняются ровно
+    // на своем семпле, между событиями - обычный блочный рендеринг
+    uint32_t now = getFrameTime();
+    while (frames > 0) {
+        applyDueEvents(now);
+        size_t count = frames;
+        if (scheduledCount > 0 && scheduled[0].time - now < count) {
+            count = scheduled[0].time - now;
+        }
+        
+        synthesizer.renderBlock(out, count);
+        out += count;
+        frames -= count;
+        now += count;
+    }
     
-    // Отправляем сэмпл в сигма-дельта модулятор
-    pwmDriver.pushSample(sample);
+    publishState();
+    frameTime.store(now, std::memory_order_relaxed);
 }
 
-void SigmaDeltaAdapter::updatePWM() {
-    // Обновляем PWM (вызывается из прерывания таймера)
-    pwmDriver.updatePWM();
+void SigmaDeltaAdapter::render(int16_t* out, size_t frames) {
+    renderSegments(out, frames);
+}
+
+void SigmaDeltaAdapter::render(float* out, size_t frames) {
+    renderSegments(out, frames);
+}
+
+void SigmaDeltaAdapter::renderBlock(int16_t* out, size_t frames) {
+    getInstance().render(out, frames);
 }
 
 uint8_t SigmaDeltaAdapter::getActiveVoices() const {
-    return synthesizer.getActiveVoices();
+    return activeVoices.load(std::memory_order_relaxed);
 }
 
 bool SigmaDeltaAdapter::isChannelActive(uint8_t channel) const {
-    return synthesizer.isChannelActive(channel);
+    if (channel >= WaveSynthesizer::MAX_CHANNELS) return false;
+    return (activeChannels.load(std::memory_order_relaxed) >> channel) & 1;
 }
 
+uint32_t SigmaDeltaAdapter::getUnderruns() const {
+    return pwmDriver.getUnderruns();
+}
@@ -0,0 +1,99 @@
+#include "synthesizer/SigmaDeltaModulator.hpp"
+
+// Внутренние величины - такты таймера с 8 битами дробной части
+#define MODULATOR_FRAC_BITS 8
+
+void SigmaDeltaModulator::configure(uint16_t arr, uint8_t ratio, uint8_t noiseOrder, uint16_t levelCount) {
+    top = arr;
+    oversampling = ratio ? ratio : 1;
+    order = (noiseOrder < 1) ? 1 : (noiseOrder > MAX_ORDER) ? MAX_ORDER : noiseOrder;
+    
+    // Шаг - целое число тактов, верхний уровень всегда 100% (top + 1)
+    const uint32_t full = (uint32_t)top + 1;
+    if (levelCount < 2 || levelCount > full + 1) levelCount = (uint16_t)(full + 1);
+    step = (uint16_t)((full + levelCount - 2) / (levelCount - 1));
+    levels = (uint16_t)((full + step - 1) / step + 1);
+    stepQ = (int32_t)step << MODULATOR_FRAC_BITS;
+    reciprocal = (uint32_t)((1ULL << 32) / (uint32_t)stepQ);
+    
+    reset();
+}
+
+void SigmaDeltaModulator::reset() {
+    for (uint8_t i = 0; i < MAX_ORDER; i++) {
+        error[i] = 0;
+    }
+}
+
+void SigmaDeltaModulator::setVolume(int32_t volumeQ15) {
+    if (volumeQ15 < 0) volumeQ15 = 0;
+    if (volumeQ15 > 32768) volumeQ15 = 32768;
+    volume = volumeQ15;
+}
+
+void SigmaDeltaModulator::modulate(const int16_t* in, size_t frames, uint16_t* out) {
+    // Порядок - параметр шаблона, выбор вынесен из цикла по тактам
+    switch (order) {
+        case 3:
+            modulateLoop<3>(in, frames, out);
+            break;
+        case 2:
+            modulateLoop<2>(in, frames, out);
+            break;
+        default:
+            modulateLoop<1>(in, frames, out);
+            break;
+    }
+}
+
+template<uint8_t Order>
+void SigmaDeltaModulator::modulateLoop(const int16_t* in, size_t frames, uint16_t* out) {
+    const int32_t full = (int32_t)top + 1;
+    const int32_t fullQ = full << MODULATOR_FRAC_BITS;
+    const int32_t errorLimit = 2 * stepQ;
+    int32_t e1 = error[0];
+    int32_t e2 = error[1];
+    int32_t e3 = error[2];
+    
+    for (size_t i = 0; i < frames; i++) {
+        // [-1, 1) -> [0, full) тактов, Q8 с округлением: отбрасывание дроби
+        // смещает среднюю скважность и копится в дрейф
+        int32_t level = ((in[i] * volume) >> 15) + 32768;
+        int32_t x = (int32_t)(((int64_t)level * full + (1 << (15 - MODULATOR_FRAC_BITS))) >> (16 - MODULATOR_FRAC_BITS));
+        
+        for (uint8_t k = 0; k < oversampling; k++) {
+            // y = x + e - (коэффициенты (1 - z^-1)^Order без единицы) * прошлые e
+            int32_t u;
+            if (Order == 1) {
+                u = x - e1;
+            } else if (Order == 2) {
+                u = x - 2 * e1 + e2;
+            } else {
+                u = x - 3 * e1 + 3 * e2 - e3;
+            }
+            
+            // Ближайший уровень: (u + stepQ / 2) / stepQ через умножение на обратное,
+            // вход за пределами шкалы дает крайний уровень
+            int32_t clamped = (u < 0) ? 0 : (u > fullQ) ? fullQ : u;
+            uint32_t index = (uint32_t)(((uint64_t)(uint32_t)(clamped + (stepQ >> 1)) * reciprocal) >> 32);
+            int32_t ccr = (int32_t)index * step;
+            if (ccr > full) ccr = full;
+            
+            // Ошибка считается от неограниченного u и ограничивается двумя шагами:
+            // при перегрузке фильтр не раскачивается, а 1-битный режим 2-го порядка
+            // остается устойчивым (при одном шаге он срывается в генерацию)
+            int32_t e = (ccr << MODULATOR_FRAC_BITS) - u;
+            if (e > errorLimit) e = errorLimit;
+            if (e < -errorLimit) e = -errorLimit;
+            
+            e3 = e2;
+            e2 = e1;
+            e1 = e;
+            *out++ = (uint16_t)ccr;
+        }
+    }
+    
+    error[0] = e1;
+    error[1] = e2;
+    error[2] = e3;
+}
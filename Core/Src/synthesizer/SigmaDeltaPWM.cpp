@@ -3,6 +3,29 @@
 #include <string.h>
 
 extern TIM_HandleTypeDef htim1;
+extern DMA_HandleTypeDef hdma_tim1_up;
+
+// Прерывания DMA2 Stream5 (TIM1_UP) передаются в драйвер
+static void dmaHalfTransferCallback(DMA_HandleTypeDef* hdma) {
+    (void)hdma;
+    SigmaDeltaPWM::getInstance().onDmaHalfTransfer();
+}
+
+static void dmaTransferCompleteCallback(DMA_HandleTypeDef* hdma) {
+    (void)hdma;
+    SigmaDeltaPWM::getInstance().onDmaTransferComplete();
+}
+
+// Наибольшая передискретизация <= target, на которую делится ticks
+// (не меньше 2 тактов на период ШИМ)
+static uint32_t largestRatio(uint32_t ticks, uint32_t target) {
+    for (uint32_t ratio = target; ratio > 1; ratio--) {
+        if (ticks % ratio == 0 && ticks / ratio >= 2) {
+            return ratio;
+        }
+    }
+    return 1;
+}
 
 SigmaDeltaPWM& SigmaDeltaPWM::getInstance() {
     static SigmaDeltaPWM instance;
@@ -10,58 +33,105 @@ SigmaDeltaPWM& SigmaDeltaPWM::getInstance() {
 }
 
 bool SigmaDeltaPWM::init(uint32_t sampleRate, uint32_t pwmFreq) {
-    this->sampleRate = sampleRate;
-    this->pwmFreq = pwmFreq;
+    this->requestedSampleRate = sampleRate;
+    this->requestedPwmFreq = pwmFreq;
     this->running = false;
-    this->phaseAccumulator = 0;
-    this->error = 0.0f;
-    this->currentSample = 0.0f;
-    this->volume = 1.0f;
-    this->bufferIndex = 0;
     
-    // Инициализация буфера
-    sampleBuffer[0] = 0.0f;
-    sampleBuffer[1] = 0.0f;
+    modulator.setVolume(32768);
+    patternModulator.setVolume(32768);
+    dmaBuffer.resetUnderruns();
     
     // Настройка таймера на высокую частоту PWM
     updateTimerSettings();
     
-    Uart::getInstance().printf("SigmaDeltaPWM initialized: sampleRate=%lu, pwmFreq=%lu\n",
-                              sampleRate, pwmFreq);
+    Uart::getInstance().printf("SigmaDeltaPWM initialized: sampleRate=%lu, pwmFreq=%lu, oversampling=%d\n",
+                              this->sampleRate, this->pwmFreq, modulator.getOversampling());
     
     return true;
 }
 
+void SigmaDeltaPWM::setRenderCallback(RenderCallback callback) {
+    render = callback;
+}
+
 void SigmaDeltaPWM::updateTimerSettings() {
+    // Частоты еще не заданы (настройка до init)
+    if (requestedSampleRate == 0 || requestedPwmFreq == 0) return;
+    
     // Останавливаем таймер
     HAL_TIM_PWM_Stop(&htim1, TIM_CHANNEL_1);
     
-    // Рассчитываем параметры для PWM частоты
-    // PCLK1 обычно 90MHz для STM32F4
-    uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+    // TIM1 на APB2: при делителе APB2 = 1 (HSI 16 МГц без PLL) такт таймера = PCLK2
+    uint32_t pclk = HAL_RCC_GetPCLK2Freq();
     
-    // Нам нужна частота обновления pwmFreq (например, 1MHz)
-    // ARR должно быть маленьким для максимальной точности
-    // Например, ARR = 90 для 1MHz при PCLK = 90MHz
-    uint32_t arr = (pclk / pwmFreq) - 1;
-    if (arr < 1) arr = 1;
+    // DMA переносит одно значение за период ШИМ, поэтому частота семплов
+    // модулятора = pclk / ((ARR + 1) * oversampling), частота рендеринга - еще
+    // в interpolation раз ниже. Тактов на семпл модулятора подбираем так,
+    // чтобы они делились на передискретизацию не больше запрошенной
+    interpolator.configure(interpolationRatio);
+    const uint32_t interpolation = interpolator.getRatio();
+    const uint32_t modulatorRate = requestedSampleRate * interpolation;
+    uint32_t target = requestedPwmFreq / modulatorRate;
+    if (target < 1) target = 1;
+    if (target > MAX_OVERSAMPLING) target = MAX_OVERSAMPLING;
+    
+    // Точная частота семплов важнее: соседние значения тактов (±1, ошибка
+    // частоты ~0.3%) берутся, только если точное делится хуже чем на target / 2
+    uint32_t ticks = (pclk + modulatorRate / 2) / modulatorRate;
+    uint32_t bestTicks = ticks;
+    uint32_t bestRatio = largestRatio(ticks, target);
+    static const int8_t offsets[] = { -1, 1 };
+    for (uint8_t i = 0; i < sizeof(offsets) && bestRatio * 2 < target; i++) {
+        uint32_t ratio = largestRatio(ticks + offsets[i], target);
+        if (ratio > bestRatio) {
+            bestTicks = ticks + offsets[i];
+            bestRatio = ratio;
+        }
+    }
+    
+    uint32_t arr = bestTicks / bestRatio - 1;
     if (arr > 65535) arr = 65535;
     
     // Prescaler = 0 (деление на 1)
-    uint32_t psc = 0;
-    
-    TIM1->PSC = psc;
+    TIM1->PSC = 0;
     TIM1->ARR = arr;
-    TIM1->CCR1 = arr / 2; // Начальная duty cycle 50%
+    TIM1->CCR1 = 0;
     
-    Uart::getInstance().printf("PWM Timer: pclk=%lu, arr=%lu, actual_freq=%lu\n",
-                              pclk, arr, pclk / (arr + 1));
+    pwmFreq = pclk / (arr + 1);
+    sampleRate = pwmFreq / (bestRatio * interpolation);
+    modulator.configure((uint16_t)arr, (uint8_t)bestRatio, modulatorOrder, modulatorLevels);
+    if (modulatorType == ModulatorType::PATTERN_TABLE) {
+        patternModulator.configure((uint16_t)arr, (uint8_t)bestRatio);
+    }
+    dmaBuffer.reset(getRenderFrames() * interpolation * bestRatio);
+    
+    if (modulatorType == ModulatorType::PATTERN_TABLE) {
+        Uart::getInstance().printf("PWM Timer: pclk=%lu, arr=%lu, actual_freq=%lu, pattern levels=%d, interpolation=%lu\n",
+                                  pclk, arr, pwmFreq, patternModulator.getLevels(), interpolation);
+    } else {
+        Uart::getInstance().printf("PWM Timer: pclk=%lu, arr=%lu, actual_freq=%lu, order=%d, levels=%d, interpolation=%lu\n",
+                                  pclk, arr, pwmFreq, modulator.getOrder(), modulator.getLevels(), interpolation);
+    }
 }
 
 void SigmaDeltaPWM::start() {
     if (!running) {
+        // Обе половины заполняются до запуска DMA
+        startCount++;
+        modulator.reset();
+        patternModulator.reset();
+        interpolator.reset();
+        dmaBuffer.reset(getRenderFrames() * interpolator.getRatio() * modulator.getOversampling());
+        fillFreeHalf();
+        fillFreeHalf();
+        
+        playedHalves = 0;
         running = true;
-        phaseAccumulator = 0;
+        hdma_tim1_up.XferHalfCpltCallback = dmaHalfTransferCallback;
+        hdma_tim1_up.XferCpltCallback = dmaTransferCompleteCallback;
+        HAL_DMA_Start_IT(&hdma_tim1_up, (uintptr_t)dmaBuffer.data(), (uintptr_t)&TIM1->CCR1,
+                         dmaBuffer.getLength());
+        __HAL_TIM_ENABLE_DMA(&htim1, TIM_DMA_UPDATE);
         HAL_TIM_PWM_Start(&htim1, TIM_CHANNEL_1);
         Uart::getInstance().printf("SigmaDeltaPWM started\n");
     }
@@ -70,72 +140,117 @@ void SigmaDeltaPWM::start() {
 void SigmaDeltaPWM::stop() {
     if (running) {
         running = false;
+        __HAL_TIM_DISABLE_DMA(&htim1, TIM_DMA_UPDATE);
+        HAL_DMA_Abort(&hdma_tim1_up);
         HAL_TIM_PWM_Stop(&htim1, TIM_CHANNEL_1);
         TIM1->CCR1 = 0;
         Uart::getInstance().printf("SigmaDeltaPWM stopped\n");
     }
 }
 
-void SigmaDeltaPWM::pushSample(float sample) {
-    // Ограничиваем диапазон [-1.0, 1.0]
-    if (sample > 1.0f) sample = 1.0f;
-    if (sample < -1.0f) sample = -1.0f;
-    
-    // Простое буферизование для сглаживания
-    sampleBuffer[bufferIndex] = sample;
-    bufferIndex = (bufferIndex + 1) % 2;
+void SigmaDeltaPWM::onDmaHalfTransfer() {
+    dmaBuffer.consumed(0);
+    playedHalves = playedHalves + 1;
+    fillFreeHalf();
 }
 
-float SigmaDeltaPWM::interpolateSample() {
-    // Линейная интерполяция между двумя последними семплами
-    float ratio = (float)(phaseAccumulator % (pwmFreq / sampleRate)) / 
-                  (float)(pwmFreq / sampleRate);
-    return sampleBuffer[0] + (sampleBuffer[1] - sampleBuffer[0]) * ratio;
+void SigmaDeltaPWM::onDmaTransferComplete() {
+    dmaBuffer.consumed(1);
+    playedHalves = playedHalves + 1;
+    fillFreeHalf();
 }
 
-void SigmaDeltaPWM::updatePWM() {
-    if (!running) return;
-    
-    // Вычисляем текущее значение амплитуды
-    float amplitude = interpolateSample();
+uint32_t SigmaDeltaPWM::getPlayedFrames() const {
+    if (!running) return 0;
     
-    // Применяем громкость
-    amplitude *= volume;
+    // Счетчик половин и NDTR читаются согласованно: повтор, если между
+    // чтениями пришло прерывание
+    uint32_t halves;
+    size_t position;
+    do {
+        halves = playedHalves;
+        position = dmaReadPosition();
+    } while (halves != playedHalves);
     
-    // Конвертируем из [-1, 1] в [0, 1]
-    float normalized = (amplitude + 1.0f) / 2.0f;
-    
-    // Сигма-дельта модуляция
-    float temp = normalized + error;
-    uint32_t bit = (temp > 0.5f) ? 1 : 0;
-    error = temp - (float)bit;
-    
-    // Обновляем PWM
-    uint32_t arr = TIM1->ARR;
-    uint32_t dutyCycle = bit ? arr : 0; // 100% или 0% для 1-bit PWM
-    
-    // Для более гладкого звука можно использовать multi-bit:
-    // dutyCycle = (uint32_t)(normalized * arr);
-    // Но для чистой сигма-дельта используем только 0/ARR
+    // Позиция от начала половины, которую DMA читает по счетчику. Если DMA
+    // уже перешел границу, а прерывание еще не обработано, смещение больше
+    // половины - кадры при этом не теряются
+    const size_t halfLength = dmaBuffer.getHalfLength();
+    const size_t length = dmaBuffer.getLength();
+    const size_t offset = (position + length - (halves & 1) * halfLength) % length;
+    return halves * getRenderFrames() + (uint32_t)(offset * getRenderFrames() / halfLength);
+}
+
+void SigmaDeltaPWM::fillFreeHalf() {
+    uint8_t half = dmaBuffer.freeHalf();
+    if (half == dmaBuffer.NO_HALF) return;
     
-    TIM1->CCR1 = dutyCycle;
+    // Блок рендеринга -> ratio семплов на каждый -> CCR1 на каждый период ШИМ
+    const size_t frames = getRenderFrames();
+    const size_t upsampled = frames * interpolator.getRatio();
+    if (render) {
+        render(renderBuffer, frames);
+    } else {
+        memset(renderBuffer, 0, frames * sizeof(int16_t));
+    }
+    interpolator.process(renderBuffer, frames, upsampledBuffer);
+    if (modulatorType == ModulatorType::PATTERN_TABLE) {
+        patternModulator.modulate(upsampledBuffer, upsampled, dmaBuffer.half(half));
+    } else {
+        modulator.modulate(upsampledBuffer, upsampled, dmaBuffer.half(half));
+    }
     
-    // Увеличиваем фазовый аккумулятор для интерполяции
-    phaseAccumulator++;
+    // До запуска DMA позиция чтения вне буфера - опоздания нет
+    dmaBuffer.commit(half, running ? dmaReadPosition() : dmaBuffer.getLength());
+}
+
+size_t SigmaDeltaPWM::dmaReadPosition() const {
+    // NDTR - сколько передач осталось до конца круга
+    size_t remaining = __HAL_DMA_GET_COUNTER(&hdma_tim1_up);
+    return (dmaBuffer.getLength() - remaining) % dmaBuffer.getLength();
 }
 
 void SigmaDeltaPWM::setSampleRate(uint32_t rate) {
-    sampleRate = rate;
+    requestedSampleRate = rate;
+    reconfigure();
 }
 
 void SigmaDeltaPWM::setPWMFreq(uint32_t freq) {
-    pwmFreq = freq;
-    updateTimerSettings();
+    requestedPwmFreq = freq;
+    reconfigure();
 }
 
 void SigmaDeltaPWM::setVolume(float vol) {
     if (vol < 0.0f) vol = 0.0f;
     if (vol > 1.0f) vol = 1.0f;
-    volume = vol;
+    modulator.setVolume((int32_t)(vol * 32768.0f));
+    patternModulator.setVolume((int32_t)(vol * 32768.0f));
+}
+
+void SigmaDeltaPWM::setModulator(uint8_t order, uint16_t levels) {
+    modulatorOrder = order;
+    modulatorLevels = levels;
+    reconfigure();
+}
+
+void SigmaDeltaPWM::setInterpolation(uint8_t ratio) {
+    interpolationRatio = ratio;
+    reconfigure();
 }
 
+void SigmaDeltaPWM::setModulatorType(ModulatorType type) {
+    if (type == modulatorType) return;
+    modulatorType = type;
+    reconfigure();
+}
+
+void SigmaDeltaPWM::reconfigure() {
+    // ARR, модулятор, таблица шаблонов и длина буфера DMA меняются вместе,
+    // поэтому на ходу - с перезапуском вывода (прерывания DMA не должны
+    // видеть буфер и модулятор посреди настройки). До init частоты не заданы:
+    // updateTimerSettings ничего не делает, настройки применит init
+    bool wasRunning = running;
+    stop();
+    updateTimerSettings();
+    if (wasRunning) start();
+}
@@ -0,0 +1,394 @@
+#include "synthesizer/SynthBenchmark.hpp"
+#include "synthesizer/WaveSynthesizer.hpp"
+#include "synthesizer/VoicePool.hpp"
+#include "synthesizer/NoteTable.hpp"
+#include "synthesizer/SigmaDeltaModulator.hpp"
+#include "stm32f4xx_hal.h"
+#include <stdio.h>
+
+// Счетчик времени: DWT объявлен в core_cm4.h (через HAL) - на плате,
+// в хост-сборке его нет
+#if defined(DWT)
+static void enableCounter() {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static inline uint32_t counterNow() {
+    return DWT->CYCCNT;
+}
+
+static uint32_t budgetPerSample() {
+    return SystemCoreClock / SAMPLE_RATE;
+}
+#else
+#include <chrono>
+
+static void enableCounter() {
+}
+
+// Наносекунды по модулю 2^32: разность верна для замеров короче 4 с
+static inline uint32_t counterNow() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static uint32_t budgetPerSample() {
+    return 1000000000u / SAMPLE_RATE;
+}
+#endif
+
+// Набор замеров: шаги идут подряд в этом порядке
+static constexpr uint16_t GENERATOR_CASES = 9;
+static constexpr uint16_t ENVELOPE_CASES = 2;
+static constexpr uint16_t MODULATOR_CASES = 4;
+
+// Модулятор: 16 МГц таймер, 45 тактов на период ШИМ, 8 периодов на семпл (~44.4 кГц)
+static constexpr uint16_t MODULATOR_TOP = 44;
+static constexpr uint8_t MODULATOR_OVERSAMPLING = 8;
+static constexpr uint8_t OUTPUT_ORDER = 2;  // Модулятор по умолчанию (SigmaDeltaPWM)
+
+static const char* const WAVE_NAMES[] = { "sine", "square", "saw", "triangle", "noise" };
+
+// Результаты уходят сюда, чтобы компилятор не выбросил вычисления
+static volatile float floatSink;
+static volatile int32_t intSink;
+
+// Голоса микшера бенчмарка: огибающая сразу в сустейне на полном уровне
+static Voice benchVoices[WaveSynthesizer::MAX_VOICES];
+static uint8_t activeList[WaveSynthesizer::MAX_VOICES];
+
+static void setupVoices(WaveType wave, uint8_t count) {
+    for (uint8_t i = 0; i < WaveSynthesizer::MAX_VOICES; i++) {
+        Voice& voice = benchVoices[i];
+        voice = Voice();
+        activeList[i] = i;
+        if (i >= count) continue;
+        
+        voice.active = true;
+        voice.note = 36 + i;
+        voice.velocity = WaveSynthesizer::MAX_VELOCITY;
+        voice.channel = i % WaveSynthesizer::MAX_CHANNELS;
+        voice.waveType = wave;
+        voice.frequency = NoteTable::frequency(voice.note);
+        voice.phaseIncrement = NoteTable::phaseIncrement(voice.note, 0);
+        voice.noise.seed(NoiseGenerator::DEFAULT_SEED + i);
+        voice.envelope.setup(0, 0, 1.0f, 100, 1.0f, SAMPLE_RATE);
+        voice.envelope.trigger();
+    }
+}
+
+// Минимум из REPEATS прогонов body
+template<typename Body>
+static uint32_t measure(Body body) {
+    uint32_t best = UINT32_MAX;
+    for (uint8_t r = 0; r < SynthBenchmark::REPEATS; r++) {
+        uint32_t start = counterNow();
+        body();
+        uint32_t elapsed = counterNow() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+// Осциллятор osc(phase, increment) на ноте A4
+template<typename Oscillator>
+static uint32_t measureOscillator(uint32_t samples, Oscillator osc) {
+    const uint32_t increment = NoteTable::phaseIncrement(69, 0);
+    return measure([&] {
+        float acc = 0.0f;
+        uint32_t phase = 0;
+        for (uint32_t i = 0; i < samples; i++) {
+            acc += osc(phase, increment);
+            phase += increment;
+        }
+        floatSink = acc;
+    });
+}
+
+// Блоками AUDIO_BLOCK_SIZE, последний - остаток
+template<typename Block>
+static void forEachBlock(uint32_t samples, Block block) {
+    for (uint32_t done = 0; done < samples; done += AUDIO_BLOCK_SIZE) {
+        uint32_t remaining = samples - done;
+        block(remaining < AUDIO_BLOCK_SIZE ? remaining : AUDIO_BLOCK_SIZE);
+    }
+}
+
+static void formatMilli(char* out, size_t size, uint64_t numerator, uint64_t denominator) {
+    uint64_t milli = numerator * 1000 / denominator;
+    snprintf(out, size, "%lu.%03lu", (unsigned long)(milli / 1000), (unsigned long)(milli % 1000));
+}
+
+// Микшер бенчмарка: состояние блока (пул, нормализация) не делится со
+// звучащим синтезатором
+static VoiceMixer benchMixer;
+
+SynthBenchmark::SynthBenchmark()
+    : mixer(benchMixer), format(Format::CSV), samples(DEFAULT_SAMPLES), cursor(0), running(false),
+      outputCost(0) {}
+
+SynthBenchmark& SynthBenchmark::getInstance() {
+    static SynthBenchmark instance;
+    return instance;
+}
+
+const char* SynthBenchmark::unit() {
+#if defined(DWT)
+    return "cycles";
+#else
+    return "ns";
+#endif
+}
+
+void SynthBenchmark::start(Format value, uint32_t sampleCount) {
+    enableCounter();
+    format = value;
+    samples = sampleCount ? sampleCount : 1;
+    cursor = 0;
+    outputCost = 0;
+    running = true;
+}
+
+bool SynthBenchmark::step(Writer write) {
+    if (!running) return false;
+    
+    char line[LINE_SIZE];
+    uint16_t index = cursor++;
+    if (index == 0) {
+        if (format == Format::JSON) {
+            snprintf(line, sizeof(line),
+                     "{\"unit\":\"%s\",\"sample_rate\":%d,\"block\":%d,\"kernel\":\"%s\","
+                     "\"fixed_point\":%d,\"repeats\":%d,\"results\":[\n",
+                     unit(), SAMPLE_RATE, AUDIO_BLOCK_SIZE, VoiceKernels::name(), SYNTH_FIXED_POINT, REPEATS);
+        } else {
+            snprintf(line, sizeof(line), "benchmark,variant,voices,samples,total_%s,%s_per_sample,%s_per_voice_sample\n",
+                     unit(), unit(), unit());
+        }
+        write(line);
+        return true;
+    }
+    
+    Result result;
+    if (measureStep(index - 1, result)) {
+        writeResult(write, result, index == 1);
+        return true;
+    }
+    
+    const uint16_t measureSteps = GENERATOR_CASES + ENVELOPE_CASES + MODULATOR_CASES + 2 * WAVE_COUNT * MAX_VOICES;
+    uint16_t budget = index - 1 - measureSteps;
+    if (budget < WAVE_COUNT) {
+        writeBudget(write, (uint8_t)budget);
+        return true;
+    }
+    
+    if (format == Format::JSON) write("\n]}\n");
+    running = false;
+    return false;
+}
+
+bool SynthBenchmark::measureStep(uint16_t index, Result& result) {
+    result.voices = 0;
+    
+    if (index < GENERATOR_CASES) {
+        WaveGenerator& gen = WaveGenerator::getInstance();
+        switch (index) {
+            case 0:
+                result = { "generateSine", "-", 0,
+                           measureOscillator(samples, [&](uint32_t p, uint32_t) { return gen.generateSine(p); }) };
+                break;
+            case 1:
+                result = { "generateSquare", "naive", 0,
+                           measureOscillator(samples, [&](uint32_t p, uint32_t) { return gen.generateSquare(p); }) };
+                break;
+            case 2:
+                result = { "generateSquare", "polyblep", 0,
+                           measureOscillator(samples, [&](uint32_t p, uint32_t i) { return gen.generateSquare(p, i); }) };
+                break;
+            case 3:
+                result = { "generateSawtooth", "naive", 0,
+                           measureOscillator(samples, [&](uint32_t p, uint32_t) { return gen.generateSawtooth(p); }) };
+                break;
+            case 4:
+                result = { "generateSawtooth", "polyblep", 0,
+                           measureOscillator(samples, [&](uint32_t p, uint32_t i) { return gen.generateSawtooth(p, i); }) };
+                break;
+            case 5:
+                result = { "generateTriangle", "naive", 0,
+                           measureOscillator(samples, [&](uint32_t p, uint32_t) { return gen.generateTriangle(p); }) };
+                break;
+            case 6:
+                result = { "generateTriangle", "polyblamp", 0,
+                           measureOscillator(samples, [&](uint32_t p, uint32_t i) { return gen.generateTriangle(p, i); }) };
+                break;
+            case 7:
+                result = { "generateNoise", "-", 0,
+                           measureOscillator(samples, [&](uint32_t, uint32_t) { return gen.generateNoise(); }) };
+                break;
+            default:
+                result = { "generateWithHarmonics", "saw", 0,
+                           measureOscillator(samples, [&](uint32_t p, uint32_t) {
+                               return gen.generateWithHarmonics(WaveType::SAWTOOTH, p, MAX_HARMONICS);
+                           }) };
+                break;
+        }
+        return true;
+    }
+    index -= GENERATOR_CASES;
+    
+    if (index < ENVELOPE_CASES) {
+        const EnvelopeCurve curve = index ? EnvelopeCurve::EXPONENTIAL : EnvelopeCurve::LINEAR;
+        Envelope envelope;
+        result.benchmark = "envelope";
+        result.variant = index ? "exponential" : "linear";
+        result.total = measure([&] {
+            // Атака, спад и сустейн в пределах прогона
+            envelope.reset();
+            envelope.setup(10, 20, 0.5f, 100, 1.0f, SAMPLE_RATE, curve);
+            envelope.trigger();
+#if SYNTH_FIXED_POINT
+            int16_t gains[AUDIO_BLOCK_SIZE];
+            int32_t acc = 0;
+            forEachBlock(samples, [&](uint32_t frames) {
+                envelope.processQ15(gains, frames);
+                acc += gains[0];
+            });
+            intSink = acc;
+#else
+            float gains[AUDIO_BLOCK_SIZE];
+            float acc = 0.0f;
+            forEachBlock(samples, [&](uint32_t frames) {
+                envelope.process(gains, frames);
+                acc += gains[0];
+            });
+            floatSink = acc;
+#endif
+        });
+        return true;
+    }
+    index -= ENVELOPE_CASES;
+    
+    if (index < MODULATOR_CASES) {
+        // Порядки 1-3 со всеми уровнями и 1-битный квантователь 2-го порядка;
+        // время - на семпл рендеринга (MODULATOR_OVERSAMPLING значений CCR)
+        static const char* const VARIANTS[] = { "order1", "order2", "order3", "order2/1bit" };
+        const uint8_t order = (index < 3) ? index + 1 : 2;
+        const uint16_t levels = (index < 3) ? SigmaDeltaModulator::ALL_LEVELS : 2;
+        
+        int16_t input[AUDIO_BLOCK_SIZE];
+        for (uint32_t i = 0; i < AUDIO_BLOCK_SIZE; i++) {
+            input[i] = (int16_t)((int32_t)i * 65535 / AUDIO_BLOCK_SIZE - 32767);
+        }
+        uint16_t output[AUDIO_BLOCK_SIZE * MODULATOR_OVERSAMPLING];
+        SigmaDeltaModulator modulator;
+        modulator.configure(MODULATOR_TOP, MODULATOR_OVERSAMPLING, order, levels);
+        
+        result.benchmark = "sigmaDelta";
+        result.variant = VARIANTS[index];
+        result.total = measure([&] {
+            modulator.reset();
+            int32_t acc = 0;
+            forEachBlock(samples, [&](uint32_t frames) {
+                modulator.modulate(input, frames, output);
+                acc += output[0];
+            });
+            intSink = acc;
+        });
+        if (index == OUTPUT_ORDER - 1) outputCost = result.total;
+        return true;
+    }
+    index -= MODULATOR_CASES;
+    
+    // Микшер: волна x число голосов
+    if (index < 2 * WAVE_COUNT * MAX_VOICES) {
+        const bool perSample = index >= WAVE_COUNT * MAX_VOICES;
+        if (perSample) index -= WAVE_COUNT * MAX_VOICES;
+        const uint8_t wave = index / MAX_VOICES;
+        const uint8_t count = index % MAX_VOICES + 1;
+        setupVoices((WaveType)wave, count);
+        
+        result.variant = WAVE_NAMES[wave];
+        result.voices = count;
+        if (perSample) {
+            result.benchmark = "mixVoices";
+            result.total = measure([&] {
+                float acc = 0.0f;
+                for (uint32_t i = 0; i < samples; i++) {
+                    acc += mixer.mixVoices(benchVoices, count);
+                }
+                floatSink = acc;
+            });
+        } else {
+            result.benchmark = "mixBlock";
+            result.total = measure([&] {
+#if SYNTH_FIXED_POINT
+                int16_t out[AUDIO_BLOCK_SIZE];
+                int32_t acc = 0;
+                forEachBlock(samples, [&](uint32_t frames) {
+                    mixer.mixBlockQ15(benchVoices, activeList, count, out, frames);
+                    acc += out[0];
+                });
+                intSink = acc;
+#else
+                float out[AUDIO_BLOCK_SIZE];
+                float acc = 0.0f;
+                forEachBlock(samples, [&](uint32_t frames) {
+                    mixer.mixBlock(benchVoices, activeList, count, out, frames);
+                    acc += out[0];
+                });
+                floatSink = acc;
+#endif
+            });
+            mixCost[wave][count - 1] = result.total;
+        }
+        return true;
+    }
+    
+    return false;
+}
+
+void SynthBenchmark::writeResult(Writer write, const Result& result, bool first) {
+    char perSample[24];
+    char perVoice[24] = "";
+    formatMilli(perSample, sizeof(perSample), result.total, samples);
+    if (result.voices) {
+        formatMilli(perVoice, sizeof(perVoice), result.total, (uint64_t)samples * result.voices);
+    }
+    
+    char line[LINE_SIZE];
+    if (format == Format::JSON) {
+        char voiceField[48] = "";
+        if (result.voices) snprintf(voiceField, sizeof(voiceField), ",\"per_voice_sample\":%s", perVoice);
+        snprintf(line, sizeof(line),
+                 "%s{\"benchmark\":\"%s\",\"variant\":\"%s\",\"voices\":%u,\"samples\":%lu,\"total\":%lu,"
+                 "\"per_sample\":%s%s}",
+                 first ? "" : ",\n", result.benchmark, result.variant, result.voices,
+                 (unsigned long)samples, (unsigned long)result.total, perSample, voiceField);
+    } else {
+        snprintf(line, sizeof(line), "%s,%s,%u,%lu,%lu,%s,%s\n", result.benchmark, result.variant,
+                 result.voices, (unsigned long)samples, (unsigned long)result.total, perSample, perVoice);
+    }
+    write(line);
+}
+
+void SynthBenchmark::writeBudget(Writer write, uint8_t wave) {
+    // Наибольшее число голосов, для которого микшер и модулятор укладываются в бюджет
+    const uint32_t budget = budgetPerSample();
+    const uint64_t limit = (uint64_t)budget * samples;
+    uint8_t voices = 0;
+    for (uint8_t count = 1; count <= MAX_VOICES; count++) {
+        if ((uint64_t)mixCost[wave][count - 1] + outputCost <= limit) voices = count;
+    }
+    
+    char line[LINE_SIZE];
+    if (format == Format::JSON) {
+        snprintf(line, sizeof(line),
+                 ",\n{\"benchmark\":\"budget\",\"variant\":\"%s\",\"voices\":%u,\"samples\":%lu,\"per_sample\":%lu}",
+                 WAVE_NAMES[wave], voices, (unsigned long)samples, (unsigned long)budget);
+    } else {
+        snprintf(line, sizeof(line), "budget,%s,%u,%lu,,%lu,\n", WAVE_NAMES[wave], voices,
+                 (unsigned long)samples, (unsigned long)budget);
+    }
+    write(line);
+}
@@ -0,0 +1,94 @@
+#include "synthesizer/SynthSelfTest.hpp"
+#include "synthesizer/WaveSynthesizer.hpp"
+#include "synthesizer/VoicePool.hpp"
+#include "drivers/Uart.hpp"
+
+// Эталон получен сборкой на ПК (Host/Src/FixedPointCheck.cpp), меняется
+// вместе с таблицами, огибающей или сценарием
+static constexpr uint32_t EXPECTED_CHECKSUM = 0x8D4C463F;
+
+static uint32_t crc32Update(uint32_t crc, const int16_t* samples, size_t count) {
+    // Побайтно, младший байт семпла первым - как в WAV файле
+    for (size_t i = 0; i < count; i++) {
+        uint16_t value = (uint16_t)samples[i];
+        for (uint8_t b = 0; b < 2; b++) {
+            crc ^= (uint8_t)(value >> (8 * b));
+            for (uint8_t bit = 0; bit < 8; bit++) {
+                crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+            }
+        }
+    }
+    return crc;
+}
+
+static uint32_t renderInto(WaveSynthesizer& synth, uint32_t crc, uint32_t samples) {
+    int16_t block[AUDIO_BLOCK_SIZE];
+    while (samples > 0) {
+        uint32_t count = (samples > AUDIO_BLOCK_SIZE) ? AUDIO_BLOCK_SIZE : samples;
+        synth.renderBlock(block, count);
+        crc = crc32Update(crc, block, count);
+        samples -= count;
+    }
+    return crc;
+}
+
+uint32_t SynthSelfTest::renderChecksum() {
+    WaveSynthesizer& synth = WaveSynthesizer::getInstance();
+    synth.allNotesOff();
+    synth.setMasterVolume(WaveSynthesizer::MAX_VOLUME);
+    synth.setNoiseSeed(NoiseGenerator::DEFAULT_SEED);
+    
+    // Линейная огибающая: коэффициенты считаются без expf/logf, которые
+    // в разных libm могут отличаться в последнем бите
+    static const uint8_t notes[] = { 60, 64, 67, 48 };
+    static const WaveType waves[] = { WaveType::SINE, WaveType::SAWTOOTH, WaveType::SQUARE, WaveType::TRIANGLE };
+    for (uint8_t ch = 0; ch < 4; ch++) {
+        synth.noteOn(ch, notes[ch], 127 - ch * 20);
+        synth.setWaveType(ch, waves[ch]);
+        synth.setADSR(ch, ADSR(5, 20, 6, 30));
+    }
+    synth.setPitchBend(1, 25);
+    
+    // Розовый шум: целочисленный генератор голоса, зерно от setNoiseSeed
+    synth.setNoiseColor(4, NoiseColor::PINK);
+    synth.noteOn(4, 72, 60);
+    synth.setWaveType(4, WaveType::NOISE);
+    synth.setADSR(4, ADSR(2, 10, 3, 15));
+    
+    uint32_t crc = 0xFFFFFFFFu;
+    crc = renderInto(synth, crc, NOTE_SAMPLES);
+    for (uint8_t ch = 0; ch < 4; ch++) {
+        synth.noteOff(ch, notes[ch]);
+    }
+    synth.noteOff(4, 72);
+    crc = renderInto(synth, crc, RELEASE_SAMPLES);
+    
+    synth.setPitchBend(1, 0);
+    synth.setNoiseColor(4, NoiseColor::WHITE);
+    synth.allNotesOff();
+    return ~crc;
+}
+
+uint32_t SynthSelfTest::expectedChecksum() {
+    return EXPECTED_CHECKSUM;
+}
+
+bool SynthSelfTest::isChecksumComparable() {
+    // В float режиме результат зависит от FPU и порядка операций
+    return SYNTH_FIXED_POINT && WAVE_BANK_ENABLED;
+}
+
+bool SynthSelfTest::run() {
+    Uart& uart = Uart::getInstance();
+    uint32_t crc = renderChecksum();
+    
+    uart.printf("Synth self-test: kernel=%s, crc=0x%08lX\n", VoiceKernels::name(), (unsigned long)crc);
+    if (!isChecksumComparable()) {
+        uart.printf("Float mode - no reference checksum\n");
+        return true;
+    }
+    
+    bool passed = (crc == EXPECTED_CHECKSUM);
+    uart.printf("Expected 0x%08lX: %s\n", (unsigned long)EXPECTED_CHECKSUM, passed ? "OK" : "FAIL");
+    return passed;
+}
@@ -0,0 +1,277 @@
+#include "synthesizer/VoicePool.hpp"
+#include "synthesizer/WaveBank.hpp"
+#include <string.h>
+
+#if SYNTH_FIXED_POINT
+#include "synthesizer/DspMath.hpp"
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_FEATURE_DSP)
+#include "stm32f4xx_hal.h"  // CMSIS: __SMLAD
+#endif
+
+// Позиция индекса и дробной части в 32-битной фазе
+#define KERNEL_INDEX_SHIFT (32 - WAVE_TABLE_BITS)
+#define KERNEL_FRAC_SHIFT (16 - WAVE_TABLE_BITS)
+
+// Дробная часть для целочисленной интерполяции - 14 бит: веса (16384 - f, f) помещаются в int16
+#define KERNEL_FRAC14_SHIFT (32 - WAVE_TABLE_BITS - 14)
+
+// Пара соседних точек таблицы одним 32-битным чтением: младшие 16 бит - table[i],
+// старшие - table[i + 1] (little-endian, как на x86 и Cortex-M)
+static inline uint32_t loadPair(const int16_t* table) {
+    uint32_t pair;
+    memcpy(&pair, table, sizeof(pair));
+    return pair;
+}
+
+#if SYNTH_FIXED_POINT
+
+// Интерполированный семпл дорожки в Q15: a * (16384 - f) + b * f одной SMLAD (Q29) >> 14
+static inline int32_t interpolateQ15(const int16_t* table, uint32_t phase) {
+    uint32_t index = phase >> KERNEL_INDEX_SHIFT;
+    uint32_t frac = (phase >> KERNEL_FRAC14_SHIFT) & 0x3FFF;
+    return DspMath::smlad(loadPair(table + index), (frac << 16) | (16384 - frac), 0) >> 14;
+}
+
+void VoiceKernels::renderQ15(VoicePool& pool, int32_t* acc, size_t frames) {
+    const int16_t* base = WaveBank::base();
+    uint8_t lane = 0;
+    
+    // Дорожки парами: семплы пакуются в слово и умножаются на пару огибающих
+    // одной SMLAD, сумма двух Q30 произведений помещается в int32 без переполнения
+    for (; lane + 1 < pool.count; lane += 2) {
+        const int16_t* table0 = base + pool.tableOffset[lane];
+        const int16_t* table1 = base + pool.tableOffset[lane + 1];
+        const uint32_t increment0 = pool.increment[lane];
+        const uint32_t increment1 = pool.increment[lane + 1];
+        uint32_t phase0 = pool.phase[lane];
+        uint32_t phase1 = pool.phase[lane + 1];
+        
+        for (size_t i = 0; i < frames; i++) {
+            uint32_t samples = DspMath::pack16(interpolateQ15(table0, phase0), interpolateQ15(table1, phase1));
+            uint32_t gains = loadPair(&pool.gain[i][lane]);
+            acc[i] = DspMath::qadd(acc[i], DspMath::smlad(samples, gains, 0));
+            phase0 += increment0;
+            phase1 += increment1;
+        }
+        
+        pool.phase[lane] = phase0;
+        pool.phase[lane + 1] = phase1;
+    }
+    
+    // Нечетная последняя дорожка
+    if (lane < pool.count) {
+        const int16_t* table = base + pool.tableOffset[lane];
+        const uint32_t increment = pool.increment[lane];
+        uint32_t phase = pool.phase[lane];
+        
+        for (size_t i = 0; i < frames; i++) {
+            int32_t product = DspMath::mulQ15((int16_t)interpolateQ15(table, phase), pool.gain[i][lane]);
+            acc[i] = DspMath::qadd(acc[i], product);
+            phase += increment;
+        }
+        
+        pool.phase[lane] = phase;
+    }
+}
+
+const char* VoiceKernels::name() {
+#if DSP_MATH_INTRINSICS
+    return "Q15 Cortex-M4 DSP";
+#else
+    return "Q15 portable";
+#endif
+}
+
+uint8_t VoiceKernels::minVoices() {
+    // Q15 табличные голоса всегда идут через пул - другого ядра нет
+    return 1;
+}
+
+#else
+
+static constexpr float FRAC_SCALE = 1.0f / 65536.0f;
+static constexpr float SAMPLE_SCALE = 1.0f / 32768.0f;
+
+void VoiceKernels::renderScalar(VoicePool& pool, uint8_t firstLane, float* out, size_t frames) {
+    const int16_t* base = WaveBank::base();
+    
+    for (uint8_t lane = firstLane; lane < pool.count; lane++) {
+        const int16_t* table = base + pool.tableOffset[lane];
+        const uint32_t increment = pool.increment[lane];
+        uint32_t phase = pool.phase[lane];
+        
+        for (size_t i = 0; i < frames; i++) {
+            uint32_t index = phase >> KERNEL_INDEX_SHIFT;
+            float frac = (float)((phase >> KERNEL_FRAC_SHIFT) & 0xFFFF) * FRAC_SCALE;
+            float a = (float)table[index];
+            float b = (float)table[index + 1];
+            out[i] += (a + (b - a) * frac) * SAMPLE_SCALE * pool.gain[i][lane];
+            phase += increment;
+        }
+        
+        pool.phase[lane] = phase;
+    }
+}
+
+#if defined(__AVX2__)
+
+static inline float horizontalSum(__m256 v) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+    return _mm_cvtss_f32(sum);
+}
+
+void VoiceKernels::render(VoicePool& pool, float* out, size_t frames) {
+    const int* base = (const int*)WaveBank::base();
+    const __m256i fracMask = _mm256_set1_epi32(0xFFFF);
+    const __m256 fracScale = _mm256_set1_ps(FRAC_SCALE);
+    const uint8_t vectorLanes = pool.count & ~7;
+    
+    for (size_t i = 0; i < frames; i++) {
+        // Все группы по 8 голосов копятся в одном векторе - одна горизонтальная сумма на семпл
+        __m256 sum = _mm256_setzero_ps();
+        for (uint8_t lane = 0; lane < vectorLanes; lane += 8) {
+            __m256i phase = _mm256_load_si256((const __m256i*)&pool.phase[lane]);
+            const __m256i offset = _mm256_load_si256((const __m256i*)&pool.tableOffset[lane]);
+            
+            // Индекс и gather пары точек (смещение в семплах, масштаб 2 байта)
+            __m256i index = _mm256_add_epi32(offset, _mm256_srli_epi32(phase, KERNEL_INDEX_SHIFT));
+            __m256i pair = _mm256_i32gather_epi32(base, index, 2);
+            __m256 a = _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(pair, 16), 16));
+            __m256 b = _mm256_cvtepi32_ps(_mm256_srai_epi32(pair, 16));
+            __m256 frac = _mm256_mul_ps(_mm256_cvtepi32_ps(
+                _mm256_and_si256(_mm256_srli_epi32(phase, KERNEL_FRAC_SHIFT), fracMask)), fracScale);
+            
+            __m256 sample = _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), frac));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(sample, _mm256_load_ps(&pool.gain[i][lane])));
+            
+            phase = _mm256_add_epi32(phase, _mm256_load_si256((const __m256i*)&pool.increment[lane]));
+            _mm256_store_si256((__m256i*)&pool.phase[lane], phase);
+        }
+        out[i] += horizontalSum(sum) * SAMPLE_SCALE;
+    }
+    
+    renderScalar(pool, vectorLanes, out, frames);
+}
+
+const char* VoiceKernels::name() {
+    return "AVX2";
+}
+
+uint8_t VoiceKernels::minVoices() {
+    // 1-12 голосов: 0.8x от рендеринга по одному (неполные 8 дорожек, gather),
+    // 16-20 - 1.0x, с 24 - 1.06-1.14x
+    return 24;
+}
+
+#elif defined(__SSE2__)
+
+static inline float horizontalSum(__m128 v) {
+    __m128 sum = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+    return _mm_cvtss_f32(sum);
+}
+
+void VoiceKernels::render(VoicePool& pool, float* out, size_t frames) {
+    const int16_t* base = WaveBank::base();
+    const __m128i fracMask = _mm_set1_epi32(0xFFFF);
+    const __m128 fracScale = _mm_set1_ps(FRAC_SCALE);
+    const uint8_t vectorLanes = pool.count & ~3;
+    alignas(16) uint32_t index[4];
+    
+    for (size_t i = 0; i < frames; i++) {
+        // Все группы по 4 голоса копятся в одном векторе - одна горизонтальная сумма на семпл
+        __m128 sum = _mm_setzero_ps();
+        for (uint8_t lane = 0; lane < vectorLanes; lane += 4) {
+            __m128i phase = _mm_load_si128((const __m128i*)&pool.phase[lane]);
+            const __m128i offset = _mm_load_si128((const __m128i*)&pool.tableOffset[lane]);
+            
+            // В SSE2 нет gather - 4 скалярных чтения пар, остальное векторно
+            _mm_store_si128((__m128i*)index, _mm_add_epi32(offset, _mm_srli_epi32(phase, KERNEL_INDEX_SHIFT)));
+            __m128i pair = _mm_set_epi32((int)loadPair(base + index[3]), (int)loadPair(base + index[2]),
+                                         (int)loadPair(base + index[1]), (int)loadPair(base + index[0]));
+            __m128 a = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(pair, 16), 16));
+            __m128 b = _mm_cvtepi32_ps(_mm_srai_epi32(pair, 16));
+            __m128 frac = _mm_mul_ps(_mm_cvtepi32_ps(
+                _mm_and_si128(_mm_srli_epi32(phase, KERNEL_FRAC_SHIFT), fracMask)), fracScale);
+            
+            __m128 sample = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), frac));
+            sum = _mm_add_ps(sum, _mm_mul_ps(sample, _mm_load_ps(&pool.gain[i][lane])));
+            
+            phase = _mm_add_epi32(phase, _mm_load_si128((const __m128i*)&pool.increment[lane]));
+            _mm_store_si128((__m128i*)&pool.phase[lane], phase);
+        }
+        out[i] += horizontalSum(sum) * SAMPLE_SCALE;
+    }
+    
+    renderScalar(pool, vectorLanes, out, frames);
+}
+
+const char* VoiceKernels::name() {
+    return "SSE2";
+}
+
+uint8_t VoiceKernels::minVoices() {
+    // 1-3 голоса: 0.75-0.83x от рендеринга по одному, 4-6 - 1.0-1.1x,
+    // с 8 - 1.1-1.5x (32 голоса)
+    return 8;
+}
+
+#elif defined(__ARM_FEATURE_DSP)
+
+static constexpr float Q29_SCALE = 1.0f / 536870912.0f;
+
+void VoiceKernels::render(VoicePool& pool, float* out, size_t frames) {
+    const int16_t* base = WaveBank::base();
+    
+    for (uint8_t lane = 0; lane < pool.count; lane++) {
+        const int16_t* table = base + pool.tableOffset[lane];
+        const uint32_t increment = pool.increment[lane];
+        uint32_t phase = pool.phase[lane];
+        
+        for (size_t i = 0; i < frames; i++) {
+            uint32_t index = phase >> KERNEL_INDEX_SHIFT;
+            uint32_t frac = (phase >> KERNEL_FRAC14_SHIFT) & 0x3FFF;
+            
+            // a * (16384 - f) + b * f - обе точки одной инструкцией SMLAD, результат Q29
+            int32_t sample = (int32_t)__SMLAD(loadPair(table + index), (frac << 16) | (16384 - frac), 0);
+            out[i] += (float)sample * Q29_SCALE * pool.gain[i][lane];
+            phase += increment;
+        }
+        
+        pool.phase[lane] = phase;
+    }
+}
+
+const char* VoiceKernels::name() {
+    return "Cortex-M4 DSP";
+}
+
+uint8_t VoiceKernels::minVoices() {
+    // Дорожки идут по одной, как в renderVoice: выигрыш на плате не измерен
+    return VOICE_POOL_CAPACITY + 1;
+}
+
+#else
+
+void VoiceKernels::render(VoicePool& pool, float* out, size_t frames) {
+    renderScalar(pool, 0, out, frames);
+}
+
+const char* VoiceKernels::name() {
+    return "scalar";
+}
+
+uint8_t VoiceKernels::minVoices() {
+    // Та же работа, что у renderVoice - пул не нужен
+    return VOICE_POOL_CAPACITY + 1;
+}
+
+#endif
+
+#endif // SYNTH_FIXED_POINT
@@ -1,91 +1,357 @@
 #include "synthesizer/WaveSynthesizer.hpp"
+#include "synthesizer/WaveBank.hpp"
+#include "synthesizer/VoicePool.hpp"
 #include <math.h>
+#include <algorithm>
+
+static_assert(WaveSynthesizer::MAX_VOICES <= VOICE_POOL_CAPACITY, "VoicePool is smaller than MAX_VOICES");
 
 // Реализация VoiceMixer
-VoiceMixer& VoiceMixer::getInstance() {
-    static VoiceMixer instance;
-    return instance;
+float VoiceMixer::mixVoices(Voice* voices, uint8_t voiceCount) {
+    float mixedSample;
+    mixBlock(voices, voiceCount, &mixedSample, 1);
+    return mixedSample;
 }
 
-float VoiceMixer::mixVoices(Voice* voices, uint8_t voiceCount) {
-    float mixedSample = 0.0f;
-    uint8_t activeVoices = 0;
+void VoiceMixer::mixBlock(Voice* voices, uint8_t voiceCount, float* out, size_t frames) {
+    // Собираем список активных голосов и микшируем по нему
+    uint8_t activeList[WaveSynthesizer::MAX_VOICES];
+    uint8_t activeCount = 0;
+    for (uint8_t v = 0; v < voiceCount && activeCount < WaveSynthesizer::MAX_VOICES; v++) {
+        if (voices[v].active) {
+            activeList[activeCount++] = v;
+        }
+    }
+    mixBlock(voices, activeList, activeCount, out, frames);
+}
+
+// Нормализация 1/N идет по семплам, а не на блок, и голоса в N весят по
+// громкости: 1 при огибающей от NORM_KNEE (-42 дБ), тише - пропорционально
+// огибающей. Затихающий голос (конец релиза, нулевой сустейн) перестает
+// приглушать остальные плавно, громкость не зависит от AUDIO_BLOCK_SIZE и
+// нарезки блока по событиям, а Q15 и float огибающие, затихающие в чуть
+// разные семплы, звучат одинаково. Вес голоса не меньше его огибающей -
+// сумма после нормализации в пределах 1.0. Рост N снижает усиление сразу,
+// спад - поднимает не быстрее чем на всю шкалу за NORM_RAMP_SAMPLES
+static constexpr uint32_t NORM_RAMP_SAMPLES = 512;
+
+// Вес голоса за блок: внутри блока огибающая сначала растет (атака), потом
+// падает (спад, релиз) - если оба конца не тише колена, вес всего блока 1.
+// Полные веса считаются целыми (steady, full), дробные - суммой в weights:
+// порядок сложения не зависит от нарезки блока, N побитно то же
+template<typename Gain, typename Weight>
+static void addWeights(const Gain* gains, size_t frames, size_t stride, Gain knee, Weight one,
+                       uint8_t& steady, uint8_t* full, Weight* weights) {
+    if (frames == 0) return;
+    if (gains[0] >= knee && gains[(frames - 1) * stride] >= knee) {
+        steady++;
+        return;
+    }
+    for (size_t i = 0; i < frames; i++) {
+        const Gain gain = gains[i * stride];
+        if (gain >= knee) {
+            full[i]++;
+        } else {
+            weights[i] += (Weight)(gain * (one / knee));
+        }
+    }
+}
+
+#if SYNTH_FIXED_POINT
+
+static constexpr float Q15_SCALE = 1.0f / 32768.0f;
+
+void VoiceMixer::mixBlock(Voice* voices, const uint8_t* activeList, uint8_t activeCount,
+                          float* out, size_t frames) {
+    // Родной формат - Q15, float получается преобразованием
+    int16_t block[AUDIO_BLOCK_SIZE];
+    while (frames > 0) {
+        size_t count = (frames > AUDIO_BLOCK_SIZE) ? AUDIO_BLOCK_SIZE : frames;
+        mixBlockQ15(voices, activeList, activeCount, block, count);
+        for (size_t i = 0; i < count; i++) {
+            out[i] = (float)block[i] * Q15_SCALE;
+        }
+        out += count;
+        frames -= count;
+    }
+}
+
+void VoiceMixer::mixBlockQ15(Voice* voices, const uint8_t* activeList, uint8_t activeCount,
+                             int16_t* out, size_t frames) {
+    while (frames > AUDIO_BLOCK_SIZE) {
+        mixBlockQ15(voices, activeList, activeCount, out, AUDIO_BLOCK_SIZE);
+        out += AUDIO_BLOCK_SIZE;
+        frames -= AUDIO_BLOCK_SIZE;
+    }
     
-    // Смешиваем все активные голоса
-    for (uint8_t i = 0; i < voiceCount; i++) {
-        if (voices[i].active) {
-            float sample = generateWaveSample(voices[i]);
-            float adsrVolume = applyADSR(voices[i], sample);
-            
-            if (adsrVolume > 0.0f) {
-                mixedSample += adsrVolume;
-                activeVoices++;
+    // Нормализация заранее умножается на огибающую - по верхней оценке N на
+    // блок (атака - вес 1, остальные стадии не растут): сумма остается в
+    // пределах 1.0 и аккумулятор не уходит в насыщение. Усиление по семплам
+    // (normGain) применяется в конце как normGain / norm
+    int32_t bound = 0;
+    for (uint8_t v = 0; v < activeCount; v++) {
+        const Voice& voice = voices[activeList[v]];
+        if (!voice.active) continue;
+        const int16_t level = voice.envelope.getLevelQ15();
+        if (voice.envelope.getStage() == EnvelopeStage::ATTACK || level >= NORM_KNEE) {
+            bound += NORM_ONE;
+        } else {
+            bound += level * (NORM_ONE / NORM_KNEE);
+        }
+    }
+    const int32_t norm = NORM_ONE * NORM_ONE / ((bound > NORM_ONE) ? bound : NORM_ONE);
+    
+    // Вес голосов в N (Q15): steady - с весом 1 весь блок, full[i] - в семпле i,
+    // weights[i] - дробные веса остальных
+    uint8_t steady = 0;
+    uint8_t full[AUDIO_BLOCK_SIZE] = {};
+    int32_t weights[AUDIO_BLOCK_SIZE] = {};
+    for (size_t i = 0; i < frames; i++) {
+        accumulator[i] = 0;
+    }
+    
+    voicePool.clear();
+    for (uint8_t v = 0; v < activeCount; v++) {
+        Voice& voice = voices[activeList[v]];
+        if (!voice.active) continue;
+        
+        // Табличные голоса всегда идут через пул: Q15 ядро у них одно
+#if WAVE_BANK_ENABLED
+        if (voice.waveType != WaveType::NOISE) {
+            uint8_t lane = voicePool.add(activeList[v], voice.phase, voice.phaseIncrement,
+                                         WaveBank::tableOffset(voice.waveType, voice.phaseIncrement));
+            int16_t* gains = &voicePool.gain[0][lane];
+            voice.envelope.processQ15(gains, frames, VOICE_POOL_CAPACITY);
+            addWeights(gains, frames, VOICE_POOL_CAPACITY, NORM_KNEE, NORM_ONE, steady, full, weights);
+            for (size_t i = 0; i < frames; i++) {
+                gains[i * VOICE_POOL_CAPACITY] = (int16_t)((gains[i * VOICE_POOL_CAPACITY] * norm) >> 15);
             }
+        } else
+#endif
+        {
+            voice.envelope.processQ15(envelopeBuffer, frames);
+            addWeights(envelopeBuffer, frames, 1, NORM_KNEE, NORM_ONE, steady, full, weights);
+            for (size_t i = 0; i < frames; i++) {
+                envelopeBuffer[i] = (int16_t)((envelopeBuffer[i] * norm) >> 15);
+            }
+            renderVoiceQ15(voice, accumulator, frames, envelopeBuffer);
+        }
+        
+        // Релиз завершен - голос помечается свободным
+        if (voice.envelope.isFinished()) {
+            voice.active = false;
         }
     }
     
-    // Нормализация для предотвращения клиппинга
-    if (activeVoices > 0) {
-        mixedSample /= activeVoices;
-        // Ограничиваем амплитуду
-        if (mixedSample > 1.0f) mixedSample = 1.0f;
-        if (mixedSample < -1.0f) mixedSample = -1.0f;
+    if (voicePool.count > 0) {
+        VoiceKernels::renderQ15(voicePool, accumulator, frames);
+        for (uint8_t lane = 0; lane < voicePool.count; lane++) {
+            voices[voicePool.voice[lane]].phase = voicePool.phase[lane];
+        }
     }
     
-    return mixedSample;
+    // Q30 -> Q15 с насыщением; в установившемся режиме normGain == norm
+    const int32_t step = NORM_ONE / NORM_RAMP_SAMPLES;
+    int32_t count = -1;
+    int32_t target = NORM_ONE;
+    for (size_t i = 0; i < frames; i++) {
+        const int32_t n = (steady + full[i]) * NORM_ONE + weights[i];
+        if (n != count) {
+            count = n;
+            target = NORM_ONE * NORM_ONE / ((n > NORM_ONE) ? n : NORM_ONE);
+        }
+        // В тишине подъему нечего щелкать - усиление сразу к цели, звук после
+        // паузы не зависит от того, что играло до нее
+        if (n == 0 || target < normGain) {
+            normGain = target;
+        } else {
+            normGain = std::min(normGain + step, target);
+        }
+        
+        int32_t sample = DspMath::ssat16(accumulator[i] >> 15);
+        if (normGain != norm) {
+            sample = sample * normGain / norm;
+        }
+        out[i] = DspMath::ssat16(sample);
+    }
 }
 
-float VoiceMixer::applyADSR(const Voice& voice, float sample) {
-    float adsrVolume = calculateADSRVolume(voice);
-    return sample * adsrVolume;
+void VoiceMixer::renderVoiceQ15(Voice& voice, int32_t* acc, size_t frames, const int16_t* gains) {
+    // Шум голоса уже в Q15
+    if (voice.waveType == WaveType::NOISE) {
+        int16_t noise[AUDIO_BLOCK_SIZE];
+        voice.noise.process(noise, frames);
+        for (size_t i = 0; i < frames; i++) {
+            acc[i] = DspMath::qadd(acc[i], DspMath::mulQ15(noise[i], gains[i]));
+        }
+        return;
+    }
+    
+    // Медленный путь: осциллятор в float, семпл переводится в Q15
+    WaveGenerator& waveGen = WaveGenerator::getInstance();
+    const uint32_t increment = voice.phaseIncrement;
+    uint32_t phase = voice.phase;
+    
+    for (size_t i = 0; i < frames; i++) {
+        int16_t sample = DspMath::ssat16((int32_t)(waveGen.generateWave(voice.waveType, phase, increment) * 32767.0f));
+        acc[i] = DspMath::qadd(acc[i], DspMath::mulQ15(sample, gains[i]));
+        phase += increment;
+    }
+    
+    voice.phase = phase;
 }
 
-float VoiceMixer::calculateADSRVolume(const Voice& voice) {
-    uint32_t currentTime = HAL_GetTick();
-    uint32_t elapsed = currentTime - voice.startTime;
+#else
+
+void VoiceMixer::mixBlock(Voice* voices, const uint8_t* activeList, uint8_t activeCount,
+                          float* out, size_t frames) {
+    // Буфер огибающей рассчитан на AUDIO_BLOCK_SIZE - длинные буферы режем
+    while (frames > AUDIO_BLOCK_SIZE) {
+        mixBlock(voices, activeList, activeCount, out, AUDIO_BLOCK_SIZE);
+        out += AUDIO_BLOCK_SIZE;
+        frames -= AUDIO_BLOCK_SIZE;
+    }
     
-    float baseVolume = (float)voice.velocity / 127.0f;
-    float adsrVolume = baseVolume;
+    // Вес голосов в N: steady - с весом 1 весь блок, full[i] - в семпле i,
+    // weights[i] - дробные веса остальных
+    uint8_t steady = 0;
+    uint8_t full[AUDIO_BLOCK_SIZE] = {};
+    float weights[AUDIO_BLOCK_SIZE] = {};
+    for (size_t i = 0; i < frames; i++) {
+        out[i] = 0.0f;
+    }
     
-    if (voice.released) {
-        // Фаза Release
-        uint32_t releaseElapsed = currentTime - voice.releaseTime;
-        if (releaseElapsed >= voice.adsr.release) {
-            return 0.0f; // Голос должен быть отключен
-        }
-        // Линейное затухание в фазе Release
-        adsrVolume = baseVolume * ((float)voice.adsr.sustain / 10.0f) * 
-                     (1.0f - (float)releaseElapsed / voice.adsr.release);
-    } else {
-        // Фазы Attack, Decay, Sustain
-        if (elapsed < voice.adsr.attack) {
-            // Фаза Attack
-            adsrVolume = baseVolume * ((float)elapsed / voice.adsr.attack);
-        } else if (elapsed < voice.adsr.attack + voice.adsr.decay) {
-            // Фаза Decay
-            uint32_t decayElapsed = elapsed - voice.adsr.attack;
-            float sustainLevel = (float)voice.adsr.sustain / 10.0f;
-            adsrVolume = baseVolume - (baseVolume - sustainLevel) * 
-                        ((float)decayElapsed / voice.adsr.decay);
-        } else {
-            // Фаза Sustain
-            adsrVolume = baseVolume * ((float)voice.adsr.sustain / 10.0f);
+    // Пул окупается только с soaMinVoices голосов (VoiceKernels::minVoices)
+    const bool useSoa = soaEnabled && activeCount >= soaMinVoices;
+    voicePool.clear();
+    for (uint8_t v = 0; v < activeCount; v++) {
+        Voice& voice = voices[activeList[v]];
+        if (!voice.active) continue;
+        
+        // Огибающая продвигается по семплам: level = level * mul + add
+#if WAVE_BANK_ENABLED
+        if (useSoa && voice.waveType != WaveType::NOISE) {
+            // Табличный голос - в дорожку SoA пула, рендерится ниже вместе с остальными
+            uint8_t lane = voicePool.add(activeList[v], voice.phase, voice.phaseIncrement,
+                                         WaveBank::tableOffset(voice.waveType, voice.phaseIncrement));
+            float* gains = &voicePool.gain[0][lane];
+            voice.envelope.process(gains, frames, VOICE_POOL_CAPACITY);
+            addWeights(gains, frames, VOICE_POOL_CAPACITY, NORM_KNEE, NORM_ONE, steady, full, weights);
+        } else
+#endif
+        {
+            voice.envelope.process(envelopeBuffer, frames);
+            addWeights(envelopeBuffer, frames, 1, NORM_KNEE, NORM_ONE, steady, full, weights);
+            renderVoice(voice, out, frames, envelopeBuffer);
+        }
+        
+        // Релиз завершен - голос помечается свободным
+        if (voice.envelope.isFinished()) {
+            voice.active = false;
         }
     }
     
-    return adsrVolume;
+    if (voicePool.count > 0) {
+        VoiceKernels::render(voicePool, out, frames);
+        for (uint8_t lane = 0; lane < voicePool.count; lane++) {
+            voices[voicePool.voice[lane]].phase = voicePool.phase[lane];
+        }
+    }
+    
+    // Нормализация для предотвращения клиппинга: 1/N звучащих в этом семпле
+    const float step = NORM_ONE / NORM_RAMP_SAMPLES;
+    float count = -1.0f;
+    float target = NORM_ONE;
+    for (size_t i = 0; i < frames; i++) {
+        const float n = (float)(steady + full[i]) + weights[i];
+        if (n != count) {
+            count = n;
+            target = NORM_ONE / ((n > NORM_ONE) ? n : NORM_ONE);
+        }
+        if (n == 0 || target < normGain) {
+            normGain = target;
+        } else {
+            normGain = std::min(normGain + step, target);
+        }
+        
+        float sample = out[i] * normGain;
+        // Ограничиваем амплитуду
+        if (sample > 1.0f) sample = 1.0f;
+        if (sample < -1.0f) sample = -1.0f;
+        out[i] = sample;
+    }
 }
 
-float VoiceMixer::generateWaveSample(const Voice& voice) {
+template<typename Oscillator>
+uint32_t VoiceMixer::renderLoop(Oscillator osc, float* out, size_t frames, uint32_t phase,
+                                uint32_t increment, const float* gains) {
+    for (size_t i = 0; i < frames; i++) {
+        out[i] += osc(phase, increment) * gains[i];
+        phase += increment; // Переполнение uint32_t = заворот фазы
+    }
+    return phase;
+}
+
+void VoiceMixer::renderVoice(Voice& voice, float* out, size_t frames, const float* gains) {
     WaveGenerator& waveGen = WaveGenerator::getInstance();
-    
-    // Генерируем волну
-    float sample = waveGen.generateWave(voice.waveType, voice.phase);
-    
-    // Добавляем гармоники для более богатого звука
+    const uint32_t increment = voice.phaseIncrement;
+    uint32_t phase = voice.phase;
+
+#if WAVE_BANK_ENABLED
+    // Таблица полосы выбирается один раз на блок по приращению фазы
     if (voice.waveType != WaveType::NOISE) {
-        sample = waveGen.generateWithHarmonics(voice.waveType, voice.phase, 4);
+        const int16_t* table = WaveBank::selectTable(voice.waveType, increment);
+        voice.phase = renderLoop([table](uint32_t p, uint32_t) { return WaveBank::read(table, p); },
+                                 out, frames, phase, increment, gains);
+        return;
     }
+#endif
     
-    return sample;
+    // Выбор осциллятора вынесен из цикла по семплам
+    switch (voice.waveType) {
+        case WaveType::SQUARE:
+            phase = renderLoop([&waveGen](uint32_t p, uint32_t inc) { return waveGen.generateSquare(p, inc); },
+                               out, frames, phase, increment, gains);
+            break;
+        case WaveType::SAWTOOTH:
+            phase = renderLoop([&waveGen](uint32_t p, uint32_t inc) { return waveGen.generateSawtooth(p, inc); },
+                               out, frames, phase, increment, gains);
+            break;
+        case WaveType::TRIANGLE:
+            phase = renderLoop([&waveGen](uint32_t p, uint32_t inc) { return waveGen.generateTriangle(p, inc); },
+                               out, frames, phase, increment, gains);
+            break;
+        case WaveType::NOISE: {
+            // Генератор шума голоса, блок целиком (frames <= AUDIO_BLOCK_SIZE)
+            int16_t noise[AUDIO_BLOCK_SIZE];
+            voice.noise.process(noise, frames);
+            for (size_t i = 0; i < frames; i++) {
+                out[i] += (float)noise[i] * (1.0f / 32768.0f) * gains[i];
+            }
+            break;
+        }
+        case WaveType::SINE:
+        default:
+            phase = renderLoop([&waveGen](uint32_t p, uint32_t) { return waveGen.generateSine(p); },
+                               out, frames, phase, increment, gains);
+            break;
+    }
+    
+    voice.phase = phase;
+}
+
+#endif // SYNTH_FIXED_POINT
+
+float VoiceMixer::applyADSR(const Voice& voice, float sample) {
+    float adsrVolume = calculateADSRVolume(voice);
+    return sample * adsrVolume;
+}
+
+float VoiceMixer::calculateADSRVolume(const Voice& voice) {
+    return voice.envelope.getLevel();
+}
+
+float VoiceMixer::generateWaveSample(const Voice& voice) {
+    // Прямоугольная, пила и треугольник - ограниченные по полосе (WaveBank или PolyBLEP)
+    return WaveGenerator::getInstance().generateWave(voice.waveType, voice.phase, voice.phaseIncrement);
 }
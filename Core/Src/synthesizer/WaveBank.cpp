@@ -0,0 +1,132 @@
+#include "synthesizer/WaveBank.hpp"
+
+// Генерация таблиц на этапе компиляции (C++14 constexpr).
+// Гармоники суммируются через индексы в таблице синуса: sin(h*x_n) = sin[(h*n) mod N],
+// поэтому на этапе компиляции синус считается только N раз.
+
+static constexpr double PI = 3.14159265358979323846;
+static constexpr uint32_t TABLE_MASK = WAVE_TABLE_SIZE - 1;
+
+// Ряд Тейлора для |x| <= π/2
+static constexpr double sinTaylor(double x) {
+    double term = x;
+    double sum = x;
+    for (int i = 1; i < 14; i++) {
+        term *= -x * x / ((2.0 * i) * (2.0 * i + 1.0));
+        sum += term;
+    }
+    return sum;
+}
+
+struct SineTable {
+    double value[WAVE_TABLE_SIZE];
+};
+
+static constexpr SineTable makeSineTable() {
+    SineTable table = {};
+    for (uint32_t n = 0; n < WAVE_TABLE_SIZE; n++) {
+        // Сводим к первой четверти периода
+        uint32_t m = n % (WAVE_TABLE_SIZE / 2);
+        if (m > WAVE_TABLE_SIZE / 4) m = WAVE_TABLE_SIZE / 2 - m;
+        double s = sinTaylor(2.0 * PI * m / WAVE_TABLE_SIZE);
+        table.value[n] = (n < WAVE_TABLE_SIZE / 2) ? s : -s;
+    }
+    return table;
+}
+
+static constexpr SineTable SINE = makeSineTable();
+
+static constexpr int16_t toQ15(double x) {
+    double scaled = x * 32767.0;
+    scaled += (scaled >= 0.0) ? 0.5 : -0.5;
+    if (scaled > 32767.0) scaled = 32767.0;
+    if (scaled < -32768.0) scaled = -32768.0;
+    return (int16_t)scaled;
+}
+
+// Амплитуда гармоники h (0 - гармоника отсутствует).
+// Знаки и фазы совпадают с наивными формами WaveGenerator:
+// пила растет от -1, прямоугольная +1 в первой половине, треугольник от -1.
+static constexpr double harmonicAmplitude(WaveType type, uint32_t h) {
+    switch (type) {
+        case WaveType::SAWTOOTH:
+            return -(2.0 / PI) / h;
+        case WaveType::SQUARE:
+            return (h & 1) ? (4.0 / PI) / h : 0.0;
+        case WaveType::TRIANGLE:
+            return (h & 1) ? -(8.0 / (PI * PI)) / ((double)h * h) : 0.0;
+        default:
+            return 0.0;
+    }
+}
+
+// Общий масштаб на форму, чтобы громкость не прыгала между полосами
+static constexpr double bandScale(WaveType type) {
+    return (type == WaveType::SQUARE) ? WaveBank::SQUARE_SCALE :
+           (type == WaveType::SAWTOOTH) ? WaveBank::SAWTOOTH_SCALE : 1.0;
+}
+
+static constexpr uint32_t bandHarmonics(uint32_t band) {
+    uint32_t harmonics = (uint32_t)1 << ((WAVE_TABLE_BITS - 1) - band);
+    return (harmonics > WAVE_BANK_MAX_HARMONICS) ? WAVE_BANK_MAX_HARMONICS : harmonics;
+}
+
+// Полосы вложены: каждая следующая вниз по частоте содержит гармоники
+// предыдущей, поэтому гармоники добавляются в один накопитель по возрастанию,
+// а таблица полосы снимается, когда набрано ее число гармоник
+static constexpr WaveBandTables makeBandTables(WaveType type) {
+    WaveBandTables tables = {};
+    SineTable acc = {};
+    // Треугольник - косинусный ряд: сдвиг на четверть периода
+    const uint32_t offset = (type == WaveType::TRIANGLE) ? WAVE_TABLE_SIZE / 4 : 0;
+    
+    uint32_t h = 1;
+    for (int32_t b = WAVE_BANK_BANDS - 1; b >= 0; b--) {
+        for (; h <= bandHarmonics(b); h++) {
+            double amplitude = harmonicAmplitude(type, h);
+            if (amplitude == 0.0) continue;
+            for (uint32_t n = 0; n < WAVE_TABLE_SIZE; n++) {
+                acc.value[n] += amplitude * SINE.value[(h * n + offset) & TABLE_MASK];
+            }
+        }
+        for (uint32_t n = 0; n < WAVE_TABLE_SIZE; n++) {
+            tables.band[b].data[n] = toQ15(acc.value[n] * bandScale(type));
+        }
+        tables.band[b].data[WAVE_TABLE_SIZE] = tables.band[b].data[0];
+    }
+    return tables;
+}
+
+static constexpr WaveTable makeSineWaveTable() {
+    WaveTable table = {};
+    for (uint32_t n = 0; n < WAVE_TABLE_SIZE; n++) {
+        table.data[n] = toQ15(SINE.value[n]);
+    }
+    table.data[WAVE_TABLE_SIZE] = table.data[0];
+    return table;
+}
+
+// constexpr-переменные гарантируют вычисление при компиляции
+// (иначе компилятор мог бы молча перенести инициализацию в рантайм)
+static constexpr WaveBankTables BANK_TABLES = {
+    makeSineWaveTable(),
+    makeBandTables(WaveType::SQUARE),
+    makeBandTables(WaveType::SAWTOOTH),
+    makeBandTables(WaveType::TRIANGLE)
+};
+
+const WaveBankTables WaveBank::tables = BANK_TABLES;
+
+const int16_t* WaveBank::selectTable(WaveType type, uint32_t increment) {
+    switch (type) {
+        case WaveType::SQUARE:
+            return tables.square.band[bandForIncrement(increment)].data;
+        case WaveType::SAWTOOTH:
+            return tables.sawtooth.band[bandForIncrement(increment)].data;
+        case WaveType::TRIANGLE:
+            return tables.triangle.band[bandForIncrement(increment)].data;
+        case WaveType::SINE:
+        default:
+            return tables.sine.data;
+    }
+}
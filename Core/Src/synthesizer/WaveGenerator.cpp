@@ -1,6 +1,33 @@
 #include "synthesizer/WaveSynthesizer.hpp"
+#include "synthesizer/WaveBank.hpp"
 #include <math.h>
-#include <stdlib.h>
+
+// Поправки PolyBLEP/PolyBLAMP: t - фаза [0, 1), dt - приращение фазы за семпл
+static inline float polyBlep(float t, float dt) {
+    if (t < dt) {
+        t /= dt;
+        return t + t - t * t - 1.0f;
+    } else if (t > 1.0f - dt) {
+        t = (t - 1.0f) / dt;
+        return t * t + t + t + 1.0f;
+    }
+    return 0.0f;
+}
+
+static inline float polyBlamp(float t, float dt) {
+    if (t < dt) {
+        t = t / dt - 1.0f;
+        return -(1.0f / 3.0f) * t * t * t;
+    } else if (t > 1.0f - dt) {
+        t = (t - 1.0f) / dt + 1.0f;
+        return (1.0f / 3.0f) * t * t * t;
+    }
+    return 0.0f;
+}
+
+static inline float phaseToUnit(uint32_t phase) {
+    return (float)phase * (1.0f / PHASE_RANGE);
+}
 
 // Реализация WaveGenerator
 WaveGenerator& WaveGenerator::getInstance() {
@@ -8,43 +35,65 @@ WaveGenerator& WaveGenerator::getInstance() {
     return instance;
 }
 
-float WaveGenerator::generateSine(float phase) {
-    return sinf(phase);
+float WaveGenerator::generateSine(uint32_t phase) {
+    // Старшие биты фазы - индекс в таблице, младшие - доля для интерполяции
+    return WaveBank::read(WaveBank::tables.sine.data, phase);
 }
 
-float WaveGenerator::generateSquare(float phase) {
-    return (sinf(phase) >= 0.0f) ? 1.0f : -1.0f;
+float WaveGenerator::generateSquare(uint32_t phase) {
+    // Первая половина периода - +1, вторая - -1
+    return (phase < 0x80000000u) ? 1.0f : -1.0f;
 }
 
-float WaveGenerator::generateSawtooth(float phase) {
-    // Нормализуем фазу к [0, 2π]
-    while (phase < 0.0f) phase += 2.0f * M_PI;
-    while (phase >= 2.0f * M_PI) phase -= 2.0f * M_PI;
-    
+float WaveGenerator::generateSawtooth(uint32_t phase) {
     // Пилообразная волна: линейное нарастание от -1 до 1
-    return 2.0f * (phase / (2.0f * M_PI)) - 1.0f;
+    return (float)(int32_t)(phase + 0x80000000u) * (1.0f / 2147483648.0f);
 }
 
-float WaveGenerator::generateTriangle(float phase) {
-    // Нормализуем фазу к [0, 2π]
-    while (phase < 0.0f) phase += 2.0f * M_PI;
-    while (phase >= 2.0f * M_PI) phase -= 2.0f * M_PI;
+float WaveGenerator::generateTriangle(uint32_t phase) {
+    // x в диапазоне [0, 4) на период
+    float x = (float)phase * (1.0f / 1073741824.0f);
     
-    if (phase < M_PI) {
+    if (x < 2.0f) {
         // Восходящий треугольник: от -1 до 1
-        return 2.0f * (phase / M_PI) - 1.0f;
+        return x - 1.0f;
     } else {
         // Нисходящий треугольник: от 1 до -1
-        return 3.0f - 2.0f * (phase / M_PI);
+        return 3.0f - x;
     }
 }
 
+float WaveGenerator::generateSquare(uint32_t phase, uint32_t increment) {
+    float t = phaseToUnit(phase);
+    float dt = phaseToUnit(increment);
+    // Сглаживаем фронт в начале периода и спад в середине; громкость как у таблиц WaveBank
+    return (float)WaveBank::SQUARE_SCALE *
+           (generateSquare(phase) + polyBlep(t, dt) - polyBlep(phaseToUnit(phase + 0x80000000u), dt));
+}
+
+float WaveGenerator::generateSawtooth(uint32_t phase, uint32_t increment) {
+    // Сглаживаем спад в конце периода; громкость как у таблиц WaveBank
+    return (float)WaveBank::SAWTOOTH_SCALE *
+           (generateSawtooth(phase) - polyBlep(phaseToUnit(phase), phaseToUnit(increment)));
+}
+
+float WaveGenerator::generateTriangle(uint32_t phase, uint32_t increment) {
+    float dt = phaseToUnit(increment);
+    // Излом наклона 8 за период в минимуме (начало) и максимуме (середина)
+    return generateTriangle(phase) + 4.0f * dt *
+           (polyBlamp(phaseToUnit(phase), dt) - polyBlamp(phaseToUnit(phase + 0x80000000u), dt));
+}
+
 float WaveGenerator::generateNoise() {
-    // Простой белый шум
-    return ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
+    // Белый шум xorshift32 вместо rand(): без reentrant-состояния newlib и деления
+    return (float)noise.nextWhite() * (1.0f / 32768.0f);
+}
+
+void WaveGenerator::seedNoise(uint32_t seed) {
+    noise.seed(seed);
 }
 
-float WaveGenerator::generateWave(WaveType type, float phase) {
+float WaveGenerator::generateWave(WaveType type, uint32_t phase) {
     switch (type) {
         case WaveType::SINE:
             return generateSine(phase);
@@ -61,12 +110,34 @@ float WaveGenerator::generateWave(WaveType type, float phase) {
     }
 }
 
-float WaveGenerator::generateWithHarmonics(WaveType type, float phase, uint8_t harmonics) {
+float WaveGenerator::generateWave(WaveType type, uint32_t phase, uint32_t increment) {
+#if WAVE_BANK_ENABLED
+    if (type != WaveType::NOISE) {
+        return WaveBank::read(WaveBank::selectTable(type, increment), phase);
+    }
+#endif
+    switch (type) {
+        case WaveType::SINE:
+            return generateSine(phase);
+        case WaveType::SQUARE:
+            return generateSquare(phase, increment);
+        case WaveType::SAWTOOTH:
+            return generateSawtooth(phase, increment);
+        case WaveType::TRIANGLE:
+            return generateTriangle(phase, increment);
+        case WaveType::NOISE:
+            return generateNoise();
+        default:
+            return generateSine(phase);
+    }
+}
+
+float WaveGenerator::generateWithHarmonics(WaveType type, uint32_t phase, uint8_t harmonics) {
     float result = 0.0f;
     float amplitude = 1.0f;
     
     for (uint8_t i = 1; i <= harmonics && i <= MAX_HARMONICS; i++) {
-        float harmonicPhase = phase * i;
+        uint32_t harmonicPhase = phase * i; // Переполнение = точный заворот фазы
         float harmonicAmplitude = amplitude / i; // Убывающая амплитуда гармоник
         
         switch (type) {
@@ -98,14 +169,3 @@ float WaveGenerator::generateWithHarmonics(WaveType type, float phase, uint8_t h
     
     return result;
 }
-
-void WaveGenerator::generateWaveTable() {
-    if (tableGenerated) return;
-    
-    for (int i = 0; i < WAVE_TABLE_SIZE; i++) {
-        float phase = (2.0f * M_PI * i) / WAVE_TABLE_SIZE;
-        waveTable[i] = generateSine(phase);
-    }
-    
-    tableGenerated = true;
-}
@@ -1,7 +1,7 @@
 #include "synthesizer/WaveSynthesizer.hpp"
+#include "synthesizer/NoteTable.hpp"
 #include "drivers/Uart.hpp"
 #include "tim.h"
-#include <math.h>
 
 // Внешние переменные из HAL
 extern TIM_HandleTypeDef htim1;
@@ -14,133 +14,72 @@ WaveSynthesizer& WaveSynthesizer::getInstance() {
 
 bool WaveSynthesizer::init() {
     // Инициализация голосов
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        voices[i] = Voice();
-    }
+    voiceManager.reset();
+    voiceManager.setStealPolicy(StealPolicy::RELEASED_FIRST);
     
     // Инициализация каналов
     for (uint8_t i = 0; i < MAX_CHANNELS; i++) {
         channelVolumes[i] = MAX_VOLUME;
+        channelDetune[i] = 0;
+        channelNoiseColor[i] = NoiseColor::WHITE;
     }
+    seedSource.seed(NoiseGenerator::DEFAULT_SEED);
     
     masterVolume = MAX_VOLUME;
     
-    // Инициализация генератора волн и микшера
-    waveGen = WaveGenerator::getInstance();
-    mixer = VoiceMixer::getInstance();
-    
     Uart::getInstance().printf("WaveSynthesizer initialized\n");
     return true;
 }
 
+// noteOn/noteOff вызываются и из прерывания DMA (SigmaDeltaAdapter применяет
+// события очереди в рендерере) - без вывода в UART: printf и буфер передачи
+// не рассчитаны на вызов из прерывания
 void WaveSynthesizer::noteOn(uint8_t channel, uint8_t note, uint8_t velocity) {
-    if (channel >= MAX_CHANNELS || note > 127) return;
-    
-    // Ищем свободный голос
-    uint8_t voiceIndex = findFreeVoice();
-    if (voiceIndex >= MAX_VOICES) {
-        // Если нет свободных голосов, освобождаем самый старый
-        voiceIndex = 0;
-        uint32_t oldestTime = voices[0].startTime;
-        for (uint8_t i = 1; i < MAX_VOICES; i++) {
-            if (voices[i].startTime < oldestTime) {
-                oldestTime = voices[i].startTime;
-                voiceIndex = i;
-            }
-        }
-        Uart::getInstance().printf("No free voices, using oldest voice %d\n", voiceIndex);
-    }
-    
-    // Настраиваем голос
-    Voice& voice = voices[voiceIndex];
-    voice.frequency = midiToFrequency(note);
-    voice.velocity = (velocity > MAX_VELOCITY) ? MAX_VELOCITY : velocity;
-    voice.channel = channel;
-    voice.startTime = HAL_GetTick();
-    voice.releaseTime = 0;
-    voice.active = true;
-    voice.released = false;
-    voice.waveType = WaveType::SINE; // По умолчанию синусоида
-    voice.phase = 0.0f;
-    voice.phaseIncrement = (2.0f * M_PI * voice.frequency) / SAMPLE_RATE;
-    
-    // Применяем настройки ADSR по умолчанию
-    voice.adsr = ADSR(50, 100, 7, 200);
-    
-    Uart::getInstance().printf("WaveSynthesizer: noteOn ch=%d, note=%d, freq=%d, vel=%d, voice=%d\n", 
-                              channel, note, voice.frequency, voice.velocity, voiceIndex);
+    // Повтор звучащей ноты перезапускает тот же голос, без свободных голосов -
+    // кража по выбранной политике (VoiceManager)
+    voiceManager.noteOn(channel, note, velocity);
 }
 
 void WaveSynthesizer::noteOff(uint8_t channel, uint8_t note) {
-    uint8_t voiceIndex = findVoice(channel, note);
-    if (voiceIndex < MAX_VOICES) {
-        voices[voiceIndex].released = true;
-        voices[voiceIndex].releaseTime = HAL_GetTick();
-        
-        Uart::getInstance().printf("WaveSynthesizer: noteOff ch=%d, note=%d, voice=%d\n", 
-                                  channel, note, voiceIndex);
-    }
+    voiceManager.noteOff(channel, note);
 }
 
 void WaveSynthesizer::allNotesOff() {
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        voices[i].active = false;
-        voices[i].released = false;
-    }
+    voiceManager.allNotesOff();
+}
+
+void WaveSynthesizer::setStealPolicy(StealPolicy policy) {
+    voiceManager.setStealPolicy(policy);
 }
 
 void WaveSynthesizer::setWaveType(uint8_t channel, WaveType type) {
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active && voices[i].channel == channel) {
-            voices[i].waveType = type;
-        }
-    }
+    voiceManager.forChannel(channel, [type](Voice& v) { v.waveType = type; });
 }
 
-void WaveSynthesizer::setWaveType(uint8_t voice, WaveType type) {
+void WaveSynthesizer::setVoiceWaveType(uint8_t voice, WaveType type) {
     if (voice < MAX_VOICES) {
-        voices[voice].waveType = type;
+        voiceManager.voice(voice).waveType = type;
     }
 }
 
 void WaveSynthesizer::setADSR(uint8_t channel, const ADSR& adsr) {
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active && voices[i].channel == channel) {
-            voices[i].adsr = adsr;
-        }
-    }
+    voiceManager.setADSR(channel, adsr);
 }
 
 void WaveSynthesizer::setAttack(uint8_t channel, uint16_t attack) {
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active && voices[i].channel == channel) {
-            voices[i].adsr.attack = attack;
-        }
-    }
+    voiceManager.setAttack(channel, attack);
 }
 
 void WaveSynthesizer::setDecay(uint8_t channel, uint16_t decay) {
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active && voices[i].channel == channel) {
-            voices[i].adsr.decay = decay;
-        }
-    }
+    voiceManager.setDecay(channel, decay);
 }
 
 void WaveSynthesizer::setSustain(uint8_t channel, uint8_t sustain) {
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active && voices[i].channel == channel) {
-            voices[i].adsr.sustain = (sustain > MAX_VOLUME) ? MAX_VOLUME : sustain;
-        }
-    }
+    voiceManager.setSustain(channel, sustain);
 }
 
 void WaveSynthesizer::setRelease(uint8_t channel, uint16_t release) {
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active && voices[i].channel == channel) {
-            voices[i].adsr.release = release;
-        }
-    }
+    voiceManager.setRelease(channel, release);
 }
 
 void WaveSynthesizer::setMasterVolume(uint8_t volume) {
@@ -153,83 +92,149 @@ void WaveSynthesizer::setChannelVolume(uint8_t channel, uint8_t volume) {
     }
 }
 
-float WaveSynthesizer::generateSample() {
-    // Генерируем микшированный семпл
-    float sample = mixer.mixVoices(voices, MAX_VOICES);
-    
-    // Применяем мастер-громкость
-    sample *= ((float)masterVolume / MAX_VOLUME);
+void WaveSynthesizer::setPitchBend(uint8_t channel, int16_t cents) {
+    if (channel >= MAX_CHANNELS) return;
+    channelDetune[channel] = cents;
+
+    // Перестраиваем звучащие ноты канала, фаза не сбрасывается
+    voiceManager.forChannel(channel, [cents](Voice& v) { v.phaseIncrement = NoteTable::phaseIncrement(v.note, cents); });
+}
+
+void WaveSynthesizer::setNoiseColor(uint8_t channel, NoiseColor color) {
+    if (channel >= MAX_CHANNELS) return;
+    channelNoiseColor[channel] = color;
     
+    voiceManager.forChannel(channel, [color](Voice& v) { v.noise.setColor(color); });
+}
+
+void WaveSynthesizer::setNoiseSeed(uint32_t seed) {
+    seedSource.seed(seed);
+}
+
+float WaveSynthesizer::generateSample() {
+    float sample;
+    renderBlock(&sample, 1);
     return sample;
 }
 
-void WaveSynthesizer::update() {
-    // Обновляем все активные голоса
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active) {
-            updateVoice(voices[i]);
+#if SYNTH_FIXED_POINT
+
+void WaveSynthesizer::renderBlock(int16_t* out, size_t frames) {
+    // Мастер-громкость в Q15: MAX_VOLUME соответствует 32768
+    const int32_t volume = (int32_t)masterVolume * 32768 / MAX_VOLUME;
+    
+    while (frames > 0) {
+        size_t count = (frames > AUDIO_BLOCK_SIZE) ? AUDIO_BLOCK_SIZE : frames;
+        
+        mixer.mixBlockQ15(voiceManager.data(), voiceManager.activeVoices(), voiceManager.getActiveCount(), out, count);
+        voiceManager.releaseFinished();
+        
+        for (size_t i = 0; i < count; i++) {
+            out[i] = (int16_t)((out[i] * volume) >> 15);
         }
+        
+        out += count;
+        frames -= count;
     }
 }
 
-uint8_t WaveSynthesizer::getActiveVoices() const {
-    uint8_t count = 0;
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active) count++;
+void WaveSynthesizer::renderBlock(float* out, size_t frames) {
+    int16_t block[AUDIO_BLOCK_SIZE];
+    while (frames > 0) {
+        size_t count = (frames > AUDIO_BLOCK_SIZE) ? AUDIO_BLOCK_SIZE : frames;
+        renderBlock(block, count);
+        for (size_t i = 0; i < count; i++) {
+            out[i] = (float)block[i] * (1.0f / 32768.0f);
+        }
+        out += count;
+        frames -= count;
     }
-    return count;
 }
 
-bool WaveSynthesizer::isChannelActive(uint8_t channel) const {
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active && voices[i].channel == channel) {
-            return true;
+#else
+
+void WaveSynthesizer::renderBlock(float* out, size_t frames) {
+    const float volume = (float)masterVolume / MAX_VOLUME;
+    
+    // Длинные буферы режем на блоки AUDIO_BLOCK_SIZE, чтобы огибающая
+    // обновлялась с постоянным шагом
+    while (frames > 0) {
+        size_t count = (frames > AUDIO_BLOCK_SIZE) ? AUDIO_BLOCK_SIZE : frames;
+        
+        // Рендерятся только активные голоса из плотного списка
+        mixer.mixBlock(voiceManager.data(), voiceManager.activeVoices(), voiceManager.getActiveCount(), out, count);
+        voiceManager.releaseFinished();
+        
+        // Применяем мастер-громкость
+        for (size_t i = 0; i < count; i++) {
+            out[i] *= volume;
         }
+        
+        out += count;
+        frames -= count;
     }
-    return false;
 }
 
-uint8_t WaveSynthesizer::findFreeVoice() const {
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (!voices[i].active) {
-            return i;
+void WaveSynthesizer::renderBlock(int16_t* out, size_t frames) {
+    float block[AUDIO_BLOCK_SIZE];
+    while (frames > 0) {
+        size_t count = (frames > AUDIO_BLOCK_SIZE) ? AUDIO_BLOCK_SIZE : frames;
+        renderBlock(block, count);
+        for (size_t i = 0; i < count; i++) {
+            out[i] = DspMath::ssat16((int32_t)(block[i] * 32768.0f));
         }
+        out += count;
+        frames -= count;
     }
-    return MAX_VOICES; // Нет свободных голосов
 }
 
-uint8_t WaveSynthesizer::findVoice(uint8_t channel, uint8_t note) const {
-    uint16_t frequency = midiToFrequency(note);
-    for (uint8_t i = 0; i < MAX_VOICES; i++) {
-        if (voices[i].active && voices[i].channel == channel && voices[i].frequency == frequency) {
-            return i;
-        }
-    }
-    return MAX_VOICES; // Голос не найден
+#endif // SYNTH_FIXED_POINT
+
+void WaveSynthesizer::update() {
+    // Огибающие и фаза голосов продвигаются в renderBlock, голоса
+    // с завершенным релизом возвращаются в распределитель там же
 }
 
-uint16_t WaveSynthesizer::midiToFrequency(uint8_t note) const {
-    // A4 = 440 Hz, MIDI note 69
-    if (note == 0) return 0;
-    
-    // Формула: f = 440 * 2^((note - 69) / 12)
-    float frequency = 440.0f * powf(2.0f, (note - 69) / 12.0f);
-    return (uint16_t)frequency;
+uint8_t WaveSynthesizer::getActiveVoices() const {
+    return voiceManager.getActiveCount();
 }
 
-void WaveSynthesizer::updateVoice(Voice& voice) {
-    // Обновляем фазу
-    voice.phase += voice.phaseIncrement;
-    if (voice.phase >= 2.0f * M_PI) {
-        voice.phase -= 2.0f * M_PI;
+bool WaveSynthesizer::isChannelActive(uint8_t channel) const {
+    return voiceManager.isChannelActive(channel);
+}
+
+uint16_t WaveSynthesizer::getActiveChannels() const {
+    uint16_t mask = 0;
+    const uint8_t* list = voiceManager.activeVoices();
+    for (uint8_t i = 0; i < voiceManager.getActiveCount(); i++) {
+        mask |= (uint16_t)(1u << voiceManager.voice(list[i]).channel);
     }
+    return mask;
+}
+
+void WaveSynthesizer::startVoice(Voice& voice) {
+    voice.frequency = NoteTable::frequency(voice.note);
+    voice.startTime = HAL_GetTick();
+    voice.releaseTime = 0;
+    voice.waveType = WaveType::SINE; // По умолчанию синусоида
+    voice.phase = 0;
+    voice.phaseIncrement = NoteTable::phaseIncrement(voice.note, channelDetune[voice.channel]);
+    voice.noise.seed(seedSource.nextRaw());
+    voice.noise.setColor(channelNoiseColor[voice.channel]);
     
-    // Проверяем, нужно ли отключить голос
-    if (voice.released) {
-        uint32_t currentTime = HAL_GetTick();
-        uint32_t releaseElapsed = currentTime - voice.releaseTime;
-        if (releaseElapsed >= voice.adsr.release) {
-            voice.active = false;
-        }
-    }
+    // ADSR по умолчанию, атака - с текущего уровня огибающей
+    configureEnvelope(voice);
+    voice.envelope.trigger();
+}
+
+void WaveSynthesizer::releaseVoice(Voice& voice) {
+    voice.releaseTime = HAL_GetTick();
+    voice.envelope.release();
+}
+
+void WaveSynthesizer::configureEnvelope(Voice& voice) {
+    // Пик - по velocity, сустейн - доля пика (0-10)
+    voice.envelope.setup(voice.adsr.attack, voice.adsr.decay, (float)voice.adsr.sustain / MAX_VOLUME,
+                         voice.adsr.release, (float)voice.velocity / MAX_VELOCITY, SAMPLE_RATE,
+                         voice.adsr.curve);
 }
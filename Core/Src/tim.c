@@ -21,7 +21,8 @@
 #include "tim.h"
 
 /* USER CODE BEGIN 0 */
-
+/* DMA2 Stream5 Channel6 - запрос TIM1_UP: поток значений CCR1 для SigmaDeltaPWM */
+DMA_HandleTypeDef hdma_tim1_up;
 /* USER CODE END 0 */
 
 TIM_HandleTypeDef htim1;
@@ -108,12 +109,13 @@ void MX_TIM6_Init(void)
   TIM_MasterConfigTypeDef sMasterConfig = {0};
 
   /* USER CODE BEGIN TIM6_Init 1 */
-
+  // HSI: APB1 16MHz / 2, таймеры x2 = 16MHz / 16 = 1MHz;
+  // 1MHz / 1000 = 1kHz (1ms) - тик арпеджио Buzzer
   /* USER CODE END TIM6_Init 1 */
   htim6.Instance = TIM6;
-  htim6.Init.Prescaler = 8999;  // 90MHz / 9000 = 10kHz
+  htim6.Init.Prescaler = 15;
   htim6.Init.CounterMode = TIM_COUNTERMODE_UP;
-  htim6.Init.Period = 9;        // 10kHz / 10 = 1kHz (1ms)
+  htim6.Init.Period = 999;
   htim6.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
   if (HAL_TIM_Base_Init(&htim6) != HAL_OK)
   {
@@ -126,7 +128,7 @@ void MX_TIM6_Init(void)
     Error_Handler();
   }
   /* USER CODE BEGIN TIM6_Init 2 */
-  // Включаем прерывание TIM6 для системного тика
+  // Включаем прерывание TIM6: тик арпеджио Buzzer
   HAL_TIM_Base_Start_IT(&htim6);
   /* USER CODE END TIM6_Init 2 */
 
@@ -143,6 +145,26 @@ void HAL_TIM_Base_MspInit(TIM_HandleTypeDef* tim_baseHandle)
     /* TIM1 clock enable */
     __HAL_RCC_TIM1_CLK_ENABLE();
   /* USER CODE BEGIN TIM1_MspInit 1 */
+    /* TIM1_UP DMA: память -> CCR1, по полуслову, кольцевой режим */
+    __HAL_RCC_DMA2_CLK_ENABLE();
+    hdma_tim1_up.Instance = DMA2_Stream5;
+    hdma_tim1_up.Init.Channel = DMA_CHANNEL_6;
+    hdma_tim1_up.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_tim1_up.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_tim1_up.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_tim1_up.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    hdma_tim1_up.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+    hdma_tim1_up.Init.Mode = DMA_CIRCULAR;
+    hdma_tim1_up.Init.Priority = DMA_PRIORITY_HIGH;
+    hdma_tim1_up.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&hdma_tim1_up) != HAL_OK)
+    {
+      Error_Handler();
+    }
+    __HAL_LINKDMA(tim_baseHandle, hdma[TIM_DMA_ID_UPDATE], hdma_tim1_up);
+
+    HAL_NVIC_SetPriority(DMA2_Stream5_IRQn, 1, 0);
+    HAL_NVIC_EnableIRQ(DMA2_Stream5_IRQn);
 
   /* USER CODE END TIM1_MspInit 1 */
   }
@@ -0,0 +1,52 @@
+#ifndef OFFLINE_PROJECT_HPP
+#define OFFLINE_PROJECT_HPP
+
+#include <stdint.h>
+#include <vector>
+
+// Партия для офлайн-рендера: ноты проекта секвенсора или скрипта по
+// виртуальным часам (мс). Отдельно от рендеринга: Sequencer.hpp (старый
+// Synthesizer) и WaveSynthesizer.hpp объявляют WaveType по-своему, в одной
+// единице трансляции их нет - общие здесь только простые типы
+struct OfflineNote {
+    enum Kind : uint8_t {
+        NOTE_ON,
+        NOTE_OFF,
+        DRUM,           // note - номер DrumPreset
+        ALL_NOTES_OFF
+    };
+    
+    uint32_t time;      // мс от начала
+    Kind kind;
+    uint8_t channel;
+    uint8_t note;
+    uint8_t velocity;
+    uint8_t wave;       // WaveType WaveSynthesizer (0-4), NO_WAVE - по умолчанию
+    
+    static constexpr uint8_t NO_WAVE = 0xFF;
+};
+
+typedef std::vector<OfflineNote> OfflinePart;  // По возрастанию времени
+
+// Проект секвенсора из текстового файла, durationMs мс игры Sequencer
+// на виртуальных часах. Формат (строка - команда, # в начале строки - комментарий):
+//
+//   bpm 140
+//   volume 8
+//   drum <дорожка 0-3> <пресет 0-7> x...|x.x.     удар/пауза, блоки по 4 через |
+//   piano <дорожка 4-5> C E G - | A# - C -       ноты C..B, # - полутон, - пауза
+//
+// false - ошибка разбора (сообщение в stderr)
+bool loadProjectPart(const char* path, uint32_t durationMs, OfflinePart& part);
+
+// Встроенный демо-проект: бочка, малый, хай-хэт и две фортепианные дорожки
+void demoProjectPart(uint32_t durationMs, OfflinePart& part);
+
+// Скрипт нот: "<начало, мс> <длительность, мс> <канал> <нота> <velocity> [волна]",
+// волна - sine, square, saw, triangle, noise. endMs - конец последней ноты
+bool loadScriptPart(const char* path, OfflinePart& part, uint32_t& endMs);
+
+// Имя волны скрипта -> WaveType (0-4), NO_WAVE - неизвестное имя
+uint8_t parseWaveName(const char* name);
+
+#endif // OFFLINE_PROJECT_HPP
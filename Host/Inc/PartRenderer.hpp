@@ -0,0 +1,62 @@
+#ifndef PART_RENDERER_HPP
+#define PART_RENDERER_HPP
+
+#include <stdint.h>
+#include <vector>
+#include "synthesizer/WaveSynthesizer.hpp"
+#include "OfflineProject.hpp"
+#include "WavWriter.hpp"
+
+// Подмена звучания всех нот партии (варианты пресета для превью):
+// NO_WAVE и hasAdsr = false - как в партии. Барабаны не меняются
+struct PartVoicing {
+    uint8_t wave;
+    bool hasAdsr;
+    ADSR adsr;
+    
+    PartVoicing() : wave(OfflineNote::NO_WAVE), hasAdsr(false), adsr() {}
+};
+
+// Рендер партии на заданном экземпляре WaveSynthesizer: каждое событие -
+// ровно на своем кадре (блок режется по кадрам событий, как в
+// SigmaDeltaAdapter), звук уходит в WavWriter кусками по CHUNK_FRAMES
+// и/или в буфер в памяти (setCapture).
+// Экземпляры с разными движками независимы - их можно рендерить в потоках
+class PartRenderer {
+public:
+    PartRenderer(WaveSynthesizer& synth, WavWriter* writer);
+    
+    // durationMs мс звука; part - по возрастанию времени (загрузчики OfflineProject)
+    void render(const OfflinePart& part, uint32_t durationMs, const PartVoicing& voicing = PartVoicing());
+    
+    // Семплы рендера дописываются в buffer (nullptr - не сохранять)
+    void setCapture(std::vector<float>* buffer) { capture = buffer; }
+    
+    uint32_t getFrames() const { return frames; }
+    float getPeak() const { return peak; }
+    
+    static uint32_t msToFrames(uint32_t ms);
+    
+    static constexpr uint32_t CHUNK_FRAMES = 4096;
+
+private:
+    // Отпускание барабана через его decay после удара
+    struct PendingOff {
+        uint32_t frame;
+        uint8_t channel;
+        uint8_t note;
+    };
+    
+    WaveSynthesizer& synth;
+    WavWriter* writer;
+    std::vector<float>* capture;
+    uint32_t frames;
+    float peak;
+    std::vector<PendingOff> pending;  // По возрастанию кадра
+    
+    void advanceTo(uint32_t frame);
+    void renderFrames(uint32_t count);
+    void apply(const OfflineNote& note, const PartVoicing& voicing);
+};
+
+#endif // PART_RENDERER_HPP
@@ -0,0 +1,12 @@
+#ifndef WAV_READER_HPP
+#define WAV_READER_HPP
+
+#include <stdint.h>
+#include <vector>
+
+// Чтение WAV PCM моно 16/24 бит (формат WavWriter) в семплы [-1.0, 1.0).
+// Неизвестные чанки RIFF пропускаются. false - файла нет или формат не тот
+// (сообщение в stderr)
+bool loadWav(const char* path, std::vector<float>& samples, uint32_t& sampleRate);
+
+#endif // WAV_READER_HPP
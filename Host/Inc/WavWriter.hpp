@@ -0,0 +1,35 @@
+#ifndef WAV_WRITER_HPP
+#define WAV_WRITER_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// WAV PCM моно 16/24 бит, запись потоком: семплы дописываются кусками по
+// мере рендеринга, размеры в заголовке исправляются в close()
+class WavWriter {
+public:
+    WavWriter() : file(nullptr), bits(16), sampleRate(0), dataBytes(0) {}
+    ~WavWriter() { close(); }
+    
+    bool open(const char* path, uint8_t sampleBits, uint32_t rate);
+    
+    // Семплы [-1.0, 1.0], за пределами - насыщение
+    void write(const float* samples, size_t count);
+    
+    // false - ошибка записи
+    bool close();
+
+private:
+    WavWriter(const WavWriter&) = delete;
+    WavWriter& operator=(const WavWriter&) = delete;
+    
+    FILE* file;
+    uint8_t bits;
+    uint32_t sampleRate;
+    uint32_t dataBytes;
+    
+    void writeHeader();
+};
+
+#endif // WAV_WRITER_HPP
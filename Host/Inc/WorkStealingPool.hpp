@@ -0,0 +1,62 @@
+#ifndef WORK_STEALING_POOL_HPP
+#define WORK_STEALING_POOL_HPP
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул потоков с кражей заданий (только хост-утилиты). У каждого потока своя
+// очередь: свои задания он берет с конца, пустой поток крадет из начала
+// чужой очереди - длинные и короткие задания расходятся по ядрам сами.
+// Очереди под собственными мьютексами: задания крупные (рендер файла),
+// спор за очередь на их фоне не виден
+class WorkStealingPool {
+public:
+    typedef std::function<void()> Task;
+    
+    // threads = 0 - по числу ядер
+    explicit WorkStealingPool(unsigned threads = 0);
+    ~WorkStealingPool();
+    
+    // Задания раздаются очередям по кругу
+    void submit(Task task);
+    
+    // Ожидание выполнения всех отправленных заданий
+    void wait();
+    
+    unsigned getThreadCount() const { return (unsigned)workers.size(); }
+    uint32_t getSteals() const { return steals.load(std::memory_order_relaxed); }
+
+private:
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+    
+    struct Worker {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+    
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    
+    std::mutex stateLock;              // Сон потоков и ожидание wait()
+    std::condition_variable wake;
+    std::condition_variable idle;
+    uint32_t unfinished;               // Отправлено и не выполнено (под stateLock)
+    bool stopping;                     // Под stateLock
+    
+    std::atomic<uint32_t> queued;      // Заданий в очередях
+    std::atomic<uint32_t> nextWorker;
+    std::atomic<uint32_t> steals;
+    
+    void run(unsigned index);
+    bool take(unsigned index, Task& task);
+};
+
+#endif // WORK_STEALING_POOL_HPP
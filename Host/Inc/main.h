@@ -0,0 +1,7 @@
+#ifndef HOST_MAIN_H
+#define HOST_MAIN_H
+
+/* Хост-сборка: вместо main.h проекта CubeMX */
+#include "stm32f4xx_hal.h"
+
+#endif /* HOST_MAIN_H */
@@ -0,0 +1,80 @@
+#ifndef HOST_STM32F4XX_HAL_H
+#define HOST_STM32F4XX_HAL_H
+
+/*
+ * Заглушка HAL для сборки синтезатора на ПК (бенчмарки, утилиты).
+ * Содержит только то, что используют исходники Core/ в хост-сборке;
+ * регистры таймера - обычная память, DMA моделируется hostDmaStep().
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    HAL_OK = 0x00U,
+    HAL_ERROR = 0x01U,
+    HAL_BUSY = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef struct {
+    volatile uint32_t CR1, CR2, SMCR, DIER, SR, EGR, CCMR1, CCMR2, CCER, CNT, PSC, ARR, RCR;
+    volatile uint32_t CCR1, CCR2, CCR3, CCR4, BDTR, DCR, DMAR;
+} TIM_TypeDef;
+
+typedef struct {
+    volatile uint32_t CR, NDTR, PAR, M0AR;
+} DMA_Stream_TypeDef;
+
+typedef struct __DMA_HandleTypeDef {
+    DMA_Stream_TypeDef* Instance;
+    void (*XferCpltCallback)(struct __DMA_HandleTypeDef* hdma);
+    void (*XferHalfCpltCallback)(struct __DMA_HandleTypeDef* hdma);
+    uint32_t length;  // Только хост: длина кольца для модели
+} DMA_HandleTypeDef;
+
+typedef struct {
+    TIM_TypeDef* Instance;
+} TIM_HandleTypeDef;
+
+extern TIM_TypeDef hostTim1;
+extern TIM_TypeDef hostTim6;
+#define TIM1 (&hostTim1)
+#define TIM6 (&hostTim6)
+
+#define TIM_CHANNEL_1 0x00000000U
+#define TIM_CR1_UDIS 0x00000002U
+#define TIM_CR1_ARPE 0x00000080U
+#define TIM_CCMR1_OC1PE 0x00000008U
+#define TIM_EGR_UG 0x00000001U
+#define TIM_DMA_UPDATE 0x00000100U
+
+#define __HAL_TIM_ENABLE_DMA(__HANDLE__, __DMA__) ((__HANDLE__)->Instance->DIER |= (__DMA__))
+#define __HAL_TIM_DISABLE_DMA(__HANDLE__, __DMA__) ((__HANDLE__)->Instance->DIER &= ~(__DMA__))
+#define __HAL_DMA_GET_COUNTER(__HANDLE__) ((__HANDLE__)->Instance->NDTR)
+
+uint32_t HAL_GetTick(void);
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef* htim, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef* htim, uint32_t Channel);
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+uint32_t HAL_RCC_GetPCLK2Freq(void);
+/* Адреса - uintptr_t: на ПК указатель не помещается в uint32_t */
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef* hdma, uintptr_t SrcAddress, uintptr_t DstAddress, uint32_t DataLength);
+HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef* hdma);
+
+/* Только хост: одна передача кольцевого DMA (полуслово из памяти в регистр)
+ * с вызовом обработчиков половины и конца круга, как HAL_DMA_IRQHandler */
+void hostDmaStep(DMA_HandleTypeDef* hdma);
+
+/* Только хост: виртуальные часы. После первого вызова HAL_GetTick
+ * возвращает заданное значение вместо реального времени (офлайн-рендер) */
+void hostSetTick(uint32_t tick);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_STM32F4XX_HAL_H */
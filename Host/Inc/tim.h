@@ -0,0 +1,18 @@
+#ifndef HOST_TIM_H
+#define HOST_TIM_H
+
+#include "main.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern TIM_HandleTypeDef htim1;
+extern TIM_HandleTypeDef htim6;
+extern DMA_HandleTypeDef hdma_tim1_up;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_TIM_H */
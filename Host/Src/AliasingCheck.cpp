@@ -0,0 +1,154 @@
+/*
+ * Проверка алиасинга генераторов на ПК: энергия составляющих не на
+ * гармониках основного тона относительно гармоник для квадрата, пилы и
+ * треугольника на 440-3520 Гц. Сравниваются наивные генераторы
+ * WaveGenerator::generateX(phase), PolyBLEP/PolyBLAMP версии
+ * generateX(phase, increment) и таблицы WaveBank.
+ *
+ * Частота подбирается так, что на FFT_SIZE семплов приходится нечетное число
+ * периодов: фаза периодична на отрезке, окно не нужно, гармоники лежат точно
+ * в бинах k * cycles, а отраженные от Найквиста - в других бинах.
+ *
+ * Сборка из корня репозитория:
+ *
+ *   g++ -std=gnu++14 -O2 -IHost/Inc -ICore/Inc \
+ *       Host/Src/AliasingCheck.cpp Host/Src/HalShim.cpp \
+ *       Core/Src/synthesizer/WaveGenerator.cpp Core/Src/synthesizer/WaveBank.cpp \
+ *       Core/Src/synthesizer/NoteTable.cpp -o aliasing_check
+ *
+ * Код возврата 0 - все проверки прошли.
+ */
+
+#include "synthesizer/WaveSynthesizer.hpp"
+#include "synthesizer/WaveBank.hpp"
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+
+static constexpr uint32_t FFT_LOG2 = 14;
+static constexpr uint32_t FFT_SIZE = 1u << FFT_LOG2;
+
+// Пороги: алиасинг PolyBLEP ниже наивного хотя бы на MIN_IMPROVEMENT_DB
+// (сейчас 11-17 дБ) и не выше MAX_POLYBLEP_ALIAS_DB (худший сейчас -26.5 дБ,
+// пила на 3520 Гц), у таблиц WaveBank - не выше MAX_WAVEBANK_ALIAS_DB (-66 дБ)
+static constexpr double MIN_IMPROVEMENT_DB = 10.0;
+static constexpr double MAX_POLYBLEP_ALIAS_DB = -25.0;
+static constexpr double MAX_WAVEBANK_ALIAS_DB = -60.0;
+
+static const double FREQUENCIES[] = { 440.0, 880.0, 1760.0, 3520.0 };
+
+struct WaveCase {
+    WaveType type;
+    const char* name;
+};
+
+static const WaveCase WAVES[] = {
+    { WaveType::SQUARE, "square" },
+    { WaveType::SAWTOOTH, "saw" },
+    { WaveType::TRIANGLE, "triangle" },
+};
+
+enum class Oscillator {
+    NAIVE,
+    POLYBLEP,
+    WAVEBANK
+};
+
+static void fft(std::vector<double>& re, std::vector<double>& im) {
+    // Перестановка с обращением битов
+    for (uint32_t i = 1, j = 0; i < FFT_SIZE; i++) {
+        uint32_t bit = FFT_SIZE >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+    }
+    for (uint32_t len = 2; len <= FFT_SIZE; len <<= 1) {
+        const double angle = -2.0 * M_PI / len;
+        for (uint32_t start = 0; start < FFT_SIZE; start += len) {
+            for (uint32_t k = 0; k < len / 2; k++) {
+                const double wr = cos(angle * k), wi = sin(angle * k);
+                const uint32_t a = start + k, b = a + len / 2;
+                const double tr = re[b] * wr - im[b] * wi;
+                const double ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
+
+// Энергия не на гармониках к энергии гармоник, дБ (постоянная составляющая не считается)
+static double aliasRatioDb(WaveType type, Oscillator osc, uint32_t cycles) {
+    WaveGenerator& gen = WaveGenerator::getInstance();
+    // cycles * 2^32 / FFT_SIZE - ровно cycles периодов на отрезке
+    const uint32_t increment = cycles << (32 - FFT_LOG2);
+    const int16_t* table = WaveBank::selectTable(type, increment);
+    
+    std::vector<double> re(FFT_SIZE), im(FFT_SIZE, 0.0);
+    uint32_t phase = 0;
+    for (uint32_t n = 0; n < FFT_SIZE; n++) {
+        float sample = 0.0f;
+        switch (osc) {
+            case Oscillator::NAIVE:
+                sample = gen.generateWave(type, phase);
+                break;
+            case Oscillator::POLYBLEP:
+                // Напрямую: generateWave(type, phase, increment) при WAVE_BANK_ENABLED читает таблицы
+                if (type == WaveType::SQUARE) {
+                    sample = gen.generateSquare(phase, increment);
+                } else if (type == WaveType::SAWTOOTH) {
+                    sample = gen.generateSawtooth(phase, increment);
+                } else {
+                    sample = gen.generateTriangle(phase, increment);
+                }
+                break;
+            case Oscillator::WAVEBANK:
+                sample = WaveBank::read(table, phase);
+                break;
+        }
+        re[n] = sample;
+        phase += increment;
+    }
+    fft(re, im);
+    
+    double signal = 0.0, alias = 0.0;
+    for (uint32_t k = 1; k < FFT_SIZE / 2; k++) {
+        const double energy = re[k] * re[k] + im[k] * im[k];
+        if (k % cycles == 0) {
+            signal += energy;
+        } else {
+            alias += energy;
+        }
+    }
+    return 10.0 * log10((alias + 1e-30) / signal);
+}
+
+int main() {
+    bool passed = true;
+    
+    printf("alias-to-signal energy, dB (%u-point FFT, %d Hz)\n", FFT_SIZE, SAMPLE_RATE);
+    printf("%-9s %8s %8s %9s %9s\n", "wave", "f, Hz", "naive", "polyblep", "wavebank");
+    for (const WaveCase& wave : WAVES) {
+        for (double freq : FREQUENCIES) {
+            // Ближайшее нечетное число периодов на FFT_SIZE
+            const uint32_t cycles = (uint32_t)(freq * FFT_SIZE / SAMPLE_RATE) | 1u;
+            const double naive = aliasRatioDb(wave.type, Oscillator::NAIVE, cycles);
+            const double polyBlep = aliasRatioDb(wave.type, Oscillator::POLYBLEP, cycles);
+            const double bank = aliasRatioDb(wave.type, Oscillator::WAVEBANK, cycles);
+            
+            const bool ok = polyBlep <= naive - MIN_IMPROVEMENT_DB && polyBlep <= MAX_POLYBLEP_ALIAS_DB &&
+                            bank <= MAX_WAVEBANK_ALIAS_DB;
+            printf("%-9s %8.1f %8.1f %9.1f %9.1f  %s\n", wave.name, (double)cycles * SAMPLE_RATE / FFT_SIZE,
+                   naive, polyBlep, bank, ok ? "ok" : "FAIL");
+            passed &= ok;
+        }
+    }
+    
+    printf("%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
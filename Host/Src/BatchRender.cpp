@@ -0,0 +1,350 @@
+/*
+ * Пакетный офлайн-рендер на ПК: много проектов и вариантов параметров сразу,
+ * задания выполняет пул потоков с кражей заданий (WorkStealingPool). У каждого
+ * задания свой экземпляр WaveSynthesizer и свой файл, общих изменяемых данных
+ * нет - пропускная способность растет с числом ядер. Звук пишется в файл
+ * кусками по мере рендеринга (PartRenderer::CHUNK_FRAMES), память на задание
+ * не зависит от длительности.
+ *
+ * Партии готовятся заранее в основном потоке: Sequencer - singleton на
+ * виртуальных часах, в потоках работает только рендеринг.
+ *
+ * Сборка из корня репозитория:
+ *
+ *   g++ -std=gnu++14 -O2 -pthread -IHost/Inc -ICore/Inc \
+ *       Host/Src/BatchRender.cpp Host/Src/WorkStealingPool.cpp Host/Src/OfflineProject.cpp \
+ *       Host/Src/PartRenderer.cpp Host/Src/WavWriter.cpp \
+ *       Host/Src/HalShim.cpp Host/Src/UartShim.cpp \
+ *       Core/Src/Sequencer.cpp Core/Src/drivers/Synthesizer.cpp Core/Src/drivers/Buzzer.cpp \
+ *       Core/Src/synthesizer/OneBitMixer.cpp Core/Src/synthesizer/SynthesizerBridge.cpp \
+ *       Core/Src/synthesizer/WaveSynthesizer.cpp Core/Src/synthesizer/VoiceMixer.cpp \
+ *       Core/Src/synthesizer/WaveGenerator.cpp Core/Src/synthesizer/WaveBank.cpp \
+ *       Core/Src/synthesizer/NoteTable.cpp Core/Src/synthesizer/Envelope.cpp \
+ *       Core/Src/synthesizer/VoiceKernels.cpp -o batch_render
+ *
+ * Запуск:
+ *
+ *   ./batch_render [-j потоки] [-o каталог] [-b 16|24] [-r копии] [-n] [задания.txt]
+ *
+ * Без файла заданий - библиотека превью пресетов: фраза на каждой волне с
+ * каждой огибающей (preview_<волна>_<огибающая>.wav). -r повторяет список
+ * заданий (замер масштабирования), -n - без записи файлов.
+ *
+ * Файл заданий - строка на задание, # - комментарий:
+ *
+ *   <выход.wav> project <проект.txt> [параметры]
+ *   <выход.wav> script <скрипт.txt> [параметры]
+ *   <выход.wav> demo [параметры]
+ *
+ * Параметры: d=<секунды>, bits=16|24, wave=sine|square|saw|triangle|noise,
+ * adsr=<атака>,<спад>,<сустейн 0-10>,<релиз> - подмена для всех нот партии.
+ * Код возврата 0 - все задания записаны.
+ */
+
+#include "OfflineProject.hpp"
+#include "PartRenderer.hpp"
+#include "WorkStealingPool.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+
+static constexpr uint32_t TAIL_MS = 500;             // После последней ноты скрипта - релиз
+static constexpr uint32_t PROJECT_MS = 8000;         // Длительность проекта по умолчанию
+static constexpr uint32_t PREVIEW_MS = 3000;         // Фраза превью с релизом
+
+struct Job {
+    std::string output;
+    std::shared_ptr<const OfflinePart> part;
+    uint32_t durationMs;
+    uint8_t bits;
+    PartVoicing voicing;
+    
+    // Результат (заполняет поток задания)
+    bool ok;
+    uint32_t frames;
+    float peak;
+    double seconds;
+};
+
+// Огибающие превью
+struct EnvelopePreset {
+    const char* name;
+    ADSR adsr;
+};
+
+static const EnvelopePreset ENVELOPES[] = {
+    { "pluck", ADSR(2, 180, 0, 120) },
+    { "pad", ADSR(400, 300, 7, 800) },
+    { "organ", ADSR(5, 10, 10, 40) },
+    { "swell", ADSR(900, 100, 8, 600) },
+};
+
+static const char* const WAVE_NAMES[] = { "sine", "square", "saw", "triangle", "noise" };
+
+// Фраза превью: арпеджио C4-E4-G4-C5 и аккорд
+static void previewPart(OfflinePart& part) {
+    struct PhraseNote {
+        uint32_t start;
+        uint32_t length;
+        uint8_t note;
+    };
+    static const PhraseNote PHRASE[] = {
+        { 0, 220, 60 }, { 250, 220, 64 }, { 500, 220, 67 }, { 750, 220, 72 },
+        { 1000, 1000, 60 }, { 1000, 1000, 64 }, { 1000, 1000, 67 },
+    };
+    
+    for (const PhraseNote& phrase : PHRASE) {
+        OfflineNote note;
+        note.time = phrase.start;
+        note.kind = OfflineNote::NOTE_ON;
+        note.channel = 0;
+        note.note = phrase.note;
+        note.velocity = 100;
+        note.wave = OfflineNote::NO_WAVE;
+        part.push_back(note);
+        
+        note.time = phrase.start + phrase.length;
+        note.kind = OfflineNote::NOTE_OFF;
+        part.push_back(note);
+    }
+    std::stable_sort(part.begin(), part.end(),
+                     [](const OfflineNote& a, const OfflineNote& b) { return a.time < b.time; });
+}
+
+static void previewJobs(uint8_t bits, std::vector<Job>& jobs) {
+    std::shared_ptr<OfflinePart> part = std::make_shared<OfflinePart>();
+    previewPart(*part);
+    
+    for (uint8_t wave = 0; wave < sizeof(WAVE_NAMES) / sizeof(WAVE_NAMES[0]); wave++) {
+        for (const EnvelopePreset& envelope : ENVELOPES) {
+            Job job = Job();
+            job.output = std::string("preview_") + WAVE_NAMES[wave] + "_" + envelope.name + ".wav";
+            job.part = part;
+            job.durationMs = PREVIEW_MS;
+            job.bits = bits;
+            job.voicing.wave = wave;
+            job.voicing.hasAdsr = true;
+            job.voicing.adsr = envelope.adsr;
+            jobs.push_back(job);
+        }
+    }
+}
+
+// Параметр задания "ключ=значение". false - ошибка
+static bool parseParameter(const char* text, Job& job, uint32_t& durationMs) {
+    const char* value = strchr(text, '=');
+    if (!value) return false;
+    const std::string key(text, value - text);
+    value++;
+    
+    if (key == "d") {
+        durationMs = (uint32_t)(atof(value) * 1000.0);
+        return durationMs > 0;
+    }
+    if (key == "bits") {
+        job.bits = (uint8_t)atoi(value);
+        return job.bits == 16 || job.bits == 24;
+    }
+    if (key == "wave") {
+        job.voicing.wave = parseWaveName(value);
+        return job.voicing.wave != OfflineNote::NO_WAVE;
+    }
+    if (key == "adsr") {
+        unsigned attack, decay, sustain, release;
+        if (sscanf(value, "%u,%u,%u,%u", &attack, &decay, &sustain, &release) != 4 ||
+            sustain > WaveSynthesizer::MAX_VOLUME) {
+            return false;
+        }
+        job.voicing.hasAdsr = true;
+        job.voicing.adsr = ADSR((uint16_t)attack, (uint16_t)decay, (uint8_t)sustain, (uint16_t)release);
+        return true;
+    }
+    return false;
+}
+
+// Строка файла заданий: партия загружается сразу (Sequencer - в этом потоке)
+static bool parseJobLine(char* line, uint8_t bits, std::vector<Job>& jobs, bool& empty) {
+    const char* separators = " \t\r\n";
+    char* output = strtok(line, separators);
+    empty = (output == nullptr);
+    if (empty) return true;
+    
+    char* source = strtok(nullptr, separators);
+    if (!source) return false;
+    char* path = nullptr;
+    if (strcmp(source, "project") == 0 || strcmp(source, "script") == 0) {
+        path = strtok(nullptr, separators);
+        if (!path) return false;
+    } else if (strcmp(source, "demo") != 0) {
+        return false;
+    }
+    
+    Job job = Job();
+    job.output = output;
+    job.bits = bits;
+    uint32_t durationMs = 0;
+    for (char* parameter = strtok(nullptr, separators); parameter; parameter = strtok(nullptr, separators)) {
+        if (!parseParameter(parameter, job, durationMs)) return false;
+    }
+    
+    std::shared_ptr<OfflinePart> part = std::make_shared<OfflinePart>();
+    if (strcmp(source, "script") == 0) {
+        uint32_t endMs = 0;
+        if (!loadScriptPart(path, *part, endMs)) return false;
+        if (durationMs == 0) durationMs = endMs + TAIL_MS;
+    } else {
+        if (durationMs == 0) durationMs = PROJECT_MS;
+        if (path) {
+            if (!loadProjectPart(path, durationMs, *part)) return false;
+        } else {
+            demoProjectPart(durationMs, *part);
+        }
+    }
+    
+    job.part = part;
+    job.durationMs = durationMs;
+    jobs.push_back(job);
+    return true;
+}
+
+static bool loadJobs(const char* path, uint8_t bits, std::vector<Job>& jobs) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+    
+    char line[512];
+    uint32_t lineNumber = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        char* comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+        
+        bool empty = false;
+        if (!parseJobLine(line, bits, jobs, empty)) {
+            fprintf(stderr, "%s:%u: cannot parse job\n", path, lineNumber);
+            ok = false;
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+// Задание в потоке пула: свой движок, свой файл
+static void renderJob(Job& job, const std::string& directory, bool write) {
+    const auto start = std::chrono::steady_clock::now();
+    
+    // Движок на стеке потока: new до C++17 не выравнивает под alignas(32) пула голосов
+    WaveSynthesizer synth;
+    synth.init();
+    
+    WavWriter wav;
+    const std::string path = directory + "/" + job.output;
+    if (write && !wav.open(path.c_str(), job.bits, SAMPLE_RATE)) {
+        job.ok = false;
+        return;
+    }
+    
+    PartRenderer renderer(synth, write ? &wav : nullptr);
+    renderer.render(*job.part, job.durationMs, job.voicing);
+    job.ok = !write || wav.close();
+    job.frames = renderer.getFrames();
+    job.peak = renderer.getPeak();
+    job.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void usage() {
+    fprintf(stderr, "usage: batch_render [-j threads] [-o directory] [-b 16|24] [-r copies] [-n] [jobs.txt]\n");
+}
+
+int main(int argc, char** argv) {
+    const char* jobsPath = nullptr;
+    std::string directory = ".";
+    unsigned threads = 0;
+    unsigned copies = 1;
+    uint8_t bits = 16;
+    bool write = true;
+    
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "-j") == 0 && hasValue) {
+            threads = (unsigned)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0 && hasValue) {
+            directory = argv[++i];
+        } else if (strcmp(argv[i], "-b") == 0 && hasValue) {
+            bits = (uint8_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0 && hasValue) {
+            copies = (unsigned)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0) {
+            write = false;
+        } else if (argv[i][0] != '-' && !jobsPath) {
+            jobsPath = argv[i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if ((bits != 16 && bits != 24) || copies == 0) {
+        usage();
+        return 2;
+    }
+    
+    std::vector<Job> jobs;
+    if (jobsPath) {
+        if (!loadJobs(jobsPath, bits, jobs)) return 1;
+    } else {
+        previewJobs(bits, jobs);
+    }
+    
+    // Копии для замера: те же партии, свои файлы
+    const size_t original = jobs.size();
+    for (unsigned copy = 1; copy < copies; copy++) {
+        for (size_t i = 0; i < original; i++) {
+            Job job = jobs[i];
+            job.output = std::to_string(copy) + "_" + job.output;
+            jobs.push_back(job);
+        }
+    }
+    
+    const auto start = std::chrono::steady_clock::now();
+    uint32_t steals = 0;
+    unsigned threadCount = 0;
+    {
+        WorkStealingPool pool(threads);
+        threadCount = pool.getThreadCount();
+        for (Job& job : jobs) {
+            pool.submit([&job, &directory, write] { renderJob(job, directory, write); });
+        }
+        pool.wait();
+        steals = pool.getSteals();
+    }
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    bool ok = true;
+    double audioSeconds = 0.0;
+    double busySeconds = 0.0;
+    for (const Job& job : jobs) {
+        if (!job.ok) {
+            fprintf(stderr, "%s/%s: write error\n", directory.c_str(), job.output.c_str());
+            ok = false;
+            continue;
+        }
+        const double length = (double)job.frames / SAMPLE_RATE;
+        audioSeconds += length;
+        busySeconds += job.seconds;
+        printf("%-32s %6.2f s  peak %.3f  %7.1f ms\n", job.output.c_str(), length, job.peak, job.seconds * 1000.0);
+    }
+    
+    // Загрузка потоков: доля времени, занятая рендерингом (1.0 - линейное масштабирование)
+    printf("%zu jobs, %u threads, %u steals: %.1f s of audio in %.1f ms, realtime factor %.1fx, "
+           "thread utilization %.2f\n",
+           jobs.size(), threadCount, steals, audioSeconds, wall * 1000.0, audioSeconds / wall,
+           busySeconds / (wall * threadCount));
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+/*
+ * Проверка Buzzer на ПК: точность таблицы PSC/ARR по нотам, быстрый путь
+ * (неизменные значения не записываются в регистры TIM1), арпеджио по тикам TIM6
+ * и отказ от записи в TIM1, пока таймер ведет другой вывод.
+ *
+ * Сборка из корня репозитория:
+ *
+ *   g++ -std=gnu++14 -O2 -IHost/Inc -ICore/Inc \
+ *       Host/Src/BuzzerCheck.cpp Host/Src/HalShim.cpp Host/Src/UartShim.cpp \
+ *       Core/Src/drivers/Buzzer.cpp Core/Src/synthesizer/NoteTable.cpp \
+ *       -o buzzer_check
+ *
+ * Код возврата 0 - все проверки прошли.
+ */
+
+#include "drivers/Buzzer.hpp"
+#include "synthesizer/NoteTable.hpp"
+#include "stm32f4xx_hal.h"
+#include <stdio.h>
+#include <math.h>
+
+// Диапазон фортепиано: ошибка высоты таблицы не больше цента
+static constexpr uint8_t FIRST_NOTE = 21;
+static constexpr uint8_t LAST_NOTE = 108;
+static constexpr double MAX_ERROR_CENTS = 1.0;
+// Значение, которого драйвер сам не запишет
+static constexpr uint32_t SENTINEL = 0xBEEF;
+// Арпеджио: шагов в секунду и число проверяемых тиков (несколько кругов аккорда)
+static constexpr uint16_t ARPEGGIO_RATE = 50;
+static constexpr uint32_t ARPEGGIO_TICKS = 240;
+static constexpr uint8_t CHORD[] = {60, 64, 67};
+static constexpr uint8_t CHORD_SIZE = sizeof(CHORD) / sizeof(CHORD[0]);
+
+int main() {
+    bool passed = true;
+    
+    // 1. Таблица PSC/ARR
+    double maxError = 0.0;
+    for (uint8_t note = FIRST_NOTE; note <= LAST_NOTE; note++) {
+        double target = 440.0 * pow(2.0, (note - 69) / 12.0);
+        double actual = (double)NOTE_TIMER_CLOCK /
+                        (((double)NoteTable::timerPrescaler(note) + 1) * ((double)NoteTable::timerReload(note) + 1));
+        double cents = fabs(1200.0 * log2(actual / target));
+        if (cents > maxError) maxError = cents;
+    }
+    bool ok = (maxError <= MAX_ERROR_CENTS);
+    printf("table notes %u-%u: max error %.3f cents %s\n", FIRST_NOTE, LAST_NOTE, maxError, ok ? "OK" : "FAIL");
+    passed &= ok;
+    
+    // 2. Быстрый путь: те же нота и громкость - регистры не трогаются
+    // Проверки 2-4 - прямой режим: без арпеджио регистры пишутся сразу
+    Buzzer& buzzer = Buzzer::getInstance();
+    buzzer.init();
+    buzzer.setArpeggioRate(0);
+    buzzer.playMidiNote(0, 69, 10);
+    bool tuned = (TIM1->PSC == NoteTable::timerPrescaler(69)) && (TIM1->ARR == NoteTable::timerReload(69)) &&
+                 (TIM1->CCR1 == (NoteTable::timerReload(69) + 1u) / 2);
+    TIM1->PSC = SENTINEL;
+    buzzer.playMidiNote(0, 69, 10);
+    buzzer.setVolume(0, 10);
+    buzzer.playNote(0, NoteTable::frequency(69), 10);
+    bool skipped = (TIM1->PSC == SENTINEL);
+    ok = tuned && skipped;
+    printf("fast path: tuned %s, unchanged writes skipped %s %s\n", tuned ? "yes" : "no", skipped ? "yes" : "no",
+           ok ? "OK" : "FAIL");
+    passed &= ok;
+    
+    // 3. Изменение громкости - запись всех трех регистров под UDIS, таймер не останавливается
+    buzzer.setVolume(0, 5);
+    ok = (TIM1->PSC == NoteTable::timerPrescaler(69)) && (TIM1->CCR1 == (NoteTable::timerReload(69) + 1u) / 4) &&
+         !(TIM1->CR1 & TIM_CR1_UDIS) && (TIM1->CR1 & 1u);
+    printf("volume change: PSC %u, ARR %u, CCR1 %u %s\n", (unsigned)TIM1->PSC, (unsigned)TIM1->ARR,
+           (unsigned)TIM1->CCR1, ok ? "OK" : "FAIL");
+    passed &= ok;
+    
+    // 4. Остановка - только CCR1 = 0, PSC/ARR остаются
+    buzzer.stopAll();
+    ok = (TIM1->CCR1 == 0) && (TIM1->ARR == NoteTable::timerReload(69)) && (TIM1->CR1 & 1u);
+    printf("stop: CCR1 %u, timer running %s %s\n", (unsigned)TIM1->CCR1, (TIM1->CR1 & 1u) ? "yes" : "no",
+           ok ? "OK" : "FAIL");
+    passed &= ok;
+    
+    // 5. Арпеджио: ноты аккорда по кругу, каждая ровно ticksPerStep тиков
+    const uint32_t ticksPerStep = Buzzer::ARPEGGIO_TICK_HZ / ARPEGGIO_RATE;
+    buzzer.setArpeggioRate(ARPEGGIO_RATE);
+    for (uint8_t i = 0; i < CHORD_SIZE; i++) {
+        buzzer.playMidiNote(i, CHORD[i], 10);
+    }
+    // Первый тик применяет отложенное изменение каналов
+    buzzer.onTimerTick();
+    uint8_t expected = CHORD_SIZE;
+    for (uint8_t i = 0; i < CHORD_SIZE; i++) {
+        if (TIM1->ARR == NoteTable::timerReload(CHORD[i])) expected = i;
+    }
+    ok = (expected < CHORD_SIZE);
+    uint32_t runLength = 1;
+    uint32_t steps = 0;
+    for (uint32_t t = 1; t < ARPEGGIO_TICKS && ok; t++) {
+        buzzer.onTimerTick();
+        if (TIM1->ARR != NoteTable::timerReload(CHORD[expected])) {
+            // Смена ноты: только на границе шага и только на следующую по кругу
+            expected = (uint8_t)((expected + 1) % CHORD_SIZE);
+            ok = (TIM1->ARR == NoteTable::timerReload(CHORD[expected])) && (steps == 0 || runLength == ticksPerStep);
+            runLength = 0;
+            steps++;
+        }
+        runLength++;
+    }
+    ok = ok && (steps == ARPEGGIO_TICKS / ticksPerStep - 1 || steps == ARPEGGIO_TICKS / ticksPerStep);
+    printf("arpeggio %u notes at %u steps/s: %u steps of %u ticks %s\n", CHORD_SIZE, ARPEGGIO_RATE,
+           (unsigned)steps, (unsigned)ticksPerStep, ok ? "OK" : "FAIL");
+    passed &= ok;
+    
+    // 6. Один активный канал - шаги арпеджио не пишут регистры
+    buzzer.stopNote(1);
+    buzzer.stopNote(2);
+    buzzer.onTimerTick();
+    TIM1->PSC = SENTINEL;
+    for (uint32_t t = 0; t < ARPEGGIO_TICKS; t++) {
+        buzzer.onTimerTick();
+    }
+    ok = (TIM1->PSC == SENTINEL) && (TIM1->ARR == NoteTable::timerReload(CHORD[0]));
+    printf("arpeggio single note: writes skipped %s %s\n", (TIM1->PSC == SENTINEL) ? "yes" : "no",
+           ok ? "OK" : "FAIL");
+    passed &= ok;
+    
+    // 7. TIM1 отдан другому выводу: ни задача, ни тик не пишут регистры,
+    // init() забирает таймер обратно
+    buzzer.releaseTimer();
+    TIM1->PSC = SENTINEL;
+    TIM1->ARR = SENTINEL;
+    TIM1->CCR1 = SENTINEL;
+    buzzer.playMidiNote(1, 72, 10);
+    buzzer.playNote(2, Buzzer::NOTE_A4, 10);
+    for (uint32_t t = 0; t < ARPEGGIO_TICKS; t++) {
+        buzzer.onTimerTick();
+    }
+    buzzer.setArpeggioRate(0);
+    buzzer.stopAll();
+    bool untouched = (TIM1->PSC == SENTINEL) && (TIM1->ARR == SENTINEL) && (TIM1->CCR1 == SENTINEL);
+    buzzer.init();
+    buzzer.setArpeggioRate(0);
+    buzzer.playMidiNote(0, 69, 10);
+    bool reclaimed = buzzer.ownsTimer() && (TIM1->ARR == NoteTable::timerReload(69));
+    ok = untouched && reclaimed;
+    printf("released timer: writes blocked %s, reclaimed by init %s %s\n", untouched ? "yes" : "no",
+           reclaimed ? "yes" : "no", ok ? "OK" : "FAIL");
+    passed &= ok;
+    
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+/*
+ * Микробенчмарки DSP на ПК: генераторы, огибающая, сигма-дельта модулятор
+ * и микшер для 1-32 голосов каждой волны (SynthBenchmark), вывод CSV/JSON.
+ * На плате тот же набор запускается из консоли UART: 'b' - CSV, 'j' - JSON,
+ * время там в тактах DWT->CYCCNT.
+ *
+ * Сборка из корня репозитория (-DSYNTH_FIXED_POINT=1 - целочисленный путь:
+ * mixBlockQ15 и Envelope::processQ15):
+ *
+ *   g++ -std=gnu++14 -O2 -IHost/Inc -ICore/Inc \
+ *       Host/Src/DspBenchmark.cpp Host/Src/HalShim.cpp Host/Src/UartShim.cpp \
+ *       Core/Src/synthesizer/SynthBenchmark.cpp Core/Src/synthesizer/SigmaDeltaModulator.cpp \
+ *       Core/Src/synthesizer/WaveSynthesizer.cpp Core/Src/synthesizer/VoiceMixer.cpp \
+ *       Core/Src/synthesizer/WaveGenerator.cpp Core/Src/synthesizer/WaveBank.cpp \
+ *       Core/Src/synthesizer/NoteTable.cpp Core/Src/synthesizer/Envelope.cpp \
+ *       Core/Src/synthesizer/VoiceKernels.cpp -o dsp_benchmark
+ *
+ * Запуск:
+ *
+ *   ./dsp_benchmark [-f csv|json] [-s семплов] [-o файл]
+ *
+ * Без -o - в stdout. Код возврата 0 - все замеры выведены.
+ */
+
+#include "synthesizer/SynthBenchmark.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static constexpr uint32_t HOST_SAMPLES = 8192;  // На ПК таймер грубее тактов - замеры длиннее
+
+static FILE* output = stdout;
+
+static void writeLine(const char* text) {
+    fputs(text, output);
+}
+
+static void usage() {
+    fprintf(stderr, "usage: dsp_benchmark [-f csv|json] [-s samples] [-o file]\n");
+}
+
+int main(int argc, char** argv) {
+    SynthBenchmark::Format format = SynthBenchmark::Format::CSV;
+    uint32_t samples = HOST_SAMPLES;
+    const char* outPath = nullptr;
+    
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "-f") == 0 && hasValue) {
+            const char* name = argv[++i];
+            if (strcmp(name, "csv") == 0) {
+                format = SynthBenchmark::Format::CSV;
+            } else if (strcmp(name, "json") == 0) {
+                format = SynthBenchmark::Format::JSON;
+            } else {
+                usage();
+                return 2;
+            }
+        } else if (strcmp(argv[i], "-s") == 0 && hasValue) {
+            samples = (uint32_t)atol(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0 && hasValue) {
+            outPath = argv[++i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (samples == 0) {
+        usage();
+        return 2;
+    }
+    
+    if (outPath) {
+        output = fopen(outPath, "w");
+        if (!output) {
+            fprintf(stderr, "%s: cannot create\n", outPath);
+            return 1;
+        }
+    }
+    
+    SynthBenchmark& bench = SynthBenchmark::getInstance();
+    bench.start(format, samples);
+    while (bench.step(writeLine)) {
+    }
+    
+    if (outPath && fclose(output) != 0) {
+        fprintf(stderr, "%s: write error\n", outPath);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,206 @@
+/*
+ * Нагрузочная проверка очереди событий SpscQueue на ПК: писатель и читатель
+ * в отдельных потоках std::thread. Проверяются порядок и целостность
+ * элементов (без потерь и разорванных записей), атомарность групп push
+ * и сквозной путь SigmaDeltaAdapter: задача кладет события, рендерер
+ * в "прерывании" DMA применяет их на границах блоков.
+ *
+ * Сборка из корня репозитория:
+ *
+ *   g++ -std=gnu++14 -O2 -pthread -IHost/Inc -ICore/Inc \
+ *       Host/Src/EventQueueCheck.cpp Host/Src/HalShim.cpp Host/Src/UartShim.cpp \
+ *       Core/Src/synthesizer/SigmaDeltaAdapter.cpp Core/Src/synthesizer/SigmaDeltaPWM.cpp \
+ *       Core/Src/synthesizer/SigmaDeltaModulator.cpp Core/Src/synthesizer/PolyphaseInterpolator.cpp \
+ *       Core/Src/synthesizer/PatternModulator.cpp \
+ *       Core/Src/synthesizer/WaveSynthesizer.cpp Core/Src/synthesizer/VoiceMixer.cpp \
+ *       Core/Src/synthesizer/WaveGenerator.cpp Core/Src/synthesizer/WaveBank.cpp \
+ *       Core/Src/synthesizer/NoteTable.cpp Core/Src/synthesizer/Envelope.cpp \
+ *       Core/Src/synthesizer/VoiceKernels.cpp -o event_queue_check
+ *
+ * С -fsanitize=thread вместо -O2 гонки между потоками выводит ThreadSanitizer.
+ *
+ * Код возврата 0 - все проверки прошли.
+ */
+
+#include "utils/SpscQueue.hpp"
+#include "synthesizer/SigmaDeltaAdapter.hpp"
+#include <stdio.h>
+#include <thread>
+#include <atomic>
+
+// Элемент с избыточными полями: разорванная запись дает несовпадение
+struct Item {
+    uint32_t seq;
+    uint32_t check;
+    uint8_t groupPos;  // Позиция в группе push(items, count)
+    uint8_t groupLen;
+};
+
+static uint32_t checkWord(uint32_t seq) { return seq * 2654435761u ^ 0xA5A5A5A5u; }
+
+static Item makeItem(uint32_t seq, uint8_t pos, uint8_t len) {
+    Item item;
+    item.seq = seq;
+    item.check = checkWord(seq);
+    item.groupPos = pos;
+    item.groupLen = len;
+    return item;
+}
+
+// 1. Однопоточные граничные случаи: заполнение, переполнение, группа
+// "все или ничего", переход индексов через 0
+static bool checkBasics() {
+    SpscQueue<Item, 8> queue;
+    bool passed = true;
+    
+    for (uint32_t i = 0; i < 8; i++) {
+        passed &= queue.push(makeItem(i, 0, 1));
+    }
+    passed &= !queue.push(makeItem(8, 0, 1));
+    passed &= queue.getDropped() == 1 && queue.getCount() == 8;
+    
+    Item item;
+    for (uint32_t i = 0; i < 8; i++) {
+        passed &= queue.pop(item) && item.seq == i;
+    }
+    passed &= !queue.pop(item) && queue.isEmpty();
+    
+    // Группа больше свободного места не пишется частично
+    Item group[5];
+    for (uint8_t i = 0; i < 5; i++) group[i] = makeItem(100 + i, i, 5);
+    passed &= queue.push(group, 5);
+    passed &= !queue.push(group, 5);
+    passed &= queue.getCount() == 5 && queue.getDropped() == 2;
+    uint32_t next = 100;
+    queue.consume([&](const Item& it) { passed &= it.seq == next++; });
+    passed &= next == 105 && queue.isEmpty();
+    
+    printf("basics: %s\n", passed ? "OK" : "FAIL");
+    return passed;
+}
+
+// 2. Писатель и читатель в разных потоках. Писатель на полной очереди
+// повторяет push (без потерь), читатель чередует pop и consume
+static bool checkStress(uint32_t count) {
+    static SpscQueue<Item, 64> queue;
+    std::atomic<bool> failed(false);
+    
+    std::thread producer([&]() {
+        uint32_t seq = 0;
+        while (seq < count) {
+            // Группы по 1-4 элемента, длина - от номера
+            uint8_t len = (uint8_t)(1 + (seq >> 3) % 4);
+            if (seq + len > count) len = (uint8_t)(count - seq);
+            Item group[4];
+            for (uint8_t i = 0; i < len; i++) group[i] = makeItem(seq + i, i, len);
+            while (!queue.push(group, len)) {
+                std::this_thread::yield();
+            }
+            seq += len;
+        }
+    });
+    
+    uint32_t expected = 0;
+    uint32_t consumeCalls = 0;
+    auto verify = [&](const Item& it) {
+        if (it.seq != expected || it.check != checkWord(it.seq)) failed = true;
+        expected++;
+    };
+    
+    while (expected < count && !failed) {
+        if ((expected & 1) == 0) {
+            // consume видит только целые группы: снимок кончается на конце группы
+            bool whole = true;
+            uint32_t n = queue.consume([&](const Item& it) {
+                verify(it);
+                whole = (it.groupPos + 1 == it.groupLen);
+            });
+            if (n > 0) {
+                consumeCalls++;
+                if (!whole) failed = true;
+            } else {
+                std::this_thread::yield();
+            }
+        } else {
+            Item item;
+            if (queue.pop(item)) {
+                verify(item);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+    producer.join();
+    
+    bool passed = !failed && expected == count && queue.isEmpty();
+    printf("stress: %u items, %u consume snapshots, dropped pushes %u: %s\n",
+           expected, consumeCalls, queue.getDropped(), passed ? "OK" : "FAIL");
+    return passed;
+}
+
+// 3. SigmaDeltaAdapter: задача в одном потоке играет ноты и меняет ADSR,
+// поток DMA рендерит. После allNotesOff голоса гаснут, события не теряются
+static bool checkAdapter() {
+    SigmaDeltaAdapter& adapter = SigmaDeltaAdapter::getInstance();
+    if (!adapter.init()) {
+        printf("adapter: init FAIL\n");
+        return false;
+    }
+    
+    std::atomic<bool> stop(false);
+    std::atomic<uint32_t> peak(0);
+    
+    std::thread dma([&]() {
+        while (!stop) {
+            for (uint32_t i = 0; i < 1000; i++) {
+                hostDmaStep(&hdma_tim1_up);
+            }
+            uint32_t voices = adapter.getActiveVoices();
+            if (voices > peak) peak = voices;
+        }
+    });
+    
+    // Писатель ждет, если рендерер не успел разобрать очередь
+    uint32_t posted = 0;
+    auto send = [&](bool ok) { posted++; return ok; };
+    const uint32_t startFrame = adapter.getFrameTime();
+    for (uint32_t i = 0; i < 4000; i++) {
+        uint8_t channel = (uint8_t)(i % WaveSynthesizer::MAX_CHANNELS);
+        uint8_t note = (uint8_t)(36 + (i * 7) % 48);
+        while (!send(adapter.noteOn(channel, note, 100))) std::this_thread::yield();
+        if (i % 16 == 0) {
+            ADSR adsr(5 + i % 20, 30, (uint8_t)(i % 11), 20);
+            while (!send(adapter.setADSR(channel, adsr))) std::this_thread::yield();
+        }
+        if (i >= 8) {
+            uint8_t old = (uint8_t)(36 + ((i - 8) * 7) % 48);
+            while (!send(adapter.noteOff((uint8_t)((i - 8) % WaveSynthesizer::MAX_CHANNELS), old))) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    while (!adapter.allNotesOff()) std::this_thread::yield();
+    
+    // Очередь разобрана и голоса погашены - через несколько блоков
+    const uint32_t deadline = adapter.getFrameTime() + 8 * SigmaDeltaPWM::BLOCK_FRAMES;
+    while (adapter.getFrameTime() < deadline) std::this_thread::yield();
+    stop = true;
+    dma.join();
+    
+    const uint32_t frames = adapter.getFrameTime() - startFrame;
+    bool passed = adapter.getActiveVoices() == 0 && peak > 0 && frames > 0;
+    printf("adapter: %u posts (%u retried), %u frames, peak %u voices, active after all-off %u, underruns %u: %s\n",
+           posted, adapter.getDroppedEvents(), frames, peak.load(), adapter.getActiveVoices(),
+           adapter.getUnderruns(), passed ? "OK" : "FAIL");
+    return passed;
+}
+
+int main() {
+    bool passed = true;
+    passed &= checkBasics();
+    passed &= checkStress(2000000);
+    passed &= checkAdapter();
+    
+    printf("%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,209 @@
+/*
+ * Проверка планирования событий по кадрам на ПК: SigmaDeltaAdapter делит
+ * блок по кадрам событий, ноты начинаются на своем семпле при любом
+ * размере блока, живые ноты через DMA - с постоянной задержкой от кадра
+ * вывода (без джиттера блока).
+ *
+ * Сборка из корня репозитория:
+ *
+ *   g++ -std=gnu++14 -O2 -IHost/Inc -ICore/Inc \
+ *       Host/Src/EventTimingCheck.cpp Host/Src/HalShim.cpp Host/Src/UartShim.cpp \
+ *       Core/Src/synthesizer/SigmaDeltaAdapter.cpp Core/Src/synthesizer/SigmaDeltaPWM.cpp \
+ *       Core/Src/synthesizer/SigmaDeltaModulator.cpp Core/Src/synthesizer/PolyphaseInterpolator.cpp \
+ *       Core/Src/synthesizer/PatternModulator.cpp \
+ *       Core/Src/synthesizer/WaveSynthesizer.cpp Core/Src/synthesizer/VoiceMixer.cpp \
+ *       Core/Src/synthesizer/WaveGenerator.cpp Core/Src/synthesizer/WaveBank.cpp \
+ *       Core/Src/synthesizer/NoteTable.cpp Core/Src/synthesizer/Envelope.cpp \
+ *       Core/Src/synthesizer/VoiceKernels.cpp -o event_timing_check
+ *
+ * Код возврата 0 - все проверки прошли.
+ */
+
+#include "synthesizer/SigmaDeltaAdapter.hpp"
+#include <stdio.h>
+#include <string.h>
+
+// Прогон 0.1 с при 44100 Гц: партия ниже с релизами укладывается в него
+static constexpr uint32_t RUN_FRAMES = 4400;
+
+// Партия: (кадр от начала прогона, канал, нота, длительность в кадрах)
+struct ScheduledNote {
+    uint32_t offset;
+    uint8_t channel;
+    uint8_t note;
+    uint32_t length;
+};
+
+static const ScheduledNote PART[] = {
+    { 100, 0, 69, 900 },
+    { 101, 1, 64, 700 },
+    { 777, 2, 72, 1500 },
+    { 1023, 0, 57, 333 },
+    { 1024, 3, 60, 2048 },
+    { 2047, 1, 76, 1000 },
+    { 2500, 4, 48, 1 },
+    { 3001, 5, 81, 500 },
+};
+
+static int16_t reference[RUN_FRAMES];
+static int16_t output[RUN_FRAMES];
+
+// Прогон партии с рендерингом блоками по blockFrames, без PWM
+static void renderPart(uint32_t blockFrames, int16_t* out) {
+    SigmaDeltaAdapter& adapter = SigmaDeltaAdapter::getInstance();
+    const uint32_t start = adapter.getFrameTime();
+    for (const ScheduledNote& n : PART) {
+        adapter.noteOnAt(start + n.offset, n.channel, n.note, 100);
+        adapter.noteOffAt(start + n.offset + n.length, n.channel, n.note);
+    }
+    
+    for (uint32_t done = 0; done < RUN_FRAMES; done += blockFrames) {
+        uint32_t count = (RUN_FRAMES - done < blockFrames) ? RUN_FRAMES - done : blockFrames;
+        adapter.render(out + done, count);
+    }
+    
+    // Тишина перед следующим прогоном
+    adapter.allNotesOff();
+    int16_t silence[64];
+    adapter.render(silence, 64);
+}
+
+static uint32_t firstSound(const int16_t* out, uint32_t from, uint32_t to) {
+    for (uint32_t i = from; i < to; i++) {
+        if (out[i] != 0) return i;
+    }
+    return to;
+}
+
+// Начало одиночной ноты, отрендеренное офлайн с кадра события
+static constexpr uint32_t NOTE_HEAD = 64;
+static int16_t noteHead[NOTE_HEAD];
+
+static void renderNoteHead() {
+    SigmaDeltaAdapter& adapter = SigmaDeltaAdapter::getInstance();
+    adapter.noteOnAt(adapter.getFrameTime(), 0, 69, 100);
+    adapter.render(noteHead, NOTE_HEAD);
+    adapter.allNotesOff();
+    int16_t silence[64];
+    adapter.render(silence, 64);
+}
+
+// 1. Офлайн: блоки разного размера дают побитно тот же сигнал, что рендеринг
+// по одному семплу, первая нота звучит с запланированного кадра
+static bool checkBlockSizes() {
+    bool passed = true;
+    renderPart(1, reference);
+    
+    // До первой ноты - тишина, с ее кадра - то же, что у одиночной ноты
+    const uint32_t onset = firstSound(reference, 0, RUN_FRAMES);
+    passed &= onset > PART[0].offset && onset <= PART[0].offset + 2;
+    passed &= memcmp(reference + PART[0].offset, noteHead, PART[1].offset - PART[0].offset) == 0;
+    printf("first note: scheduled %u, first non-zero sample %u\n", PART[0].offset, onset);
+    
+    static const uint32_t BLOCKS[] = { 7, 16, 64, 100, 256, 1024, 4096 };
+    for (uint32_t block : BLOCKS) {
+        renderPart(block, output);
+        uint32_t mismatch = RUN_FRAMES;
+        for (uint32_t i = 0; i < RUN_FRAMES; i++) {
+            if (output[i] != reference[i]) { mismatch = i; break; }
+        }
+        bool ok = mismatch == RUN_FRAMES;
+        if (ok) {
+            printf("block %4u: identical to per-sample render\n", block);
+        } else {
+            printf("block %4u: differs at frame %u FAIL\n", block, mismatch);
+        }
+        passed &= ok;
+    }
+    return passed;
+}
+
+// Захват вывода рендерера в потоке DMA: кадр -> семпл
+static int16_t captured[1 << 16];
+static uint32_t capturedFrames;
+
+static void captureRender(int16_t* out, size_t frames) {
+    SigmaDeltaAdapter::getInstance().render(out, frames);
+    for (size_t i = 0; i < frames && capturedFrames < (1u << 16); i++) {
+        captured[capturedFrames++] = out[i];
+    }
+}
+
+// 2. Живые ноты через модель DMA: нота нажата на произвольной передаче DMA,
+// звук начинается через ровно два блока после кадра вывода
+static bool checkLiveLatency() {
+    SigmaDeltaAdapter& adapter = SigmaDeltaAdapter::getInstance();
+    SigmaDeltaPWM& pwm = SigmaDeltaPWM::getInstance();
+    adapter.allNotesOff();
+    adapter.update();
+    
+    const uint32_t origin = adapter.getFrameTime();
+    capturedFrames = 0;
+    if (!adapter.init()) {
+        printf("live: init FAIL\n");
+        return false;
+    }
+    // Первые два блока отрендерены в start(), до подмены - их заменяет тишина
+    pwm.setRenderCallback(captureRender);
+    capturedFrames = adapter.getFrameTime() - origin;
+    memset(captured, 0, capturedFrames * sizeof(int16_t));
+    
+    const uint32_t transfersPerFrame = pwm.getOversampling() * pwm.getInterpolation();
+    const uint32_t latency = 2 * pwm.getRenderFrames();
+    bool passed = true;
+    uint32_t steps = 0;
+    uint32_t maxError = 0;
+    
+    // Нажатия с шагом, не кратным ни блоку, ни периоду ШИМ на семпл
+    for (uint32_t press = 0; press < 24; press++) {
+        const uint32_t target = steps + 5000 + press * 1237;
+        while (steps < target) {
+            hostDmaStep(&hdma_tim1_up);
+            steps++;
+        }
+        
+        const uint32_t played = steps / transfersPerFrame;
+        passed &= adapter.getPlaybackFrame() - origin == played;
+        adapter.noteOn(0, 69, 100);
+        
+        // Доиграть, пока нота не отрендерена, и найти кадр, с которого
+        // вывод совпадает с началом одиночной ноты
+        const uint32_t expected = played + latency;
+        while (capturedFrames < expected + 2 * NOTE_HEAD) {
+            hostDmaStep(&hdma_tim1_up);
+            steps++;
+        }
+        uint32_t start = expected + NOTE_HEAD;
+        for (uint32_t f = played; f < expected + NOTE_HEAD; f++) {
+            if (memcmp(captured + f, noteHead, sizeof(noteHead)) == 0) { start = f; break; }
+        }
+        passed &= firstSound(captured, played, start) == start;  // До ноты - тишина
+        uint32_t error = (start > expected) ? start - expected : expected - start;
+        if (error > maxError) maxError = error;
+        
+        adapter.allNotesOff();
+        const uint32_t silentFrom = capturedFrames + 2 * latency;
+        while (capturedFrames < silentFrom) {
+            hostDmaStep(&hdma_tim1_up);
+            steps++;
+        }
+    }
+    pwm.stop();
+    
+    passed &= maxError == 0 && pwm.getUnderruns() == 0;
+    printf("live: 24 presses, latency %u frames, max onset error %u frames: %s\n",
+           latency, maxError, passed ? "OK" : "FAIL");
+    return passed;
+}
+
+int main() {
+    WaveSynthesizer::getInstance().init();
+    renderNoteHead();
+    
+    bool passed = true;
+    passed &= checkBlockSizes();
+    passed &= checkLiveLatency();
+    
+    printf("%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,39 @@
+/*
+ * Контрольная сумма Q15 рендеринга на ПК (переносимая реализация DspMath).
+ * Та же сумма печатается на плате командой 'x' в UART (DSP-инструкции M4) -
+ * совпадение подтверждает побитную эквивалентность двух сборок.
+ *
+ * Сборка из корня репозитория:
+ *
+ *   g++ -std=gnu++14 -O2 -DSYNTH_FIXED_POINT=1 -IHost/Inc -ICore/Inc \
+ *       Host/Src/FixedPointCheck.cpp Host/Src/HalShim.cpp Host/Src/UartShim.cpp \
+ *       Core/Src/synthesizer/SynthSelfTest.cpp \
+ *       Core/Src/synthesizer/WaveSynthesizer.cpp Core/Src/synthesizer/VoiceMixer.cpp \
+ *       Core/Src/synthesizer/WaveGenerator.cpp Core/Src/synthesizer/WaveBank.cpp \
+ *       Core/Src/synthesizer/NoteTable.cpp Core/Src/synthesizer/Envelope.cpp \
+ *       Core/Src/synthesizer/VoiceKernels.cpp -o fixed_point_check
+ *
+ * Код возврата 0 - сумма совпала с SynthSelfTest::expectedChecksum().
+ */
+
+#include "synthesizer/SynthSelfTest.hpp"
+#include "synthesizer/WaveSynthesizer.hpp"
+#include "synthesizer/VoicePool.hpp"
+#include <stdio.h>
+
+int main() {
+    WaveSynthesizer::getInstance().init();
+    uint32_t crc = SynthSelfTest::renderChecksum();
+    
+    printf("kernel: %s\n", VoiceKernels::name());
+    printf("checksum: 0x%08X\n", crc);
+    
+    if (!SynthSelfTest::isChecksumComparable()) {
+        printf("float mode - no reference checksum\n");
+        return 0;
+    }
+    
+    bool passed = (crc == SynthSelfTest::expectedChecksum());
+    printf("expected: 0x%08X %s\n", SynthSelfTest::expectedChecksum(), passed ? "OK" : "FAIL");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,389 @@
+/*
+ * Эталонный звук на ПК: фиксированные сценарии (аккорды, ADSR, барабаны,
+ * кража голосов) рендерятся WaveSynthesizer через PartRenderer и
+ * сравниваются с эталонами Host/Golden/<сценарий>.wav:
+ *
+ *   level    - наибольшая разность громкости (СКЗ) по окнам 1024 с шагом 512,
+ *              дБ; окна тише LEVEL_GATE_DB в обоих сигналах не считаются
+ *              (хвосты релизов)
+ *   spectral - спектральное расстояние: СКО разности спектров в дБ по
+ *              полосам окон STFT (1024, Ханн, шаг 512), взвешенное энергией
+ *              полосы; полосы ниже SPECTRAL_FLOOR_DB в обоих сигналах
+ *              (остатки алиасинга, шум квантования 16 бит) не считаются.
+ *              Ошибка усиления в k раз дает ровно 20*log10(k) дБ
+ *   peak     - наибольшая разность семплов (1.0 - полная шкала), по
+ *              умолчанию только выводится
+ *
+ * Эталоны записаны float-сборкой с настройками по умолчанию. Любая
+ * оптимизация DSP (фиксированная точка, таблицы, SIMD, размер блока)
+ * проверяется сборкой с ее флагами и прогоном против тех же эталонов:
+ *
+ *   g++ -std=gnu++14 -O2 -IHost/Inc -ICore/Inc \
+ *       Host/Src/GoldenAudioCheck.cpp Host/Src/PartRenderer.cpp \
+ *       Host/Src/WavWriter.cpp Host/Src/WavReader.cpp \
+ *       Host/Src/HalShim.cpp Host/Src/UartShim.cpp \
+ *       Core/Src/synthesizer/WaveSynthesizer.cpp Core/Src/synthesizer/VoiceMixer.cpp \
+ *       Core/Src/synthesizer/WaveGenerator.cpp Core/Src/synthesizer/WaveBank.cpp \
+ *       Core/Src/synthesizer/NoteTable.cpp Core/Src/synthesizer/Envelope.cpp \
+ *       Core/Src/synthesizer/VoiceKernels.cpp -o golden_audio_check
+ *
+ * Варианты: -DSYNTH_FIXED_POINT=1, -DWAVE_BANK_ENABLED=0 -DVOICE_SOA_ENABLED=0,
+ * -DAUDIO_BLOCK_SIZE=32, -mavx2. Рендер по одному голосу без SoA/SIMD - ключ -s.
+ *
+ * Все варианты проходят с допусками по умолчанию: Q15 дает до 0.1 дБ level,
+ * PolyBLEP вместо таблиц меняет форму волны (peak до 0.13) при той же
+ * громкости, spectral до 0.9 дБ. Усиление x0.75 или x1.2, выпавшие 256
+ * семплов - уже FAIL. Варианты, которые совпадают с эталоном до округления
+ * float (SIMD, -s, размер блока), можно проверить строже ключом -p 0.001.
+ *
+ * Запуск из корня репозитория:
+ *
+ *   ./golden_audio_check [-r каталог] [-s] [-l дБ] [-d дБ] [-p допуск] [-w каталог] [-u]
+ *
+ *   -r  каталог эталонов (по умолчанию Host/Golden)
+ *   -s  VoiceMixer без SoA пула (renderVoice по одному голосу)
+ *   -l  допуск level, дБ (по умолчанию LEVEL_TOLERANCE_DB)
+ *   -d  допуск spectral, дБ (по умолчанию SPECTRAL_TOLERANCE_DB)
+ *   -p  допуск peak (по умолчанию не проверяется)
+ *   -w  записать рендеры в каталог (послушать расхождение)
+ *   -u  перезаписать эталоны текущим рендером - только после проверки на слух
+ *
+ * Код возврата 0 - все сценарии в допусках.
+ */
+
+#include "PartRenderer.hpp"
+#include "WavReader.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Допуски по умолчанию: Q15 дает до 0.1 дБ level, PolyBLEP - до 0.9 дБ
+// spectral; усиление x0.75 (-2.5 дБ) проваливает обе метрики
+static constexpr float LEVEL_TOLERANCE_DB = 1.0f;
+static constexpr float SPECTRAL_TOLERANCE_DB = 1.5f;
+
+static constexpr uint32_t FFT_SIZE = 1024;
+static constexpr uint32_t FFT_HOP = FFT_SIZE / 2;
+static constexpr float SPECTRAL_FLOOR_DB = -70.0f;  // Относительно синуса полной шкалы
+static constexpr float LEVEL_GATE_DB = -40.0f;      // Относительно синуса полной шкалы
+
+// Кусок сценария: партия до endMs с подменой звучания
+struct Segment {
+    OfflinePart part;
+    uint32_t endMs;
+    PartVoicing voicing;
+};
+
+typedef std::vector<Segment> Scenario;
+
+struct ScenarioInfo {
+    const char* name;
+    void (*build)(Scenario& scenario);
+};
+
+static void addNote(OfflinePart& part, uint32_t startMs, uint32_t lengthMs, uint8_t channel, uint8_t note,
+                    uint8_t velocity, WaveType wave) {
+    part.push_back({ startMs, OfflineNote::NOTE_ON, channel, note, velocity, (uint8_t)wave });
+    part.push_back({ startMs + lengthMs, OfflineNote::NOTE_OFF, channel, note, 0, OfflineNote::NO_WAVE });
+}
+
+static void addSegment(Scenario& scenario, OfflinePart& part, uint32_t endMs,
+                       const PartVoicing& voicing = PartVoicing()) {
+    std::stable_sort(part.begin(), part.end(),
+                     [](const OfflineNote& a, const OfflineNote& b) { return a.time < b.time; });
+    scenario.push_back({ part, endMs, voicing });
+}
+
+// Аккорды разными волнами внахлест, с релизом по умолчанию
+static void buildChords(Scenario& scenario) {
+    static const uint8_t CHORDS[][4] = {
+        { 60, 64, 67, 0 },   // C
+        { 53, 57, 60, 0 },   // F
+        { 55, 59, 62, 65 },  // G7
+        { 57, 60, 64, 0 },   // Am
+    };
+    static const WaveType WAVES[] = { WaveType::SINE, WaveType::SAWTOOTH, WaveType::SQUARE, WaveType::TRIANGLE };
+    
+    OfflinePart part;
+    for (uint8_t c = 0; c < 4; c++) {
+        for (uint8_t n = 0; n < 4 && CHORDS[c][n]; n++) {
+            addNote(part, c * 150, 300, c, CHORDS[c][n], 90 + 10 * n, WAVES[c]);
+        }
+    }
+    addSegment(scenario, part, 1000);
+}
+
+// Одна и та же фраза пилой с разными огибающими, в том числе экспоненциальной
+static void buildAdsrSweep(Scenario& scenario) {
+    static const ADSR ENVELOPES[] = {
+        ADSR(1, 40, 0, 60),
+        ADSR(120, 60, 5, 80),
+        ADSR(5, 150, 2, 150, EnvelopeCurve::EXPONENTIAL),
+        ADSR(30, 30, 10, 250, EnvelopeCurve::EXPONENTIAL),
+    };
+    
+    uint32_t start = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        OfflinePart part;
+        addNote(part, start, 180, 0, 57 + 5 * i, 110, WaveType::SAWTOOTH);
+        addNote(part, start + 60, 120, 1, 64 + 5 * i, 80, WaveType::SAWTOOTH);
+        PartVoicing voicing;
+        voicing.hasAdsr = true;
+        voicing.adsr = ENVELOPES[i];
+        start += 300;
+        addSegment(scenario, part, start, voicing);
+    }
+}
+
+// Такт шестнадцатыми на 120 BPM: все пресеты DrumPreset
+static void buildDrums(Scenario& scenario) {
+    static const char* const PATTERN[] = {
+        "x...x...",  // KICK
+        "..x...x.",  // SNARE
+        "xxxxxxxx",  // HIHAT
+        "x.......",  // CRASH
+        "...x...x",  // RIDE
+        ".....x..",  // TOM_HIGH
+        "......x.",  // TOM_MID
+        ".......x",  // TOM_LOW
+    };
+    
+    OfflinePart part;
+    for (uint8_t preset = 0; preset < 8; preset++) {
+        for (uint8_t step = 0; step < 8; step++) {
+            if (PATTERN[preset][step] != 'x') continue;
+            part.push_back({ step * 125u, OfflineNote::DRUM, 0, preset, (uint8_t)(100 - 5 * preset),
+                             OfflineNote::NO_WAVE });
+        }
+    }
+    addSegment(scenario, part, 1200);
+}
+
+// 40 нот на 32 голоса: кража звучащих и отпущенных голосов, шум на канале 3
+static void buildVoiceStealing(Scenario& scenario) {
+    static const WaveType WAVES[] = { WaveType::SINE, WaveType::SAWTOOTH, WaveType::SQUARE, WaveType::NOISE };
+    
+    OfflinePart part;
+    for (uint8_t i = 0; i < 40; i++) {
+        const uint8_t channel = i % 4;
+        addNote(part, i * 12, (i % 3 == 0) ? 60 : 500, channel, 40 + i, 70 + (i % 5) * 10, WAVES[channel]);
+    }
+    addSegment(scenario, part, 800);
+}
+
+static const ScenarioInfo SCENARIOS[] = {
+    { "chords", buildChords },
+    { "adsr_sweep", buildAdsrSweep },
+    { "drums", buildDrums },
+    { "voice_stealing", buildVoiceStealing },
+};
+
+// Рендер сценария на новом экземпляре движка
+static void renderScenario(const ScenarioInfo& info, bool scalar, std::vector<float>& out) {
+    Scenario scenario;
+    info.build(scenario);
+    
+    WaveSynthesizer synth;
+    synth.init();
+    if (scalar) synth.getMixer().setSoaEnabled(false);
+    PartRenderer renderer(synth, nullptr);
+    renderer.setCapture(&out);
+    for (const Segment& segment : scenario) {
+        renderer.render(segment.part, segment.endMs, segment.voicing);
+    }
+}
+
+// Быстрое преобразование Фурье по основанию 2, на месте
+static void fft(std::vector<float>& re, std::vector<float>& im) {
+    const size_t n = re.size();
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+    }
+    for (size_t length = 2; length <= n; length <<= 1) {
+        const double angle = -2.0 * M_PI / (double)length;
+        for (size_t i = 0; i < n; i += length) {
+            for (size_t k = 0; k < length / 2; k++) {
+                const float wr = (float)cos(angle * k);
+                const float wi = (float)sin(angle * k);
+                const size_t a = i + k;
+                const size_t b = a + length / 2;
+                const float tr = re[b] * wr - im[b] * wi;
+                const float ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
+
+// Мощность полос окна относительно синуса полной шкалы
+static void spectrumPower(const std::vector<float>& signal, size_t start, std::vector<float>& power) {
+    std::vector<float> re(FFT_SIZE), im(FFT_SIZE, 0.0f);
+    for (uint32_t i = 0; i < FFT_SIZE; i++) {
+        const float window = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * i / FFT_SIZE);
+        re[i] = (start + i < signal.size()) ? signal[start + i] * window : 0.0f;
+    }
+    fft(re, im);
+    
+    // Синус амплитуды 1 с окном Ханна дает в своей полосе FFT_SIZE / 4
+    const float reference = (float)FFT_SIZE / 4.0f;
+    power.resize(FFT_SIZE / 2 + 1);
+    for (uint32_t k = 0; k <= FFT_SIZE / 2; k++) {
+        power[k] = (re[k] * re[k] + im[k] * im[k]) / (reference * reference);
+    }
+}
+
+// СКО разности спектров в дБ с весом - мощностью громче из двух полос.
+// Полосы у пола в обоих сигналах не влияют, а тихие полосы с большой
+// разностью в дБ (алиасинг, спад PolyBLEP у Найквиста) весят мало
+static float spectralDistance(const std::vector<float>& a, const std::vector<float>& b) {
+    const float floorPower = powf(10.0f, SPECTRAL_FLOOR_DB / 10.0f);
+    std::vector<float> powerA, powerB;
+    double weights = 0.0, squares = 0.0;
+    for (size_t start = 0; start < a.size(); start += FFT_HOP) {
+        spectrumPower(a, start, powerA);
+        spectrumPower(b, start, powerB);
+        for (size_t k = 0; k < powerA.size(); k++) {
+            const float weight = std::max(powerA[k], powerB[k]);
+            if (weight <= floorPower) continue;
+            const double diff = 10.0 * log10(std::max(powerA[k], floorPower) / std::max(powerB[k], floorPower));
+            weights += weight;
+            squares += weight * diff * diff;
+        }
+    }
+    return weights > 0.0 ? (float)sqrt(squares / weights) : 0.0f;
+}
+
+// Наибольшая разность громкости по окнам, дБ
+static float levelError(const std::vector<float>& a, const std::vector<float>& b) {
+    // Синус полной шкалы - средний квадрат 0.5
+    const double gate = 0.5 * pow(10.0, LEVEL_GATE_DB / 10.0);
+    float error = 0.0f;
+    for (size_t start = 0; start < a.size(); start += FFT_HOP) {
+        const size_t end = std::min(start + FFT_SIZE, a.size());
+        double energyA = 0.0, energyB = 0.0;
+        for (size_t i = start; i < end; i++) {
+            energyA += (double)a[i] * a[i];
+            energyB += (double)b[i] * b[i];
+        }
+        if (std::max(energyA, energyB) <= gate * (end - start)) continue;
+        const double ratio = std::max(energyA, 1e-30) / std::max(energyB, 1e-30);
+        error = std::max(error, (float)fabs(10.0 * log10(ratio)));
+    }
+    return error;
+}
+
+static float peakError(const std::vector<float>& a, const std::vector<float>& b) {
+    float peak = 0.0f;
+    for (size_t i = 0; i < a.size(); i++) {
+        peak = std::max(peak, fabsf(a[i] - b[i]));
+    }
+    return peak;
+}
+
+static bool writeWav(const std::string& path, const std::vector<float>& samples) {
+    WavWriter wav;
+    if (!wav.open(path.c_str(), 16, SAMPLE_RATE)) {
+        fprintf(stderr, "%s: cannot create\n", path.c_str());
+        return false;
+    }
+    wav.write(samples.data(), samples.size());
+    return wav.close();
+}
+
+static void usage() {
+    fprintf(stderr, "usage: golden_audio_check [-r dir] [-s] [-l dB] [-d dB] [-p peak] [-w dir] [-u]\n");
+}
+
+int main(int argc, char** argv) {
+    const char* referenceDir = "Host/Golden";
+    const char* writeDir = nullptr;
+    float levelTolerance = LEVEL_TOLERANCE_DB;
+    float peakTolerance = 0.0f;  // 0 - не проверяется
+    float spectralTolerance = SPECTRAL_TOLERANCE_DB;
+    bool scalar = false;
+    bool update = false;
+    
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "-r") == 0 && hasValue) {
+            referenceDir = argv[++i];
+        } else if (strcmp(argv[i], "-w") == 0 && hasValue) {
+            writeDir = argv[++i];
+        } else if (strcmp(argv[i], "-l") == 0 && hasValue) {
+            levelTolerance = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "-d") == 0 && hasValue) {
+            spectralTolerance = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "-p") == 0 && hasValue) {
+            peakTolerance = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0) {
+            scalar = true;
+        } else if (strcmp(argv[i], "-u") == 0) {
+            update = true;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    
+    printf("engine: %s, block %d, wave bank %d, SoA %s, kernel %s\n",
+           SYNTH_FIXED_POINT ? "Q15" : "float", AUDIO_BLOCK_SIZE, WAVE_BANK_ENABLED,
+           (VOICE_SOA_ENABLED && !scalar) ? "on" : "off", VoiceKernels::name());
+    if (peakTolerance > 0.0f) {
+        printf("tolerance: level %.2f dB, spectral %.2f dB, peak %.4f\n", levelTolerance, spectralTolerance,
+               peakTolerance);
+    } else {
+        printf("tolerance: level %.2f dB, spectral %.2f dB\n", levelTolerance, spectralTolerance);
+    }
+    
+    bool ok = true;
+    for (const ScenarioInfo& info : SCENARIOS) {
+        std::vector<float> rendered;
+        renderScenario(info, scalar, rendered);
+        const std::string reference = std::string(referenceDir) + "/" + info.name + ".wav";
+        
+        if (writeDir && !writeWav(std::string(writeDir) + "/" + info.name + ".wav", rendered)) return 1;
+        if (update) {
+            if (!writeWav(reference, rendered)) return 1;
+            printf("%-16s %zu frames -> %s\n", info.name, rendered.size(), reference.c_str());
+            continue;
+        }
+        
+        std::vector<float> golden;
+        uint32_t rate = 0;
+        if (!loadWav(reference.c_str(), golden, rate)) {
+            ok = false;
+            continue;
+        }
+        if (rate != SAMPLE_RATE || golden.size() != rendered.size()) {
+            printf("%-16s FAIL: %zu frames at %lu Hz, reference %zu at %lu Hz\n", info.name, rendered.size(),
+                   (unsigned long)SAMPLE_RATE, golden.size(), (unsigned long)rate);
+            ok = false;
+            continue;
+        }
+        
+        const float level = levelError(golden, rendered);
+        const float spectral = spectralDistance(golden, rendered);
+        const float peak = peakError(golden, rendered);
+        const bool pass = level <= levelTolerance && spectral <= spectralTolerance &&
+                          (peakTolerance <= 0.0f || peak <= peakTolerance);
+        printf("%-16s level %6.3f dB  spectral %6.3f dB  peak %.5f  %s\n", info.name, level, spectral, peak,
+               pass ? "ok" : "FAIL");
+        ok = ok && pass;
+    }
+    
+    if (!update) printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
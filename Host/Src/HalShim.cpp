@@ -0,0 +1,90 @@
+#include "stm32f4xx_hal.h"
+#include <chrono>
+
+// Регистры таймеров в хост-сборке - обычная память
+TIM_TypeDef hostTim1;
+TIM_TypeDef hostTim6;
+TIM_HandleTypeDef htim1 = { &hostTim1 };
+TIM_HandleTypeDef htim6 = { &hostTim6 };
+
+// DMA2 Stream5 (TIM1_UP)
+static DMA_Stream_TypeDef hostDma2Stream5;
+DMA_HandleTypeDef hdma_tim1_up = { &hostDma2Stream5, nullptr, nullptr, 0 };
+
+// Модель одного потока DMA: источник в памяти и регистр назначения
+static const uint16_t* hostDmaSource = nullptr;
+static volatile uint32_t* hostDmaTarget = nullptr;
+
+// Тактирование как на плате: HSI 16 МГц без PLL, APB1 - /2, APB2 - /1
+#define HOST_PCLK1_FREQ 8000000U
+#define HOST_PCLK2_FREQ 16000000U
+
+// Виртуальные часы (hostSetTick): время задает вызывающий, не ОС
+static bool hostVirtualClock = false;
+static uint32_t hostVirtualTick = 0;
+
+extern "C" void hostSetTick(uint32_t tick) {
+    hostVirtualClock = true;
+    hostVirtualTick = tick;
+}
+
+extern "C" uint32_t HAL_GetTick(void) {
+    if (hostVirtualClock) return hostVirtualTick;
+    static const auto start = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+}
+
+extern "C" HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef* htim, uint32_t Channel) {
+    (void)Channel;
+    htim->Instance->CR1 |= 1U;
+    return HAL_OK;
+}
+
+extern "C" HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef* htim, uint32_t Channel) {
+    (void)Channel;
+    htim->Instance->CR1 &= ~1U;
+    return HAL_OK;
+}
+
+extern "C" uint32_t HAL_RCC_GetPCLK1Freq(void) {
+    return HOST_PCLK1_FREQ;
+}
+
+extern "C" uint32_t HAL_RCC_GetPCLK2Freq(void) {
+    return HOST_PCLK2_FREQ;
+}
+
+extern "C" HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef* hdma, uintptr_t SrcAddress,
+                                             uintptr_t DstAddress, uint32_t DataLength) {
+    // Адреса в 32-битных регистрах модели не помещаются - храним указатели отдельно
+    hdma->Instance->M0AR = 0;
+    hdma->Instance->PAR = 0;
+    hdma->Instance->NDTR = DataLength;
+    hdma->Instance->CR = 1U;
+    hdma->length = DataLength;
+    hostDmaSource = (const uint16_t*)(uintptr_t)SrcAddress;
+    hostDmaTarget = (volatile uint32_t*)(uintptr_t)DstAddress;
+    return HAL_OK;
+}
+
+extern "C" HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef* hdma) {
+    hdma->Instance->CR = 0;
+    return HAL_OK;
+}
+
+extern "C" void hostDmaStep(DMA_HandleTypeDef* hdma) {
+    if (!(hdma->Instance->CR & 1U) || hdma->length == 0) return;
+    
+    uint32_t index = hdma->length - hdma->Instance->NDTR;
+    *hostDmaTarget = hostDmaSource[index];
+    hdma->Instance->NDTR--;
+    
+    // Кольцевой режим: HT после первой половины, TC и перезагрузка NDTR в конце
+    if (hdma->Instance->NDTR == hdma->length / 2 && hdma->XferHalfCpltCallback) {
+        hdma->XferHalfCpltCallback(hdma);
+    } else if (hdma->Instance->NDTR == 0) {
+        hdma->Instance->NDTR = hdma->length;
+        if (hdma->XferCpltCallback) hdma->XferCpltCallback(hdma);
+    }
+}
@@ -0,0 +1,103 @@
+/*
+ * Проверка PolyphaseInterpolator на ПК: усиление в полосе пропускания,
+ * подавление образа на fs - f (частота входа fs) и стоимость на семпл,
+ * для сравнения - повтор семпла (интерполяция нулевого порядка).
+ *
+ * Сборка из корня репозитория:
+ *
+ *   g++ -std=gnu++14 -O2 -ICore/Inc \
+ *       Host/Src/InterpolatorCheck.cpp Core/Src/synthesizer/PolyphaseInterpolator.cpp \
+ *       -o interpolator_check
+ *
+ * Код возврата 0 - все проверки прошли.
+ */
+
+#include "synthesizer/PolyphaseInterpolator.hpp"
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include <chrono>
+
+static constexpr double MODULATOR_RATE_HZ = 44100.0;
+static constexpr uint32_t INPUT_FRAMES = 8192;
+static constexpr double AMPLITUDE = 0.5;
+// Полоса, в которой проверяются пульсации и подавление образа (доля fs)
+static constexpr double PASSBAND = 0.25;
+static constexpr double MAX_RIPPLE_DB = 0.5;
+static constexpr double MIN_IMAGE_REJECTION_DB = 50.0;
+
+// Амплитуда составляющей freq (цикл/семпл, целое число периодов на отрезке)
+static double toneAmplitude(const std::vector<int16_t>& signal, size_t start, size_t count, double freq) {
+    double re = 0.0, im = 0.0;
+    for (size_t n = 0; n < count; n++) {
+        double phase = 2.0 * M_PI * freq * (start + n);
+        re += signal[start + n] * cos(phase);
+        im -= signal[start + n] * sin(phase);
+    }
+    return 2.0 * sqrt(re * re + im * im) / count / 32768.0;
+}
+
+int main() {
+    bool passed = true;
+    
+    for (uint8_t ratio = 2; ratio <= PolyphaseInterpolator::MAX_RATIO; ratio++) {
+        const double inputRate = MODULATOR_RATE_HZ / ratio;
+        PolyphaseInterpolator interpolator;
+        interpolator.configure(ratio);
+        printf("ratio %u: %.0f -> %.0f Hz, %u taps/phase, delay %u\n", ratio, inputRate, MODULATOR_RATE_HZ,
+               PolyphaseInterpolator::TAPS, interpolator.getDelay());
+        printf("  %8s %10s %12s %12s\n", "f, Hz", "gain, dB", "image, dB", "hold image");
+        
+        double maxRipple = 0.0, worstImage = -200.0;
+        for (double fraction = 0.02; fraction <= 0.45; fraction += 0.0625) {
+            // Целое число периодов на INPUT_FRAMES
+            const double cycles = round(fraction * INPUT_FRAMES);
+            const double freq = cycles / INPUT_FRAMES;
+            
+            std::vector<int16_t> input(INPUT_FRAMES);
+            for (uint32_t n = 0; n < INPUT_FRAMES; n++) {
+                input[n] = (int16_t)lrint(32767.0 * AMPLITUDE * sin(2.0 * M_PI * freq * n));
+            }
+            std::vector<int16_t> output(INPUT_FRAMES * ratio), hold(INPUT_FRAMES * ratio);
+            interpolator.reset();
+            interpolator.process(input.data(), INPUT_FRAMES, output.data());
+            for (size_t n = 0; n < hold.size(); n++) {
+                hold[n] = input[n / ratio];
+            }
+            
+            // Отрезок после переходного процесса, целое число периодов тона и образа
+            const size_t start = PolyphaseInterpolator::TAPS * ratio;
+            const size_t count = output.size() - (size_t)ratio * INPUT_FRAMES / 2;
+            const size_t span = count - count % ((size_t)ratio * INPUT_FRAMES / 2);
+            const size_t length = span ? span : count;
+            
+            double gain = toneAmplitude(output, start, length, freq / ratio) / AMPLITUDE;
+            double image = toneAmplitude(output, start, length, (1.0 - freq) / ratio) / AMPLITUDE;
+            double holdImage = toneAmplitude(hold, start, length, (1.0 - freq) / ratio) / AMPLITUDE;
+            double gainDb = 20.0 * log10(gain);
+            double imageDb = 20.0 * log10(image + 1e-12);
+            printf("  %8.0f %10.2f %12.1f %12.1f\n", freq * inputRate, gainDb, imageDb, 20.0 * log10(holdImage + 1e-12));
+            
+            if (freq <= PASSBAND) {
+                if (fabs(gainDb) > maxRipple) maxRipple = fabs(gainDb);
+                if (imageDb > worstImage) worstImage = imageDb;
+            }
+        }
+        
+        // Стоимость: ns на выходной семпл
+        std::vector<int16_t> input(INPUT_FRAMES, 1000), output(INPUT_FRAMES * ratio);
+        auto begin = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < 100; pass++) {
+            interpolator.process(input.data(), INPUT_FRAMES, output.data());
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+        
+        bool ok = (maxRipple <= MAX_RIPPLE_DB) && (worstImage <= -MIN_IMAGE_REJECTION_DB);
+        printf("  up to %.2f fs: ripple %.2f dB, image %.1f dB, %.2f ns/output sample %s\n", PASSBAND, maxRipple,
+               worstImage, ns / (100.0 * output.size()), ok ? "OK" : "FAIL");
+        passed &= ok;
+    }
+    
+    printf("%s\n", passed ? "PASSED" : "FAILED");
+    return passed ? 0 : 1;
+}
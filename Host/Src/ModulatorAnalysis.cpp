@@ -0,0 +1,181 @@
+/*
+ * Анализ модуляторов на ПК: SigmaDeltaModulator (обратная связь по ошибке)
+ * и PatternModulator (таблица шаблонов). Тестовый тон 1 кГц проходит
+ * через модулятор, последовательность скважностей (на частоте ШИМ)
+ * раскладывается БПФ, в звуковой полосе 20 Гц - 20 кГц считаются SNR и THD.
+ * Такты на семпл - как на плате: 16 МГц / 44100 Гц = 363 = ARR+1 * передискретизация.
+ *
+ * Сборка из корня репозитория:
+ *
+ *   g++ -std=gnu++14 -O2 -IHost/Inc -ICore/Inc \
+ *       Host/Src/ModulatorAnalysis.cpp Core/Src/synthesizer/SigmaDeltaModulator.cpp \
+ *       Core/Src/synthesizer/PatternModulator.cpp \
+ *       -o modulator_analysis
+ *
+ * ns/семпл - время modulate() на ПК на один входной семпл (все такты ШИМ),
+ * лучшее из TIMING_RUNS прогонов.
+ */
+
+#include "synthesizer/SigmaDeltaModulator.hpp"
+#include "synthesizer/PatternModulator.hpp"
+#include <stdio.h>
+#include <math.h>
+#include <complex>
+#include <vector>
+#include <chrono>
+
+static constexpr uint32_t TIMER_CLOCK = 16000000;
+static constexpr uint32_t TICKS_PER_SAMPLE = 363;
+static constexpr uint32_t FFT_SIZE = 1 << 18;
+static constexpr double TONE_HZ = 1000.0;
+static constexpr double TONE_AMPLITUDE = 0.5;  // -6 дБFS
+static constexpr double BAND_LOW_HZ = 20.0;
+static constexpr double BAND_HIGH_HZ = 20000.0;
+static constexpr uint32_t HARMONICS = 5;
+static constexpr int32_t PEAK_BINS = 4;  // Ширина лепестка окна Блэкмана-Харриса
+static constexpr uint32_t TIMING_RUNS = 5;
+
+struct Carrier {
+    uint8_t oversampling;
+    uint16_t arr;
+};
+
+// Несущие с тем же тактом на семпл, что и на плате
+static const Carrier CARRIERS[] = { { 33, 10 }, { 11, 32 }, { 3, 120 } };
+static const uint8_t ORDERS[] = { 1, 2, 3 };
+static const uint16_t LEVELS[] = { 2, 9, SigmaDeltaModulator::ALL_LEVELS };
+
+static void fft(std::vector<std::complex<double>>& data) {
+    const size_t n = data.size();
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) std::swap(data[i], data[j]);
+    }
+    for (size_t len = 2; len <= n; len <<= 1) {
+        std::complex<double> w(cos(-2.0 * M_PI / len), sin(-2.0 * M_PI / len));
+        for (size_t i = 0; i < n; i += len) {
+            std::complex<double> wk(1.0, 0.0);
+            for (size_t k = 0; k < len / 2; k++) {
+                std::complex<double> a = data[i + k];
+                std::complex<double> b = data[i + k + len / 2] * wk;
+                data[i + k] = a + b;
+                data[i + k + len / 2] = a - b;
+                wk *= w;
+            }
+        }
+    }
+}
+
+// Мощность в бинах [center - PEAK_BINS, center + PEAK_BINS]
+static double peakPower(const std::vector<double>& power, int32_t center) {
+    double sum = 0.0;
+    for (int32_t b = center - PEAK_BINS; b <= center + PEAK_BINS; b++) {
+        if (b > 0 && b < (int32_t)power.size()) sum += power[b];
+    }
+    return sum;
+}
+
+struct Result {
+    double snr;
+    double thd;
+    double nsPerSample;
+};
+
+// Модуляция input, спектр скважности и SNR/THD в звуковой полосе
+template<typename Modulator>
+static Result analyze(Modulator& modulator, const Carrier& carrier, const std::vector<int16_t>& input,
+                      double toneHz, double binHz) {
+    const size_t samples = input.size();
+    std::vector<uint16_t> output(samples * carrier.oversampling);
+    
+    double best = 1e30;
+    for (uint32_t run = 0; run < TIMING_RUNS; run++) {
+        modulator.reset();
+        auto start = std::chrono::steady_clock::now();
+        modulator.modulate(input.data(), samples, output.data());
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        double ns = std::chrono::duration<double, std::nano>(elapsed).count() / samples;
+        if (ns < best) best = ns;
+    }
+    
+    // Скважность [0, 1] -> [-1, 1], окно Блэкмана-Харриса
+    std::vector<std::complex<double>> spectrum(FFT_SIZE);
+    const double full = carrier.arr + 1.0;
+    for (uint32_t i = 0; i < FFT_SIZE; i++) {
+        double t = 2.0 * M_PI * i / FFT_SIZE;
+        double window = 0.35875 - 0.48829 * cos(t) + 0.14128 * cos(2 * t) - 0.01168 * cos(3 * t);
+        spectrum[i] = (2.0 * output[i] / full - 1.0) * window;
+    }
+    fft(spectrum);
+    
+    std::vector<double> power(FFT_SIZE / 2);
+    for (uint32_t b = 0; b < FFT_SIZE / 2; b++) {
+        power[b] = std::norm(spectrum[b]);
+    }
+    
+    const int32_t toneBin = (int32_t)lrint(toneHz / binHz);
+    double signal = peakPower(power, toneBin);
+    double harmonics = 0.0;
+    std::vector<bool> excluded(FFT_SIZE / 2, false);
+    for (uint32_t h = 1; h <= HARMONICS; h++) {
+        int32_t bin = toneBin * h;
+        if (h > 1 && bin * binHz < BAND_HIGH_HZ) harmonics += peakPower(power, bin);
+        for (int32_t b = bin - PEAK_BINS; b <= bin + PEAK_BINS; b++) {
+            if (b > 0 && b < (int32_t)excluded.size()) excluded[b] = true;
+        }
+    }
+    
+    double noise = 0.0;
+    const int32_t low = (int32_t)ceil(BAND_LOW_HZ / binHz);
+    const int32_t high = (int32_t)floor(BAND_HIGH_HZ / binHz);
+    for (int32_t b = low; b <= high; b++) {
+        if (!excluded[b]) noise += power[b];
+    }
+    
+    Result result;
+    result.snr = 10.0 * log10(signal / noise);
+    result.thd = 10.0 * log10(harmonics / signal + 1e-30);
+    result.nsPerSample = best;
+    return result;
+}
+
+int main() {
+    const double sampleRate = (double)TIMER_CLOCK / TICKS_PER_SAMPLE;
+    printf("timer %u Hz, sample rate %.0f Hz, tone %.0f Hz at %.1f dBFS, band %.0f-%.0f Hz\n",
+           TIMER_CLOCK, sampleRate, TONE_HZ, 20.0 * log10(TONE_AMPLITUDE), BAND_LOW_HZ, BAND_HIGH_HZ);
+    printf("%9s %5s %8s %6s %9s %9s %10s\n", "PWM kHz", "ARR", "type", "levels", "SNR dB", "THD dB", "ns/sample");
+    
+    for (const Carrier& carrier : CARRIERS) {
+        const double pwmRate = sampleRate * carrier.oversampling;
+        const uint32_t samples = FFT_SIZE / carrier.oversampling + 1;
+        
+        // Тон на целом числе бинов БПФ - без растекания по основной частоте
+        const double binHz = pwmRate / FFT_SIZE;
+        const double toneHz = round(TONE_HZ / binHz) * binHz;
+        std::vector<int16_t> input(samples);
+        for (uint32_t i = 0; i < samples; i++) {
+            input[i] = (int16_t)lrint(32767.0 * TONE_AMPLITUDE * sin(2.0 * M_PI * toneHz * i / sampleRate));
+        }
+        
+        for (uint8_t order : ORDERS) {
+            for (uint16_t levels : LEVELS) {
+                SigmaDeltaModulator modulator;
+                modulator.configure(carrier.arr, carrier.oversampling, order, levels);
+                Result r = analyze(modulator, carrier, input, toneHz, binHz);
+                char type[16];
+                snprintf(type, sizeof(type), "order %u", order);
+                printf("%9.1f %5u %8s %6u %9.1f %9.1f %10.1f\n", pwmRate / 1000.0, carrier.arr, type,
+                       modulator.getLevels(), r.snr, r.thd, r.nsPerSample);
+            }
+        }
+        
+        static PatternModulator pattern;
+        pattern.configure(carrier.arr, carrier.oversampling);
+        Result r = analyze(pattern, carrier, input, toneHz, binHz);
+        printf("%9.1f %5u %8s %6u %9.1f %9.1f %10.1f\n", pwmRate / 1000.0, carrier.arr, "pattern",
+               pattern.getLevels(), r.snr, r.thd, r.nsPerSample);
+    }
+    return 0;
+}
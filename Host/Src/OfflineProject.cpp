@@ -0,0 +1,233 @@
+#include "OfflineProject.hpp"
+#include "Sequencer.hpp"
+#include "stm32f4xx_hal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+// Ноты секвенсора -> партия: время - виртуальные часы HAL_GetTick
+static OfflinePart* capture = nullptr;
+
+static void record(OfflineNote::Kind kind, uint8_t channel, uint8_t note, uint8_t velocity) {
+    if (!capture) return;
+    OfflineNote entry;
+    entry.time = HAL_GetTick();
+    entry.kind = kind;
+    entry.channel = channel;
+    entry.note = note;
+    entry.velocity = velocity;
+    entry.wave = OfflineNote::NO_WAVE;
+    capture->push_back(entry);
+}
+
+static void captureNoteOn(uint8_t channel, uint8_t note, uint8_t velocity) {
+    record(OfflineNote::NOTE_ON, channel, note, velocity);
+}
+
+static void captureNoteOff(uint8_t channel, uint8_t note) {
+    record(OfflineNote::NOTE_OFF, channel, note, 0);
+}
+
+static void capturePlayDrum(DrumPreset preset, uint8_t velocity) {
+    record(OfflineNote::DRUM, 0, (uint8_t)preset, velocity);
+}
+
+static void captureAllNotesOff() {
+    record(OfflineNote::ALL_NOTES_OFF, 0, 0, 0);
+}
+
+// Игра проекта секвенсора durationMs мс: update() на каждом тике, как задача
+// на плате, только часы двигает цикл
+static void runSequencer(uint32_t durationMs, OfflinePart& part) {
+    Sequencer& sequencer = Sequencer::getInstance();
+    const SequencerOutput output = { captureNoteOn, captureNoteOff, capturePlayDrum, captureAllNotesOff };
+    sequencer.setOutput(output);
+    capture = &part;
+    
+    hostSetTick(0);
+    sequencer.play();
+    for (uint32_t tick = 0; tick < durationMs; tick++) {
+        hostSetTick(tick);
+        sequencer.update();
+    }
+    hostSetTick(durationMs);
+    sequencer.stop();
+    capture = nullptr;
+}
+
+// "x..x|.x.." -> блоки барабанной дорожки
+static bool parseDrumTrack(Track& track, uint8_t preset, const char* pattern) {
+    track.type = TrackType::DRUM;
+    track.drumType = (DrumPreset)preset;
+    track.blocks.clear();
+    
+    uint32_t beats = 0;
+    for (const char* c = pattern; *c; c++) {
+        if (*c == 'x' || *c == 'X' || *c == '.') {
+            if (beats % 4 == 0) track.addBlock();
+            track.blocks.back().beats[beats % 4].active = (*c != '.');
+            beats++;
+        } else if (*c != '|' && *c != ' ' && *c != '\t' && *c != '\n' && *c != '\r') {
+            return false;
+        }
+    }
+    return beats > 0 && track.blocks.size() <= Sequencer::MAX_BLOCKS_PER_TRACK;
+}
+
+// "C E G# - | A - C -" -> блоки фортепианной дорожки
+static bool parsePianoTrack(Track& track, const char* pattern) {
+    static const char NAMES[] = "C D EF G A B";  // Индекс буквы - номер ноты
+    track.type = TrackType::PIANO;
+    track.blocks.clear();
+    
+    uint32_t beats = 0;
+    char token[8];
+    int used = 0;
+    while (sscanf(pattern, "%7s%n", token, &used) == 1) {
+        pattern += used;
+        if (strcmp(token, "|") == 0) continue;
+        
+        Beat beat;
+        if (strcmp(token, "-") != 0) {
+            const char* letter = strchr(NAMES, token[0]);
+            if (!letter || *letter == ' ' || (token[1] && strcmp(token + 1, "#") != 0)) return false;
+            beat = Beat(false, (uint8_t)(letter - NAMES), token[1] == '#');
+        }
+        if (beats % 4 == 0) track.addBlock();
+        track.blocks.back().beats[beats % 4] = beat;
+        beats++;
+    }
+    return beats > 0 && track.blocks.size() <= Sequencer::MAX_BLOCKS_PER_TRACK;
+}
+
+// Одна строка проекта. false - ошибка
+static bool parseProjectLine(Sequencer& sequencer, const char* line) {
+    char command[16];
+    int used = 0;
+    if (sscanf(line, "%15s%n", command, &used) != 1) return true;  // Пустая строка
+    const char* args = line + used;
+    
+    unsigned track = 0, value = 0;
+    if (strcmp(command, "bpm") == 0 && sscanf(args, "%u", &value) == 1) {
+        sequencer.setBPM((uint16_t)value);
+        return true;
+    }
+    if (strcmp(command, "volume") == 0 && sscanf(args, "%u", &value) == 1) {
+        sequencer.setVolume((uint8_t)value);
+        return true;
+    }
+    if (strcmp(command, "drum") == 0 && sscanf(args, "%u %u%n", &track, &value, &used) == 2) {
+        return track < Sequencer::MAX_TRACKS && value < 8 &&
+               parseDrumTrack(sequencer.getTrack((uint8_t)track), (uint8_t)value, args + used);
+    }
+    if (strcmp(command, "piano") == 0 && sscanf(args, "%u%n", &track, &used) == 1) {
+        return track < Sequencer::MAX_TRACKS && parsePianoTrack(sequencer.getTrack((uint8_t)track), args + used);
+    }
+    return false;
+}
+
+bool loadProjectPart(const char* path, uint32_t durationMs, OfflinePart& part) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+    
+    Sequencer& sequencer = Sequencer::getInstance();
+    sequencer.init();
+    
+    char line[512];
+    uint32_t lineNumber = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        // Комментарий - целая строка: '#' внутри строки - полутон (C#)
+        const char* text = line + strspn(line, " \t");
+        if (*text == '#') continue;
+        if (!parseProjectLine(sequencer, text)) {
+            fprintf(stderr, "%s:%u: cannot parse\n", path, lineNumber);
+            ok = false;
+        }
+    }
+    fclose(file);
+    
+    if (ok) runSequencer(durationMs, part);
+    return ok;
+}
+
+void demoProjectPart(uint32_t durationMs, OfflinePart& part) {
+    static const char* const DEMO[] = {
+        "bpm 120",
+        "volume 8",
+        "drum 0 0 x...|x..x",
+        "drum 1 1 ..x.|..x.",
+        "drum 2 2 x.x.|x.xx",
+        "piano 4 C E G E | A C E C",
+        "piano 5 - G - G | - E - E",
+    };
+    
+    Sequencer& sequencer = Sequencer::getInstance();
+    sequencer.init();
+    for (const char* line : DEMO) {
+        parseProjectLine(sequencer, line);
+    }
+    runSequencer(durationMs, part);
+}
+
+uint8_t parseWaveName(const char* name) {
+    static const char* const NAMES[] = { "sine", "square", "saw", "triangle", "noise" };
+    for (uint8_t i = 0; i < sizeof(NAMES) / sizeof(NAMES[0]); i++) {
+        if (strcmp(name, NAMES[i]) == 0) return i;
+    }
+    return OfflineNote::NO_WAVE;
+}
+
+bool loadScriptPart(const char* path, OfflinePart& part, uint32_t& endMs) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+    
+    char line[256];
+    uint32_t lineNumber = 0;
+    bool ok = true;
+    endMs = 0;
+    while (ok && fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        char* comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+        
+        unsigned start, length, channel, note, velocity;
+        char wave[16] = "";
+        int fields = sscanf(line, "%u %u %u %u %u %15s", &start, &length, &channel, &note, &velocity, wave);
+        if (fields <= 0) continue;
+        if (fields < 5 || channel > 15 || note > 127 || velocity > 127 ||
+            (fields == 6 && parseWaveName(wave) == OfflineNote::NO_WAVE)) {
+            fprintf(stderr, "%s:%u: cannot parse\n", path, lineNumber);
+            ok = false;
+            break;
+        }
+        
+        OfflineNote entry;
+        entry.time = start;
+        entry.kind = OfflineNote::NOTE_ON;
+        entry.channel = (uint8_t)channel;
+        entry.note = (uint8_t)note;
+        entry.velocity = (uint8_t)velocity;
+        entry.wave = (fields == 6) ? parseWaveName(wave) : OfflineNote::NO_WAVE;
+        part.push_back(entry);
+        
+        entry.time = start + length;
+        entry.kind = OfflineNote::NOTE_OFF;
+        part.push_back(entry);
+        if (start + length > endMs) endMs = start + length;
+    }
+    fclose(file);
+    
+    // Строки скрипта - в любом порядке, партия - по времени
+    std::stable_sort(part.begin(), part.end(),
+                     [](const OfflineNote& a, const OfflineNote& b) { return a.time < b.time; });
+    return ok;
+}
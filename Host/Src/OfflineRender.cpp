@@ -0,0 +1,119 @@
+/*
+ * Офлайн-рендер на ПК: проект секвенсора или скрипт нот -> WAV (16/24 бит,
+ * моно, SAMPLE_RATE) быстрее реального времени. Sequencer играет на
+ * виртуальных часах (hostSetTick), ноты применяются к WaveSynthesizer ровно
+ * на своих кадрах (PartRenderer), звук пишется в файл кусками.
+ * В конце - длительность, время рендеринга и кратность реальному времени;
+ * с -n (без записи) это бенчмарк производительности синтезатора.
+ * Много проектов и вариантов сразу - Host/Src/BatchRender.cpp.
+ *
+ * Сборка из корня репозитория:
+ *
+ *   g++ -std=gnu++14 -O2 -IHost/Inc -ICore/Inc \
+ *       Host/Src/OfflineRender.cpp Host/Src/OfflineProject.cpp \
+ *       Host/Src/PartRenderer.cpp Host/Src/WavWriter.cpp \
+ *       Host/Src/HalShim.cpp Host/Src/UartShim.cpp \
+ *       Core/Src/Sequencer.cpp Core/Src/drivers/Synthesizer.cpp Core/Src/drivers/Buzzer.cpp \
+ *       Core/Src/synthesizer/OneBitMixer.cpp Core/Src/synthesizer/SynthesizerBridge.cpp \
+ *       Core/Src/synthesizer/WaveSynthesizer.cpp Core/Src/synthesizer/VoiceMixer.cpp \
+ *       Core/Src/synthesizer/WaveGenerator.cpp Core/Src/synthesizer/WaveBank.cpp \
+ *       Core/Src/synthesizer/NoteTable.cpp Core/Src/synthesizer/Envelope.cpp \
+ *       Core/Src/synthesizer/VoiceKernels.cpp -o offline_render
+ *
+ * SynthesizerBridge, Synthesizer и Buzzer нужны только как вывод секвенсора
+ * по умолчанию (движок SYNTH_ENGINE) - офлайн-рендер подменяет его
+ * (Sequencer::setOutput).
+ *
+ * Запуск:
+ *
+ *   ./offline_render [-p проект.txt | -s скрипт.txt] [-d секунды] [-b 16|24] [-o out.wav | -n]
+ *
+ * Без -p/-s - встроенный демо-проект. Форматы проекта и скрипта - в Host/Inc/OfflineProject.hpp.
+ * Код возврата 0 - рендер записан.
+ */
+
+#include "OfflineProject.hpp"
+#include "PartRenderer.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+static constexpr uint32_t TAIL_MS = 500;  // После последней ноты скрипта - релиз
+
+static void usage() {
+    fprintf(stderr, "usage: offline_render [-p project.txt | -s script.txt] [-d seconds] "
+                    "[-b 16|24] [-o out.wav | -n]\n");
+}
+
+int main(int argc, char** argv) {
+    const char* projectPath = nullptr;
+    const char* scriptPath = nullptr;
+    const char* outPath = "offline.wav";
+    uint32_t durationMs = 0;
+    uint8_t bits = 16;
+    bool write = true;
+    
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "-p") == 0 && hasValue) {
+            projectPath = argv[++i];
+        } else if (strcmp(argv[i], "-s") == 0 && hasValue) {
+            scriptPath = argv[++i];
+        } else if (strcmp(argv[i], "-d") == 0 && hasValue) {
+            durationMs = (uint32_t)(atof(argv[++i]) * 1000.0);
+        } else if (strcmp(argv[i], "-b") == 0 && hasValue) {
+            bits = (uint8_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0 && hasValue) {
+            outPath = argv[++i];
+        } else if (strcmp(argv[i], "-n") == 0) {
+            write = false;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (bits != 16 && bits != 24) {
+        usage();
+        return 2;
+    }
+    
+    // Партия: скрипт - до конца последней ноты и релиза, проект - 8 с
+    OfflinePart part;
+    if (scriptPath) {
+        uint32_t endMs = 0;
+        if (!loadScriptPart(scriptPath, part, endMs)) return 1;
+        if (durationMs == 0) durationMs = endMs + TAIL_MS;
+    } else {
+        if (durationMs == 0) durationMs = 8000;
+        if (projectPath) {
+            if (!loadProjectPart(projectPath, durationMs, part)) return 1;
+        } else {
+            demoProjectPart(durationMs, part);
+        }
+    }
+    
+    WaveSynthesizer& synth = WaveSynthesizer::getInstance();
+    synth.init();
+    WavWriter wav;
+    if (write && !wav.open(outPath, bits, SAMPLE_RATE)) {
+        fprintf(stderr, "%s: cannot create\n", outPath);
+        return 1;
+    }
+    
+    PartRenderer renderer(synth, write ? &wav : nullptr);
+    const auto start = std::chrono::steady_clock::now();
+    renderer.render(part, durationMs);
+    if (write && !wav.close()) {
+        fprintf(stderr, "%s: write error\n", outPath);
+        return 1;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    const double audioSeconds = (double)renderer.getFrames() / SAMPLE_RATE;
+    printf("%s: %zu events, %.2f s at %u Hz, %u-bit, peak %.3f\n",
+           write ? outPath : "(no output)", part.size(), audioSeconds, (unsigned)SAMPLE_RATE, bits,
+           renderer.getPeak());
+    printf("rendered in %.1f ms, realtime factor %.1fx\n", seconds * 1000.0, audioSeconds / seconds);
+    return 0;
+}
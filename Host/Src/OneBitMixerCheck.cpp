@@ -0,0 +1,147 @@
+/*
+ * Проверка 1-битного микшера OneBitMixer на ПК: битовый поток строится
+ * render() и через модель DMA (hostDmaStep), без платы.
+ *
+ * Сборка из корня репозитория:
+ *
+ *   g++ -std=gnu++14 -O2 -IHost/Inc -ICore/Inc \
+ *       Host/Src/OneBitMixerCheck.cpp Host/Src/HalShim.cpp Host/Src/UartShim.cpp \
+ *       Core/Src/synthesizer/OneBitMixer.cpp Core/Src/synthesizer/NoteTable.cpp \
+ *       -o one_bit_mixer_check
+ *
+ * Код возврата 0 - все проверки прошли.
+ */
+
+#include "synthesizer/OneBitMixer.hpp"
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+
+static constexpr uint32_t SECOND_FRAMES = OneBitMixer::DEFAULT_PWM_FREQ;
+static constexpr double MAX_ERROR_CENTS = 1.0;
+// Допуск отношения амплитуд основных тонов к отношению ширин импульсов
+static constexpr double MAX_LEVEL_ERROR = 0.02;
+static constexpr uint32_t DMA_BLOCKS = 8;
+static constexpr uint32_t BENCH_SECONDS = 20;
+
+// Аккорд C-E-G с разной громкостью
+static constexpr uint8_t CHORD[] = {60, 64, 67};
+static constexpr uint8_t CHORD_VOLUME[] = {10, 6, 3};
+static constexpr uint8_t CHORD_SIZE = sizeof(CHORD) / sizeof(CHORD[0]);
+
+static uint16_t stream[SECOND_FRAMES];
+
+// Амплитуда составляющей frequency (Гёрцель) в долях полной скважности
+static double toneLevel(const uint16_t* data, size_t frames, double frequency, double sampleRate, double top) {
+    double coeff = 2.0 * cos(2.0 * M_PI * frequency / sampleRate);
+    double s1 = 0.0, s2 = 0.0;
+    for (size_t i = 0; i < frames; i++) {
+        double s0 = data[i] / (top + 1) + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+    double power = s1 * s1 + s2 * s2 - coeff * s1 * s2;
+    return 2.0 * sqrt(power > 0 ? power : 0) / frames;
+}
+
+int main() {
+    bool passed = true;
+    OneBitMixer& mixer = OneBitMixer::getInstance();
+    mixer.init();
+    const double rate = mixer.getSampleRate();
+    printf("mixer: %u Hz, ARR %u, slot %u ticks, %u voices\n", (unsigned)mixer.getSampleRate(),
+           mixer.getTop(), mixer.getSlotTicks(), OneBitMixer::MAX_VOICES);
+
+    // 1. Высота: период по фронтам импульсов голоса за секунду
+    mixer.playMidiNote(0, 69, OneBitMixer::MAX_VOLUME);
+    mixer.render(stream, SECOND_FRAMES);
+    uint32_t first = 0, last = 0, edges = 0;
+    for (uint32_t i = 1; i < SECOND_FRAMES; i++) {
+        if (stream[i] && !stream[i - 1]) {
+            if (edges == 0) first = i;
+            last = i;
+            edges++;
+        }
+    }
+    double frequency = (edges > 1) ? (edges - 1) * rate / (last - first) : 0.0;
+    double cents = (frequency > 0) ? fabs(1200.0 * log2(frequency / 440.0)) : 1e9;
+    bool ok = (cents <= MAX_ERROR_CENTS);
+    printf("pitch A4: %.3f Hz (%.3f cents) %s\n", frequency, cents, ok ? "OK" : "FAIL");
+    passed &= ok;
+
+    // 2. Аккорд: голоса звучат одновременно, уровень каждого - по громкости
+    mixer.init();
+    for (uint8_t i = 0; i < CHORD_SIZE; i++) {
+        mixer.playMidiNote(i, CHORD[i], CHORD_VOLUME[i]);
+    }
+    mixer.render(stream, SECOND_FRAMES);
+    double reference = 0.0;
+    ok = true;
+    for (uint8_t i = 0; i < CHORD_SIZE; i++) {
+        double f = 440.0 * pow(2.0, (CHORD[i] - 69) / 12.0);
+        double level = toneLevel(stream, SECOND_FRAMES, f, rate, mixer.getTop());
+        double width = (double)mixer.getSlotTicks() * CHORD_VOLUME[i] / OneBitMixer::MAX_VOLUME;
+        width = floor(width);
+        if (i == 0) reference = level / width;
+        double error = fabs(level / width / reference - 1.0);
+        bool voiceOk = (level > 0) && (error <= MAX_LEVEL_ERROR);
+        printf("chord note %u vol %u: level %.4f, error %.2f%% %s\n", CHORD[i], CHORD_VOLUME[i], level,
+               100.0 * error, voiceOk ? "OK" : "FAIL");
+        ok &= voiceOk;
+    }
+    passed &= ok;
+
+    // 3. Все голоса на полной громкости - не больше полного периода
+    for (uint8_t i = 0; i < OneBitMixer::MAX_VOICES; i++) {
+        mixer.playMidiNote(i, (uint8_t)(48 + 5 * i), OneBitMixer::MAX_VOLUME);
+    }
+    mixer.render(stream, SECOND_FRAMES);
+    uint16_t peak = 0;
+    for (uint32_t i = 0; i < SECOND_FRAMES; i++) {
+        if (stream[i] > peak) peak = stream[i];
+    }
+    ok = (peak <= mixer.getTop() + 1u);
+    printf("full mix: peak CCR1 %u of %u %s\n", peak, mixer.getTop() + 1u, ok ? "OK" : "FAIL");
+    passed &= ok;
+
+    // 4. Через DMA - тот же поток, что и render(), без недогрузок
+    mixer.init();
+    for (uint8_t i = 0; i < CHORD_SIZE; i++) {
+        mixer.playMidiNote(i, CHORD[i], CHORD_VOLUME[i]);
+    }
+    mixer.start();
+    const uint32_t dmaFrames = DMA_BLOCKS * OneBitMixer::BLOCK_FRAMES;
+    static uint16_t dmaStream[DMA_BLOCKS * OneBitMixer::BLOCK_FRAMES];
+    for (uint32_t i = 0; i < dmaFrames; i++) {
+        hostDmaStep(&hdma_tim1_up);
+        dmaStream[i] = (uint16_t)TIM1->CCR1;
+    }
+    uint32_t underruns = mixer.getUnderruns();
+    mixer.stop();
+    mixer.init();
+    for (uint8_t i = 0; i < CHORD_SIZE; i++) {
+        mixer.playMidiNote(i, CHORD[i], CHORD_VOLUME[i]);
+    }
+    mixer.render(stream, dmaFrames);
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < dmaFrames; i++) {
+        if (stream[i] != dmaStream[i]) mismatches++;
+    }
+    ok = (mismatches == 0) && (underruns == 0);
+    printf("dma stream: %u frames, %u mismatches, %u underruns %s\n", (unsigned)dmaFrames, (unsigned)mismatches,
+           (unsigned)underruns, ok ? "OK" : "FAIL");
+    passed &= ok;
+
+    // 5. Стоимость: все голоса, наносекунд на семпл (справочно)
+    for (uint8_t i = 0; i < OneBitMixer::MAX_VOICES; i++) {
+        mixer.playMidiNote(i, (uint8_t)(48 + 5 * i), 7);
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t s = 0; s < BENCH_SECONDS; s++) {
+        mixer.render(stream, SECOND_FRAMES);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    printf("cost: %u voices, %.2f ns/sample\n", OneBitMixer::MAX_VOICES, ns / (BENCH_SECONDS * (double)SECOND_FRAMES));
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+#include "PartRenderer.hpp"
+#include <algorithm>
+
+// Барабаны секвенсора на WaveSynthesizer: у каждого пресета свой канал
+// (тип волны задается каналу), короткая огибающая без сустейна
+struct DrumVoice {
+    uint8_t note;
+    WaveType wave;
+    uint16_t decayMs;
+};
+
+static const DrumVoice DRUMS[] = {
+    { 36, WaveType::SINE, 150 },   // KICK
+    { 60, WaveType::NOISE, 90 },   // SNARE
+    { 96, WaveType::NOISE, 30 },   // HIHAT
+    { 84, WaveType::NOISE, 600 },  // CRASH
+    { 90, WaveType::NOISE, 300 },  // RIDE
+    { 50, WaveType::SINE, 200 },   // TOM_HIGH
+    { 45, WaveType::SINE, 220 },   // TOM_MID
+    { 40, WaveType::SINE, 250 },   // TOM_LOW
+};
+static constexpr uint8_t DRUM_CHANNEL = 8;  // Каналы 8-15
+
+PartRenderer::PartRenderer(WaveSynthesizer& synth, WavWriter* writer)
+    : synth(synth), writer(writer), capture(nullptr), frames(0), peak(0.0f) {}
+
+uint32_t PartRenderer::msToFrames(uint32_t ms) {
+    return (uint32_t)((uint64_t)ms * SAMPLE_RATE / 1000);
+}
+
+void PartRenderer::render(const OfflinePart& part, uint32_t durationMs, const PartVoicing& voicing) {
+    const uint32_t end = msToFrames(durationMs);
+    for (const OfflineNote& note : part) {
+        uint32_t frame = msToFrames(note.time);
+        if (frame >= end) break;
+        advanceTo(frame);
+        apply(note, voicing);
+    }
+    advanceTo(end);
+}
+
+void PartRenderer::advanceTo(uint32_t frame) {
+    // Отпускания барабанов до кадра - каждое на своем семпле
+    while (!pending.empty() && pending.front().frame <= frame) {
+        const PendingOff off = pending.front();
+        pending.erase(pending.begin());
+        if (off.frame > frames) renderFrames(off.frame - frames);
+        synth.noteOff(off.channel, off.note);
+    }
+    if (frame > frames) renderFrames(frame - frames);
+}
+
+void PartRenderer::renderFrames(uint32_t count) {
+    float chunk[CHUNK_FRAMES];
+    while (count > 0) {
+        uint32_t length = std::min(count, CHUNK_FRAMES);
+        synth.renderBlock(chunk, length);
+        for (uint32_t i = 0; i < length; i++) {
+            peak = std::max(peak, chunk[i] < 0.0f ? -chunk[i] : chunk[i]);
+        }
+        if (writer) writer->write(chunk, length);
+        if (capture) capture->insert(capture->end(), chunk, chunk + length);
+        frames += length;
+        count -= length;
+    }
+}
+
+void PartRenderer::apply(const OfflineNote& note, const PartVoicing& voicing) {
+    switch (note.kind) {
+        case OfflineNote::NOTE_ON: {
+            // Волна и огибающая задаются каналу после noteOn: настройки канала
+            // применяются к звучащим голосам
+            synth.noteOn(note.channel, note.note, note.velocity);
+            uint8_t wave = (voicing.wave != OfflineNote::NO_WAVE) ? voicing.wave : note.wave;
+            if (wave != OfflineNote::NO_WAVE) synth.setWaveType(note.channel, (WaveType)wave);
+            if (voicing.hasAdsr) synth.setADSR(note.channel, voicing.adsr);
+            break;
+        }
+        case OfflineNote::NOTE_OFF:
+            synth.noteOff(note.channel, note.note);
+            break;
+        case OfflineNote::ALL_NOTES_OFF:
+            synth.allNotesOff();
+            break;
+        case OfflineNote::DRUM: {
+            if (note.note >= sizeof(DRUMS) / sizeof(DRUMS[0])) break;
+            const DrumVoice& drum = DRUMS[note.note];
+            const uint8_t channel = DRUM_CHANNEL + note.note;
+            synth.noteOn(channel, drum.note, std::min<uint8_t>(note.velocity, WaveSynthesizer::MAX_VELOCITY));
+            synth.setWaveType(channel, drum.wave);
+            synth.setADSR(channel, ADSR(1, drum.decayMs, 0, drum.decayMs / 2));
+            
+            PendingOff off = { frames + msToFrames(drum.decayMs), channel, drum.note };
+            auto position = std::upper_bound(pending.begin(), pending.end(), off,
+                [](const PendingOff& a, const PendingOff& b) { return a.frame < b.frame; });
+            pending.insert(position, off);
+            break;
+        }
+    }
+}
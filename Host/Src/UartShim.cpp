@@ -0,0 +1,80 @@
+#include "drivers/Uart.hpp"
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+
+// Отладочный вывод в хост-сборке: в stderr, только при HOST_UART_VERBOSE=1
+// (иначе логи noteOn/noteOff искажают замеры)
+static bool verboseOutput() {
+    static const bool verbose = getenv("HOST_UART_VERBOSE") != nullptr;
+    return verbose;
+}
+
+Uart& Uart::getInstance() {
+    static Uart instance;
+    return instance;
+}
+
+bool Uart::init() {
+    return true;
+}
+
+bool Uart::send(uint8_t data) {
+    if (verboseOutput()) fputc(data, stderr);
+    return true;
+}
+
+bool Uart::send(const uint8_t* data, uint16_t size) {
+    if (verboseOutput()) fwrite(data, 1, size, stderr);
+    return true;
+}
+
+bool Uart::send(const char* str) {
+    if (verboseOutput()) fputs(str, stderr);
+    return true;
+}
+
+void Uart::printf(const char* format, ...) {
+    if (!verboseOutput()) return;
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+
+bool Uart::receive(uint8_t& data) {
+    (void)data;
+    return false;
+}
+
+bool Uart::receive(uint8_t* data, uint16_t& size) {
+    (void)data;
+    size = 0;
+    return false;
+}
+
+uint16_t Uart::available() const {
+    return 0;
+}
+
+void Uart::flush() {
+    fflush(stderr);
+}
+
+bool Uart::isTxBusy() const {
+    return false;
+}
+
+bool Uart::isRxDataAvailable() const {
+    return false;
+}
+
+void Uart::onReceiveISR() {}
+
+void Uart::processTxBuffer() {}
+
+void Uart::process() {}
+
+bool Uart::startTransmission() {
+    return true;
+}
@@ -0,0 +1,115 @@
+/*
+ * Бенчмарк рендеринга голосов на ПК: SoA пул + SIMD-ядра против
+ * рендеринга по одному голосу (VoiceMixer::renderVoice).
+ *
+ * Сборка из корня репозитория (SIMD-ядро выбирается флагами компилятора:
+ * -mavx2 - AVX2, по умолчанию на x86-64 - SSE2):
+ *
+ *   g++ -std=gnu++14 -O2 -mavx2 -IHost/Inc -ICore/Inc \
+ *       Host/Src/VoiceBenchmark.cpp Host/Src/HalShim.cpp Host/Src/UartShim.cpp \
+ *       Core/Src/synthesizer/WaveSynthesizer.cpp Core/Src/synthesizer/VoiceMixer.cpp \
+ *       Core/Src/synthesizer/WaveGenerator.cpp Core/Src/synthesizer/WaveBank.cpp \
+ *       Core/Src/synthesizer/NoteTable.cpp Core/Src/synthesizer/Envelope.cpp \
+ *       Core/Src/synthesizer/VoiceKernels.cpp -o voice_benchmark
+ *
+ * Результат - голосов в реальном времени на миллисекунду процессора:
+ * voices/ms = голоса * длительность звука (мс) / время рендеринга (мс).
+ * Пул здесь включен при любом числе голосов; по точке, где speedup
+ * устойчиво > 1, выставляется VoiceKernels::minVoices().
+ */
+
+#include "synthesizer/WaveSynthesizer.hpp"
+#include "synthesizer/VoicePool.hpp"
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+
+static constexpr uint32_t RENDER_SECONDS = 4;
+static constexpr size_t BUFFER_FRAMES = 256;
+static const uint8_t VOICE_COUNTS[] = { 1, 2, 4, 8, 12, 16, 24, 32 };
+
+static const WaveType BENCH_WAVES[] = {
+    WaveType::SINE, WaveType::SQUARE, WaveType::SAWTOOTH, WaveType::TRIANGLE
+};
+
+// Запуск N голосов с разными формами волны, огибающая сразу в сустейне
+static void startVoices(WaveSynthesizer& synth, uint8_t count) {
+    synth.init();
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t channel = i % WaveSynthesizer::MAX_CHANNELS;
+        synth.noteOn(channel, 36 + i * 2, 100);
+        synth.setADSR(channel, ADSR(0, 0, 10, 100));
+        synth.setWaveType(channel, BENCH_WAVES[i % 4]);
+    }
+}
+
+// Время рендеринга RENDER_SECONDS секунд звука, мс
+static double measure(WaveSynthesizer& synth, uint8_t count, float* checksum) {
+    static float buffer[BUFFER_FRAMES];
+    const uint32_t blocks = (RENDER_SECONDS * SAMPLE_RATE) / BUFFER_FRAMES;
+    
+    startVoices(synth, count);
+    double sum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t b = 0; b < blocks; b++) {
+        synth.renderBlock(buffer, BUFFER_FRAMES);
+        sum += buffer[b % BUFFER_FRAMES];
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    
+    *checksum = (float)sum;
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+// Максимальное расхождение двух режимов на одном и том же звуке
+static float compareModes(WaveSynthesizer& synth, VoiceMixer& mixer, uint8_t count) {
+    static float reference[SAMPLE_RATE / 10];
+    static float candidate[SAMPLE_RATE / 10];
+    const size_t frames = SAMPLE_RATE / 10;
+    
+    mixer.setSoaEnabled(false);
+    startVoices(synth, count);
+    synth.renderBlock(reference, frames);
+    
+    mixer.setSoaEnabled(true);
+    startVoices(synth, count);
+    synth.renderBlock(candidate, frames);
+    
+    float maxError = 0.0f;
+    for (size_t i = 0; i < frames; i++) {
+        float error = fabsf(reference[i] - candidate[i]);
+        if (error > maxError) maxError = error;
+    }
+    return maxError;
+}
+
+int main() {
+    WaveSynthesizer& synth = WaveSynthesizer::getInstance();
+    VoiceMixer& mixer = synth.getMixer();
+    const double audioMs = RENDER_SECONDS * 1000.0;
+    
+    // Сравниваем ядра напрямую, без порога переключения
+    mixer.setSoaMinVoices(1);
+    
+    printf("SoA kernel: %s, sample rate %d Hz, block %d, min voices %d\n", VoiceKernels::name(),
+           SAMPLE_RATE, AUDIO_BLOCK_SIZE, VoiceKernels::minVoices());
+    printf("%6s %14s %14s %9s %10s\n", "voices", "per-voice v/ms", "SoA v/ms", "speedup", "max diff");
+    
+    for (uint8_t count : VOICE_COUNTS) {
+        float checksum;
+        
+        mixer.setSoaEnabled(false);
+        double legacyMs = measure(synth, count, &checksum);
+        
+        mixer.setSoaEnabled(true);
+        double soaMs = measure(synth, count, &checksum);
+        
+        float maxError = compareModes(synth, mixer, count);
+        
+        double legacyRate = count * audioMs / legacyMs;
+        double soaRate = count * audioMs / soaMs;
+        printf("%6d %14.1f %14.1f %8.2fx %10.2e\n", count, legacyRate, soaRate, soaRate / legacyRate, maxError);
+    }
+    
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include "WavReader.hpp"
+#include <stdio.h>
+#include <string.h>
+
+static uint32_t get32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t get16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+bool loadWav(const char* path, std::vector<float>& samples, uint32_t& sampleRate) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+    
+    uint8_t header[12];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) ||
+        memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) {
+        fprintf(stderr, "%s: not a WAV file\n", path);
+        fclose(file);
+        return false;
+    }
+    
+    // Чанки: fmt до data, остальные пропускаются
+    uint16_t bits = 0;
+    bool ok = false;
+    uint8_t chunk[8];
+    while (fread(chunk, 1, sizeof(chunk), file) == sizeof(chunk)) {
+        const uint32_t size = get32(chunk + 4);
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            uint8_t format[16];
+            if (size < sizeof(format) || fread(format, 1, sizeof(format), file) != sizeof(format)) break;
+            bits = get16(format + 14);
+            sampleRate = get32(format + 4);
+            if (get16(format) != 1 || get16(format + 2) != 1 || (bits != 16 && bits != 24)) {
+                fprintf(stderr, "%s: only mono 16/24-bit PCM is supported\n", path);
+                fclose(file);
+                return false;
+            }
+            fseek(file, (long)(size - sizeof(format) + (size & 1)), SEEK_CUR);
+        } else if (memcmp(chunk, "data", 4) == 0 && bits != 0) {
+            const uint32_t bytes = bits / 8;
+            const float scale = (bits == 24) ? 8388607.0f : 32767.0f;  // Как в WavWriter
+            std::vector<uint8_t> data(size);
+            if (fread(data.data(), 1, size, file) != size) break;
+            samples.resize(size / bytes);
+            for (size_t i = 0; i < samples.size(); i++) {
+                const uint8_t* p = &data[i * bytes];
+                // Знак - из старшего байта
+                int32_t value = (bits == 24) ? ((int32_t)((uint32_t)get16(p) << 8 | (uint32_t)p[2] << 24) >> 8)
+                                             : (int16_t)get16(p);
+                samples[i] = (float)value / scale;
+            }
+            ok = true;
+            break;
+        } else {
+            fseek(file, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+    fclose(file);
+    
+    if (!ok) fprintf(stderr, "%s: truncated or no data chunk\n", path);
+    return ok;
+}
@@ -0,0 +1,76 @@
+#include "WavWriter.hpp"
+#include <string.h>
+
+static constexpr size_t CONVERT_FRAMES = 1024;  // Семплов на один fwrite
+
+static void put32(uint8_t* p, uint32_t value) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(value >> (8 * i));
+}
+
+static void put16(uint8_t* p, uint16_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+bool WavWriter::open(const char* path, uint8_t sampleBits, uint32_t rate) {
+    close();
+    bits = sampleBits;
+    sampleRate = rate;
+    dataBytes = 0;
+    file = fopen(path, "wb");
+    if (!file) return false;
+    writeHeader();
+    return true;
+}
+
+void WavWriter::write(const float* samples, size_t count) {
+    uint8_t buffer[CONVERT_FRAMES * 3];
+    const uint32_t bytes = bits / 8;
+    const float scale = (bits == 24) ? 8388607.0f : 32767.0f;
+    
+    while (count > 0) {
+        size_t frames = count < CONVERT_FRAMES ? count : CONVERT_FRAMES;
+        size_t length = 0;
+        for (size_t i = 0; i < frames; i++) {
+            float value = samples[i] * scale;
+            if (value > scale) value = scale;
+            if (value < -scale - 1.0f) value = -scale - 1.0f;
+            int32_t sample = (int32_t)(value < 0.0f ? value - 0.5f : value + 0.5f);
+            for (uint32_t b = 0; b < bytes; b++) {
+                buffer[length++] = (uint8_t)(sample >> (8 * b));
+            }
+        }
+        fwrite(buffer, 1, length, file);
+        dataBytes += length;
+        samples += frames;
+        count -= frames;
+    }
+}
+
+bool WavWriter::close() {
+    if (!file) return false;
+    fseek(file, 0, SEEK_SET);
+    writeHeader();
+    bool ok = ferror(file) == 0;
+    ok = (fclose(file) == 0) && ok;
+    file = nullptr;
+    return ok;
+}
+
+void WavWriter::writeHeader() {
+    uint8_t header[44];
+    const uint32_t blockAlign = bits / 8;
+    memcpy(header, "RIFF", 4);
+    put32(header + 4, 36 + dataBytes);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    put32(header + 16, 16);
+    put16(header + 20, 1);               // PCM
+    put16(header + 22, 1);               // Моно
+    put32(header + 24, sampleRate);
+    put32(header + 28, sampleRate * blockAlign);
+    put16(header + 32, (uint16_t)blockAlign);
+    put16(header + 34, bits);
+    memcpy(header + 36, "data", 4);
+    put32(header + 40, dataBytes);
+    fwrite(header, 1, sizeof(header), file);
+}
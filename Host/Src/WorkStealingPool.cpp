@@ -0,0 +1,97 @@
+#include "WorkStealingPool.hpp"
+
+WorkStealingPool::WorkStealingPool(unsigned threads)
+    : unfinished(0), stopping(false), queued(0), nextWorker(0), steals(0) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    
+    for (unsigned i = 0; i < threads; i++) {
+        workers.emplace_back(new Worker());
+    }
+    for (unsigned i = 0; i < threads; i++) {
+        this->threads.emplace_back(&WorkStealingPool::run, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> guard(stateLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task) {
+    {
+        std::lock_guard<std::mutex> guard(stateLock);
+        unfinished++;
+    }
+    
+    Worker& worker = *workers[nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size()];
+    {
+        std::lock_guard<std::mutex> guard(worker.lock);
+        worker.tasks.push_back(std::move(task));
+        queued.fetch_add(1, std::memory_order_release);  // Под замком очереди: счетчик не уходит в минус
+    }
+    
+    // Поток проверяет queued под stateLock - пробуждение не потеряется
+    {
+        std::lock_guard<std::mutex> guard(stateLock);
+    }
+    wake.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> guard(stateLock);
+    idle.wait(guard, [this] { return unfinished == 0; });
+}
+
+bool WorkStealingPool::take(unsigned index, Task& task) {
+    // Свое - с конца (последнее отправленное, горячее в кэше)
+    {
+        Worker& own = *workers[index];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    
+    // Чужое - с начала, обход с соседа, чтобы воры не толпились у одной очереди
+    for (size_t i = 1; i < workers.size(); i++) {
+        Worker& victim = *workers[(index + i) % workers.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::run(unsigned index) {
+    Task task;
+    while (true) {
+        if (take(index, task)) {
+            task();
+            task = nullptr;
+            
+            std::lock_guard<std::mutex> guard(stateLock);
+            if (--unfinished == 0) idle.notify_all();
+            continue;
+        }
+        
+        std::unique_lock<std::mutex> guard(stateLock);
+        wake.wait(guard, [this] { return stopping || queued.load(std::memory_order_acquire) > 0; });
+        if (stopping && queued.load(std::memory_order_acquire) == 0) return;
+    }
+}